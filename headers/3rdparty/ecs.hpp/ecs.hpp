@@ -11,6 +11,7 @@
 #include <cstdint>
 
 #include <tuple>
+#include <chrono>
 #include <memory>
 #include <vector>
 #include <limits>
@@ -19,6 +20,7 @@
 #include <stdexcept>
 #include <algorithm>
 #include <functional>
+#include <typeinfo>
 #include <type_traits>
 
 // -----------------------------------------------------------------------------
@@ -38,6 +40,7 @@ namespace ecs_hpp
     class const_component;
 
     class prototype;
+    class component_reservation;
 
     class system;
     class registry;
@@ -48,6 +51,7 @@ namespace ecs_hpp
     using family_id = std::uint16_t;
     using entity_id = std::uint32_t;
     using priority_t = std::int32_t;
+    using tick_t = std::uint64_t;
 
     constexpr std::size_t entity_id_index_bits = 22u;
     constexpr std::size_t entity_id_version_bits = 10u;
@@ -392,6 +396,19 @@ namespace ecs_hpp
                 dense_.clear();
             }
 
+            void reserve(std::size_t capacity) {
+                dense_.reserve(capacity);
+            }
+
+            void swap_dense(std::size_t l, std::size_t r) noexcept {
+                if ( l != r ) {
+                    using std::swap;
+                    swap(dense_[l], dense_[r]);
+                    sparse_[indexer_(dense_[l])] = l;
+                    sparse_[indexer_(dense_[r])] = r;
+                }
+            }
+
             bool has(const T& v) const noexcept {
                 const std::size_t vi = indexer_(v);
                 return vi < sparse_.size()
@@ -567,6 +584,31 @@ namespace ecs_hpp
                 values_.clear();
             }
 
+            void reserve(std::size_t capacity) {
+                keys_.reserve(capacity);
+                values_.reserve(capacity);
+            }
+
+            void swap_dense(std::size_t l, std::size_t r) noexcept {
+                if ( l != r ) {
+                    using std::swap;
+                    keys_.swap_dense(l, r);
+                    swap(values_[l], values_[r]);
+                }
+            }
+
+            T& value_at(std::size_t index) noexcept {
+                return values_[index];
+            }
+
+            const T& value_at(std::size_t index) const noexcept {
+                return values_[index];
+            }
+
+            std::pair<std::size_t,bool> find_dense_index(const K& k) const noexcept {
+                return keys_.find_dense_index(k);
+            }
+
             bool has(const K& k) const noexcept {
                 return keys_.has(k);
             }
@@ -650,15 +692,164 @@ namespace ecs_hpp
 {
     namespace detail
     {
+        class owning_group;
+
         class component_storage_base {
         public:
             virtual ~component_storage_base() = default;
             virtual bool remove(entity_id id) noexcept = 0;
             virtual bool has(entity_id id) const noexcept = 0;
             virtual void clone(entity_id from, entity_id to) = 0;
+            virtual void reserve(std::size_t capacity) = 0;
             virtual std::size_t memory_usage() const noexcept = 0;
+
+            virtual std::size_t count() const noexcept = 0;
+            virtual entity_id entity_at(std::size_t index) const noexcept = 0;
+            virtual std::size_t index_of(entity_id id) const noexcept = 0;
+            virtual void swap_at(std::size_t l, std::size_t r) noexcept = 0;
+
+            owning_group* group() const noexcept {
+                return group_;
+            }
+
+            void group(owning_group* group) noexcept {
+                group_ = group;
+            }
+
+            bool change_tracking() const noexcept {
+                return change_tracking_;
+            }
+
+            void enable_change_tracking() noexcept {
+                change_tracking_ = true;
+            }
+
+            bool mark_changed(entity_id id, tick_t tick) {
+                if ( !change_tracking_ || !has(id) ) {
+                    return false;
+                }
+                const tick_t* last = last_changes_.find(id);
+                if ( last && *last == tick ) {
+                    return true;
+                }
+                changes_.emplace_back(id, tick);
+                try {
+                    last_changes_.insert_or_assign(id, tick);
+                } catch (...) {
+                    changes_.pop_back();
+                    throw;
+                }
+                return true;
+            }
+
+            template < typename F >
+            void for_each_change(tick_t since, F&& f) const {
+                const auto first = std::lower_bound(
+                    changes_.begin(), changes_.end(), since,
+                    [](const auto& c, tick_t t) noexcept {
+                        return c.second < t;
+                    });
+                for ( auto iter = first; iter != changes_.end(); ++iter ) {
+                    // only the last change of the entity is reported
+                    const tick_t* last = last_changes_.find(iter->first);
+                    if ( last && *last == iter->second ) {
+                        f(iter->first);
+                    }
+                }
+            }
+
+            void discard_changes_before(tick_t tick) noexcept {
+                const auto last = std::lower_bound(
+                    changes_.begin(), changes_.end(), tick,
+                    [](const auto& c, tick_t t) noexcept {
+                        return c.second < t;
+                    });
+                for ( auto iter = changes_.begin(); iter != last; ++iter ) {
+                    const tick_t* last_tick = last_changes_.find(iter->first);
+                    if ( last_tick && *last_tick == iter->second ) {
+                        last_changes_.unordered_erase(iter->first);
+                    }
+                }
+                changes_.erase(changes_.begin(), last);
+            }
+        protected:
+            void on_remove_(entity_id id) noexcept;
+        private:
+            owning_group* group_{nullptr};
+            bool change_tracking_{false};
+            std::vector<std::pair<entity_id, tick_t>> changes_;
+            sparse_map<entity_id, tick_t, entity_id_indexer> last_changes_;
+        };
+
+        //
+        // owning_group
+        //
+        // keeps entities with all owned components in the same
+        // order at the beginning of every owned storage
+        //
+
+        class owning_group final {
+        public:
+            owning_group(
+                std::vector<family_id> families,
+                std::vector<component_storage_base*> storages) noexcept
+            : families_(std::move(families))
+            , storages_(std::move(storages)) {}
+
+            std::size_t size() const noexcept {
+                return size_;
+            }
+
+            const std::vector<family_id>& families() const noexcept {
+                return families_;
+            }
+
+            bool covered_by(std::initializer_list<family_id> families) const noexcept {
+                return std::all_of(families_.begin(), families_.end(), [&families](family_id f){
+                    return std::find(families.begin(), families.end(), f) != families.end();
+                });
+            }
+
+            void on_assign(entity_id id) noexcept {
+                for ( const component_storage_base* storage : storages_ ) {
+                    if ( !storage->has(id) ) {
+                        return;
+                    }
+                }
+                if ( storages_.front()->index_of(id) < size_ ) {
+                    return;
+                }
+                for ( component_storage_base* storage : storages_ ) {
+                    storage->swap_at(storage->index_of(id), size_);
+                }
+                ++size_;
+            }
+
+            void on_remove(entity_id id) noexcept {
+                const component_storage_base* first = storages_.front();
+                if ( !first->has(id) || first->index_of(id) >= size_ ) {
+                    return;
+                }
+                --size_;
+                for ( component_storage_base* storage : storages_ ) {
+                    storage->swap_at(storage->index_of(id), size_);
+                }
+            }
+        private:
+            std::size_t size_{0u};
+            std::vector<family_id> families_;
+            std::vector<component_storage_base*> storages_;
         };
 
+        inline void component_storage_base::on_remove_(entity_id id) noexcept {
+            if ( group_ ) {
+                group_->on_remove(id);
+            }
+            if ( change_tracking_ ) {
+                last_changes_.unordered_erase(id);
+            }
+        }
+
         template < typename T, bool E = std::is_empty<T>::value >
         class component_storage final : public component_storage_base {
         public:
@@ -668,6 +859,9 @@ namespace ecs_hpp
             template < typename... Args >
             T& assign(entity_id id, Args&&... args) {
                 components_.insert_or_assign(id, T(std::forward<Args>(args)...));
+                if ( owning_group* g = group() ) {
+                    g->on_assign(id);
+                }
                 return components_.get(id);
             }
 
@@ -676,6 +870,7 @@ namespace ecs_hpp
             }
 
             bool remove(entity_id id) noexcept override {
+                on_remove_(id);
                 return components_.unordered_erase(id);
             }
 
@@ -687,10 +882,22 @@ namespace ecs_hpp
                 return components_.find(id);
             }
 
-            std::size_t count() const noexcept {
+            std::size_t count() const noexcept override {
                 return components_.size();
             }
 
+            entity_id entity_at(std::size_t index) const noexcept override {
+                return components_.begin()[index];
+            }
+
+            std::size_t index_of(entity_id id) const noexcept override {
+                return components_.find_dense_index(id).first;
+            }
+
+            void swap_at(std::size_t l, std::size_t r) noexcept override {
+                components_.swap_dense(l, r);
+            }
+
             bool has(entity_id id) const noexcept override {
                 return components_.has(id);
             }
@@ -699,9 +906,20 @@ namespace ecs_hpp
                 const T* c = components_.find(from);
                 if ( c ) {
                     components_.insert_or_assign(to, *c);
+                    if ( owning_group* g = group() ) {
+                        g->on_assign(to);
+                    }
                 }
             }
 
+            T& component_at(std::size_t index) noexcept {
+                return components_.value_at(index);
+            }
+
+            const T& component_at(std::size_t index) const noexcept {
+                return components_.value_at(index);
+            }
+
             template < typename F >
             void for_each_component(F&& f) {
                 for ( const entity_id id : components_ ) {
@@ -716,6 +934,10 @@ namespace ecs_hpp
                 }
             }
 
+            void reserve(std::size_t capacity) override {
+                components_.reserve(capacity);
+            }
+
             std::size_t memory_usage() const noexcept override {
                 return components_.memory_usage();
             }
@@ -733,6 +955,9 @@ namespace ecs_hpp
             template < typename... Args >
             T& assign(entity_id id, Args&&...) {
                 components_.insert(id);
+                if ( owning_group* g = group() ) {
+                    g->on_assign(id);
+                }
                 return empty_value_;
             }
 
@@ -741,6 +966,7 @@ namespace ecs_hpp
             }
 
             bool remove(entity_id id) noexcept override {
+                on_remove_(id);
                 return components_.unordered_erase(id);
             }
 
@@ -756,10 +982,22 @@ namespace ecs_hpp
                     : nullptr;
             }
 
-            std::size_t count() const noexcept {
+            std::size_t count() const noexcept override {
                 return components_.size();
             }
 
+            entity_id entity_at(std::size_t index) const noexcept override {
+                return components_.begin()[index];
+            }
+
+            std::size_t index_of(entity_id id) const noexcept override {
+                return components_.find_dense_index(id).first;
+            }
+
+            void swap_at(std::size_t l, std::size_t r) noexcept override {
+                components_.swap_dense(l, r);
+            }
+
             bool has(entity_id id) const noexcept override {
                 return components_.has(id);
             }
@@ -767,9 +1005,20 @@ namespace ecs_hpp
             void clone(entity_id from, entity_id to) override {
                 if ( components_.has(from) ) {
                     components_.insert(to);
+                    if ( owning_group* g = group() ) {
+                        g->on_assign(to);
+                    }
                 }
             }
 
+            T& component_at(std::size_t) noexcept {
+                return empty_value_;
+            }
+
+            const T& component_at(std::size_t) const noexcept {
+                return empty_value_;
+            }
+
             template < typename F >
             void for_each_component(F&& f) {
                 for ( const entity_id id : components_ ) {
@@ -784,6 +1033,10 @@ namespace ecs_hpp
                 }
             }
 
+            void reserve(std::size_t capacity) override {
+                components_.reserve(capacity);
+            }
+
             std::size_t memory_usage() const noexcept override {
                 return components_.memory_usage();
             }
@@ -1099,6 +1352,7 @@ namespace ecs_hpp
             virtual ~applier_base() = default;
             virtual applier_uptr clone() const = 0;
             virtual void apply_to_entity(entity& ent, bool override) const = 0;
+            virtual void reserve_components(registry& owner, std::size_t count) const = 0;
         };
 
         template < typename T >
@@ -1114,6 +1368,7 @@ namespace ecs_hpp
             typed_applier_with_args(const std::tuple<Args...>& args);
             applier_uptr clone() const override;
             void apply_to_entity(entity& ent, bool override) const override;
+            void reserve_components(registry& owner, std::size_t count) const override;
             void apply_to_component(T& component) const override;
         private:
             std::tuple<Args...> args_;
@@ -1149,13 +1404,29 @@ namespace ecs_hpp
         template < typename T >
         bool apply_to_component(T& component) const;
         void apply_to_entity(entity& ent, bool override) const;
+
+        // reserves storages for 'count' more entities created from this prototype
+        void reserve_components(registry& owner, std::size_t count) const;
     private:
+        friend class component_reservation;
         detail::sparse_map<
             family_id,
             detail::applier_uptr> appliers_;
     };
 
     void swap(prototype& l, prototype& r) noexcept;
+
+    // sums component counts of many prototypes,
+    // so every storage is reserved only once
+    class component_reservation final {
+    public:
+        void add(const prototype& proto, std::size_t count);
+        void reserve(registry& owner) const;
+    private:
+        detail::sparse_map<
+            family_id,
+            std::pair<const detail::applier_base*, std::size_t>> counts_;
+    };
 }
 
 // -----------------------------------------------------------------------------
@@ -1173,6 +1444,172 @@ namespace ecs_hpp
     };
 }
 
+// -----------------------------------------------------------------------------
+//
+// system_access
+//
+// -----------------------------------------------------------------------------
+
+namespace ecs_hpp
+{
+    class system_access final {
+    public:
+        system_access() = default;
+
+        template < typename... Ts >
+        system_access& reads();
+
+        template < typename... Ts >
+        system_access& writes();
+
+        bool exclusive() const noexcept;
+        bool conflicts_with(const system_access& other) const noexcept;
+    private:
+        bool exclusive_{true};
+        std::vector<family_id> reads_;
+        std::vector<family_id> writes_;
+    };
+}
+
+namespace ecs_hpp
+{
+    namespace detail
+    {
+        template < typename... Args >
+        struct is_system_access_first
+        : std::false_type {};
+
+        template < typename A, typename... Args >
+        struct is_system_access_first<A, Args...>
+        : std::is_same<std::decay_t<A>, system_access> {};
+
+        inline void insert_sorted_family(
+            std::vector<family_id>& families,
+            family_id family)
+        {
+            const auto iter = std::lower_bound(
+                families.begin(), families.end(), family);
+            if ( iter == families.end() || *iter != family ) {
+                families.insert(iter, family);
+            }
+        }
+
+        inline bool sorted_families_intersect(
+            const std::vector<family_id>& l,
+            const std::vector<family_id>& r) noexcept
+        {
+            auto l_iter = l.begin();
+            auto r_iter = r.begin();
+            while ( l_iter != l.end() && r_iter != r.end() ) {
+                if ( *l_iter < *r_iter ) {
+                    ++l_iter;
+                } else if ( *r_iter < *l_iter ) {
+                    ++r_iter;
+                } else {
+                    return true;
+                }
+            }
+            return false;
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+//
+// system_profile
+//
+// -----------------------------------------------------------------------------
+
+namespace ecs_hpp
+{
+    struct system_profile final {
+        const char* name{""};
+        priority_t priority{0};
+        std::size_t invocations{0u};
+        std::size_t entities{0u};
+        double last_ms{0.0};
+        double min_ms{0.0};
+        double avg_ms{0.0};
+        double max_ms{0.0};
+    };
+
+    namespace detail
+    {
+        //
+        // visited_entities_counter
+        //
+        // counts entities iterated by the system
+        // currently processed in this thread
+        //
+
+        inline std::size_t*& visited_entities_counter() noexcept {
+            static thread_local std::size_t* counter = nullptr;
+            return counter;
+        }
+
+        inline void count_visited_entities(std::size_t count) noexcept {
+            if ( std::size_t* counter = visited_entities_counter() ) {
+                *counter += count;
+            }
+        }
+
+        //
+        // system_timings
+        //
+        // rolling window of the last invocations
+        //
+
+        class system_timings final {
+        public:
+            static constexpr std::size_t window_size = 120u;
+
+            void add_sample(double ms, std::size_t entities) {
+                if ( samples_.size() < window_size ) {
+                    samples_.push_back(ms);
+                } else {
+                    samples_[next_sample_] = ms;
+                }
+                next_sample_ = (next_sample_ + 1u) % window_size;
+                last_ms_ = ms;
+                entities_ = entities;
+                ++invocations_;
+            }
+
+            void reset() noexcept {
+                samples_.clear();
+                next_sample_ = 0u;
+                last_ms_ = 0.0;
+                entities_ = 0u;
+                invocations_ = 0u;
+            }
+
+            system_profile make_profile(const char* name, priority_t priority) const noexcept {
+                system_profile profile;
+                profile.name = name;
+                profile.priority = priority;
+                profile.invocations = invocations_;
+                profile.entities = entities_;
+                profile.last_ms = last_ms_;
+                if ( !samples_.empty() ) {
+                    profile.min_ms = *std::min_element(samples_.begin(), samples_.end());
+                    profile.max_ms = *std::max_element(samples_.begin(), samples_.end());
+                    for ( const double ms : samples_ ) {
+                        profile.avg_ms += ms;
+                    }
+                    profile.avg_ms /= static_cast<double>(samples_.size());
+                }
+                return profile;
+            }
+        private:
+            std::vector<double> samples_;
+            std::size_t next_sample_{0u};
+            double last_ms_{0.0};
+            std::size_t entities_{0u};
+            std::size_t invocations_{0u};
+        };
+    }
+}
+
 // -----------------------------------------------------------------------------
 //
 // registry
@@ -1283,6 +1720,10 @@ namespace ecs_hpp
         template < typename T >
         std::size_t component_count() const noexcept;
         std::size_t entity_count() const noexcept;
+
+        template < typename T >
+        void reserve_components(std::size_t capacity);
+        void reserve_entities(std::size_t capacity);
         std::size_t entity_component_count(const const_uentity& ent) const noexcept;
 
         template < typename F >
@@ -1300,14 +1741,55 @@ namespace ecs_hpp
         template < typename... Ts, typename F >
         void for_joined_components(F&& f) const;
 
+        // packs entities with all of Ts at the beginning of their storages,
+        // joins over a superset of Ts then scan them linearly,
+        // a storage can be owned by one group only
+        template < typename... Ts >
+        void register_owning_group();
+
+        template < typename... Ts >
+        std::size_t owning_group_size() const noexcept;
+
+        // changes are recorded on assignment and on explicit marking,
+        // each change is tagged with the current change tick
+        template < typename T >
+        void enable_change_tracking();
+        template < typename T >
+        bool mark_component_changed(const uentity& ent);
+
+        tick_t change_tick() const noexcept;
+        tick_t advance_change_tick() noexcept;
+        void discard_changes_before(tick_t tick) noexcept;
+
+        // iterates components changed at 'since' tick or later
+        template < typename T, typename F >
+        void for_each_changed_component(tick_t since, F&& f);
+        template < typename T, typename F >
+        void for_each_changed_component(tick_t since, F&& f) const;
+
+        template < typename T, typename... Args >
+        std::enable_if_t<!detail::is_system_access_first<Args...>::value>
+        add_system(priority_t priority, Args&&... args);
+
         template < typename T, typename... Args >
-        void add_system(priority_t priority, Args&&... args);
+        void add_system(priority_t priority, system_access access, Args&&... args);
 
         void process_all_systems();
         void process_systems_above(priority_t min);
         void process_systems_below(priority_t max);
         void process_systems_in_range(priority_t min, priority_t max);
 
+        // executor(count, task) must call task(0..count-1),
+        // possibly concurrently, and return when all of them are done
+        template < typename Executor >
+        void process_systems_in_range(priority_t min, priority_t max, Executor&& executor);
+
+        // records time and iterated entities of each system invocation
+        void enable_system_profiling(bool enable) noexcept;
+        bool system_profiling() const noexcept;
+        std::vector<system_profile> system_profiles() const;
+        void reset_system_profiles() noexcept;
+
         struct memory_usage_info {
             std::size_t entities{0u};
             std::size_t components{0u};
@@ -1317,6 +1799,20 @@ namespace ecs_hpp
         template < typename T >
         std::size_t component_memory_usage() const noexcept;
     private:
+        template < typename T >
+        static T* find_grouped_component_(
+            detail::component_storage<T>& storage,
+            const detail::owning_group* group,
+            std::size_t index,
+            entity_id id) noexcept;
+
+        template < typename T >
+        static const T* find_grouped_component_(
+            const detail::component_storage<T>& storage,
+            const detail::owning_group* group,
+            std::size_t index,
+            entity_id id) noexcept;
+
         template < typename T >
         detail::component_storage<T>* find_storage_() noexcept;
 
@@ -1387,8 +1883,22 @@ namespace ecs_hpp
         using storage_uptr = std::unique_ptr<detail::component_storage_base>;
         detail::sparse_map<family_id, storage_uptr> storages_;
 
+        using owning_group_uptr = std::unique_ptr<detail::owning_group>;
+        std::vector<owning_group_uptr> owning_groups_;
+
+        tick_t change_tick_{1u};
+
         using system_uptr = std::unique_ptr<system>;
-        std::vector<std::pair<priority_t, system_uptr>> systems_;
+        struct system_info final {
+            priority_t priority{0};
+            system_access access;
+            system_uptr instance;
+            const char* name{""};
+            detail::system_timings timings;
+        };
+        void process_system_(system_info& info);
+        std::vector<system_info> systems_;
+        bool system_profiling_{false};
     };
 }
 
@@ -1420,9 +1930,21 @@ namespace ecs_hpp
         : registry_(registry) {}
 
         template < typename T, typename... Args >
-        registry_filler& system(priority_t priority, Args&&... args) {
+        std::enable_if_t<
+            !detail::is_system_access_first<Args...>::value,
+            registry_filler&>
+        system(priority_t priority, Args&&... args) {
+            registry_.add_system<T>(
+                priority,
+                std::forward<Args>(args)...);
+            return *this;
+        }
+
+        template < typename T, typename... Args >
+        registry_filler& system(priority_t priority, system_access access, Args&&... args) {
             registry_.add_system<T>(
                 priority,
+                std::move(access),
                 std::forward<Args>(args)...);
             return *this;
         }
@@ -1431,6 +1953,93 @@ namespace ecs_hpp
     };
 }
 
+// -----------------------------------------------------------------------------
+//
+// command_buffer
+//
+// -----------------------------------------------------------------------------
+
+namespace ecs_hpp
+{
+    // destroys entities instead of 'registry::destroy_entity' on playback,
+    // for entities owned by something outside of the registry
+    using entity_destroyer = std::function<void(registry&, entity_id)>;
+
+    namespace detail
+    {
+        class command_base;
+        using command_uptr = std::unique_ptr<command_base>;
+
+        class command_base {
+        public:
+            virtual ~command_base() = default;
+            virtual void execute(registry& owner, const entity_destroyer& destroyer) = 0;
+        };
+
+        template < typename F >
+        class invoke_command final : public command_base {
+        public:
+            invoke_command(F&& f)
+            : f_(std::move(f)) {}
+
+            void execute(registry& owner, const entity_destroyer&) override {
+                f_(owner);
+            }
+        private:
+            F f_;
+        };
+
+        class destroy_entity_command final : public command_base {
+        public:
+            destroy_entity_command(entity_id ent)
+            : ent_(ent) {}
+
+            void execute(registry& owner, const entity_destroyer& destroyer) override;
+        private:
+            entity_id ent_;
+        };
+    }
+
+    class command_buffer final {
+    public:
+        command_buffer() = default;
+        ~command_buffer() noexcept = default;
+
+        command_buffer(command_buffer&& other) noexcept = default;
+        command_buffer& operator=(command_buffer&& other) noexcept = default;
+
+        command_buffer(const command_buffer& other) = delete;
+        command_buffer& operator=(const command_buffer& other) = delete;
+
+        // entities are created with all of their components at once,
+        // recorded commands can't refer to them before the playback
+        command_buffer& create_entity(const prototype& proto);
+        command_buffer& destroy_entity(entity_id ent);
+
+        template < typename T, typename... Args >
+        command_buffer& assign_component(entity_id ent, Args&&... args);
+
+        template < typename T >
+        command_buffer& remove_component(entity_id ent);
+        command_buffer& remove_all_components(entity_id ent);
+
+        // records an arbitrary f(registry&) call
+        template < typename F >
+        command_buffer& invoke(F&& f);
+
+        void clear() noexcept;
+        bool empty() const noexcept;
+        std::size_t size() const noexcept;
+
+        // executes recorded commands in order and clears the buffer,
+        // commands for entities that are no longer valid are skipped
+        void playback(registry& owner);
+        void playback(registry& owner, const entity_destroyer& destroyer);
+    private:
+        std::vector<detail::command_uptr> commands_;
+    };
+}
+
 // -----------------------------------------------------------------------------
 //
 // entity impl
@@ -1862,6 +2471,11 @@ namespace ecs_hpp
             }, args_);
         }
 
+        template < typename T, typename... Args >
+        void typed_applier_with_args<T, Args...>::reserve_components(registry& owner, std::size_t count) const {
+            owner.reserve_components<T>(owner.component_count<T>() + count);
+        }
+
         template < typename T, typename... Args >
         void typed_applier_with_args<T, Args...>::apply_to_component(T& component) const {
             detail::tiny_tuple_apply([&component](const Args&... args){
@@ -1967,9 +2581,68 @@ namespace ecs_hpp
         }
     }
 
+    inline void prototype::reserve_components(registry& owner, std::size_t count) const {
+        for ( const auto family : appliers_ ) {
+            appliers_.get(family)->reserve_components(owner, count);
+        }
+    }
+
     inline void swap(prototype& l, prototype& r) noexcept {
         l.swap(r);
     }
+
+    inline void component_reservation::add(const prototype& proto, std::size_t count) {
+        for ( const auto family : proto.appliers_ ) {
+            auto* family_count = counts_.find(family);
+            if ( family_count ) {
+                family_count->second += count;
+            } else {
+                counts_.insert(family, std::make_pair(proto.appliers_.get(family).get(), count));
+            }
+        }
+    }
+
+    inline void component_reservation::reserve(registry& owner) const {
+        for ( const auto family : counts_ ) {
+            const auto& family_count = counts_.get(family);
+            family_count.first->reserve_components(owner, family_count.second);
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+//
+// system_access impl
+//
+// -----------------------------------------------------------------------------
+
+namespace ecs_hpp
+{
+    template < typename... Ts >
+    system_access& system_access::reads() {
+        exclusive_ = false;
+        (detail::insert_sorted_family(reads_, detail::type_family<Ts>::id()), ...);
+        return *this;
+    }
+
+    template < typename... Ts >
+    system_access& system_access::writes() {
+        exclusive_ = false;
+        (detail::insert_sorted_family(writes_, detail::type_family<Ts>::id()), ...);
+        return *this;
+    }
+
+    inline bool system_access::exclusive() const noexcept {
+        return exclusive_;
+    }
+
+    inline bool system_access::conflicts_with(const system_access& other) const noexcept {
+        return exclusive_
+            || other.exclusive_
+            || detail::sorted_families_intersect(writes_, other.writes_)
+            || detail::sorted_families_intersect(writes_, other.reads_)
+            || detail::sorted_families_intersect(reads_, other.writes_);
+    }
 }
 
 // -----------------------------------------------------------------------------
@@ -2131,6 +2804,7 @@ namespace ecs_hpp
         try {
             for ( const auto family : storages_ ) {
                 storages_.get(family)->clone(proto, ent.id());
+                storages_.get(family)->mark_changed(ent.id(), change_tick_);
             }
         } catch (...) {
             destroy_entity(ent);
@@ -2156,9 +2830,12 @@ namespace ecs_hpp
     template < typename T, typename... Args >
     T& registry::assign_component(const uentity& ent, Args&&... args) {
         assert(valid_entity(ent));
-        return get_or_create_storage_<T>().assign(
+        detail::component_storage<T>& storage = get_or_create_storage_<T>();
+        T& component = storage.assign(
             ent,
             std::forward<Args>(args)...);
+        storage.mark_changed(ent, change_tick_);
+        return component;
     }
 
     template < typename T >
@@ -2260,6 +2937,16 @@ namespace ecs_hpp
             : 0u;
     }
 
+    template < typename T >
+    void registry::reserve_components(std::size_t capacity) {
+        get_or_create_storage_<T>().reserve(capacity);
+    }
+
+    inline void registry::reserve_entities(std::size_t capacity) {
+        entity_ids_.reserve(capacity);
+        free_entity_ids_.reserve(capacity);
+    }
+
     inline std::size_t registry::entity_count() const noexcept {
         return entity_ids_.size();
     }
@@ -2293,6 +2980,7 @@ namespace ecs_hpp
     void registry::for_each_component(F&& f) {
         detail::component_storage<T>* storage = find_storage_<T>();
         if ( storage ) {
+            detail::count_visited_entities(storage->count());
             storage->for_each_component([this, &f](const entity_id e, T& t){
                 f(uentity{*this, e}, t);
             });
@@ -2303,6 +2991,7 @@ namespace ecs_hpp
     void registry::for_each_component(F&& f) const {
         const detail::component_storage<T>* storage = find_storage_<T>();
         if ( storage ) {
+            detail::count_visited_entities(storage->count());
             storage->for_each_component([this, &f](const entity_id e, const T& t){
                 f(const_uentity{*this, e}, t);
             });
@@ -2323,17 +3012,126 @@ namespace ecs_hpp
             std::make_index_sequence<sizeof...(Ts)>());
     }
 
+    template < typename... Ts >
+    void registry::register_owning_group() {
+        static_assert(
+            sizeof...(Ts) > 1u,
+            "ecs_hpp::registry (owning group must own at least two components)");
+
+        std::vector<detail::component_storage_base*> storages{
+            &get_or_create_storage_<Ts>()...};
+        for ( const detail::component_storage_base* storage : storages ) {
+            if ( storage->group() ) {
+                throw std::logic_error("ecs_hpp::registry (component storage already owned by a group)");
+            }
+        }
+
+        std::vector<family_id> families{detail::type_family<Ts>::id()...};
+        std::sort(families.begin(), families.end());
+
+        owning_groups_.reserve(owning_groups_.size() + 1u);
+        owning_groups_.push_back(std::make_unique<detail::owning_group>(
+            std::move(families),
+            storages));
+
+        detail::owning_group* group = owning_groups_.back().get();
+        for ( detail::component_storage_base* storage : storages ) {
+            storage->group(group);
+        }
+
+        const detail::component_storage_base* first = storages.front();
+        for ( std::size_t i = 0, e = first->count(); i < e; ++i ) {
+            group->on_assign(first->entity_at(i));
+        }
+    }
+
+    template < typename T >
+    void registry::enable_change_tracking() {
+        get_or_create_storage_<T>().enable_change_tracking();
+    }
+
+    template < typename T >
+    bool registry::mark_component_changed(const uentity& ent) {
+        assert(valid_entity(ent));
+        detail::component_storage<T>* storage = find_storage_<T>();
+        return storage
+            ? storage->mark_changed(ent, change_tick_)
+            : false;
+    }
+
+    inline tick_t registry::change_tick() const noexcept {
+        return change_tick_;
+    }
+
+    inline tick_t registry::advance_change_tick() noexcept {
+        return ++change_tick_;
+    }
+
+    inline void registry::discard_changes_before(tick_t tick) noexcept {
+        for ( const auto family : storages_ ) {
+            storages_.get(family)->discard_changes_before(tick);
+        }
+    }
+
+    template < typename T, typename F >
+    void registry::for_each_changed_component(tick_t since, F&& f) {
+        detail::component_storage<T>* storage = find_storage_<T>();
+        if ( storage ) {
+            storage->for_each_change(since, [this, storage, &f](entity_id id){
+                f(uentity{*this, id}, *storage->find(id));
+            });
+        }
+    }
+
+    template < typename T, typename F >
+    void registry::for_each_changed_component(tick_t since, F&& f) const {
+        const detail::component_storage<T>* storage = find_storage_<T>();
+        if ( storage ) {
+            storage->for_each_change(since, [this, storage, &f](entity_id id){
+                f(const_uentity{*this, id}, *storage->find(id));
+            });
+        }
+    }
+
+    template < typename... Ts >
+    std::size_t registry::owning_group_size() const noexcept {
+        const detail::component_storage_base* first =
+            find_storage_<std::tuple_element_t<0, std::tuple<Ts...>>>();
+        const detail::owning_group* group = first
+            ? first->group()
+            : nullptr;
+        if ( !group || group->families().size() != sizeof...(Ts) ) {
+            return 0u;
+        }
+        return group->covered_by({detail::type_family<Ts>::id()...})
+            ? group->size()
+            : 0u;
+    }
+
     template < typename T, typename... Args >
-    void registry::add_system(priority_t priority, Args&&... args) {
+    std::enable_if_t<!detail::is_system_access_first<Args...>::value>
+    registry::add_system(priority_t priority, Args&&... args) {
+        add_system<T>(
+            priority,
+            system_access(),
+            std::forward<Args>(args)...);
+    }
+
+    template < typename T, typename... Args >
+    void registry::add_system(priority_t priority, system_access access, Args&&... args) {
         auto iter = std::upper_bound(
             systems_.begin(), systems_.end(), priority,
             [](priority_t pr, const auto& r){
-                return pr < r.first;
+                return pr < r.priority;
             });
-        systems_.emplace(
+        systems_.insert(
             iter,
-            priority,
-            std::make_unique<T>(std::forward<Args>(args)...));
+            system_info{
+                priority,
+                std::move(access),
+                std::make_unique<T>(std::forward<Args>(args)...),
+                typeid(T).name(),
+                detail::system_timings()});
     }
 
     inline void registry::process_all_systems() {
@@ -2358,13 +3156,111 @@ namespace ecs_hpp
         const auto first = std::lower_bound(
             systems_.begin(), systems_.end(), min,
             [](const auto& p, priority_t pr) noexcept {
-                return p.first < pr;
+                return p.priority < pr;
             });
-        for ( auto iter = first; iter != systems_.end() && iter->first <= max; ++iter ) {
-            iter->second->process(*this);
+        for ( auto iter = first; iter != systems_.end() && iter->priority <= max; ++iter ) {
+            process_system_(*iter);
         }
     }
 
+    template < typename Executor >
+    void registry::process_systems_in_range(priority_t min, priority_t max, Executor&& executor) {
+        const auto first = std::lower_bound(
+            systems_.begin(), systems_.end(), min,
+            [](const auto& p, priority_t pr) noexcept {
+                return p.priority < pr;
+            });
+        const auto last = std::upper_bound(
+            first, systems_.end(), max,
+            [](priority_t pr, const auto& p) noexcept {
+                return pr < p.priority;
+            });
+
+        // a system runs after every system with a lower
+        // priority it conflicts with, exclusive systems
+        // conflict with all of them
+
+        const std::size_t count = static_cast<std::size_t>(
+            std::distance(first, last));
+        std::vector<std::size_t> stages(count, 0u);
+        std::size_t stage_count = 0u;
+        for ( std::size_t i = 0; i < count; ++i ) {
+            for ( std::size_t j = 0; j < i; ++j ) {
+                if ( stages[j] >= stages[i] && first[j].access.conflicts_with(first[i].access) ) {
+                    stages[i] = stages[j] + 1u;
+                }
+            }
+            stage_count = std::max(stage_count, stages[i] + 1u);
+        }
+
+        std::vector<system_info*> stage_systems;
+        stage_systems.reserve(count);
+        for ( std::size_t stage = 0; stage < stage_count; ++stage ) {
+            stage_systems.clear();
+            for ( std::size_t i = 0; i < count; ++i ) {
+                if ( stages[i] == stage ) {
+                    stage_systems.push_back(&first[i]);
+                }
+            }
+            if ( stage_systems.size() == 1u ) {
+                process_system_(*stage_systems.front());
+            } else {
+                executor(stage_systems.size(), [this, &stage_systems](std::size_t index){
+                    process_system_(*stage_systems[index]);
+                });
+            }
+        }
+    }
+
+    inline void registry::enable_system_profiling(bool enable) noexcept {
+        system_profiling_ = enable;
+    }
+
+    inline bool registry::system_profiling() const noexcept {
+        return system_profiling_;
+    }
+
+    inline std::vector<system_profile> registry::system_profiles() const {
+        std::vector<system_profile> profiles;
+        profiles.reserve(systems_.size());
+        for ( const system_info& info : systems_ ) {
+            profiles.push_back(info.timings.make_profile(info.name, info.priority));
+        }
+        return profiles;
+    }
+
+    inline void registry::reset_system_profiles() noexcept {
+        for ( system_info& info : systems_ ) {
+            info.timings.reset();
+        }
+    }
+
+    inline void registry::process_system_(system_info& info) {
+        if ( !system_profiling_ ) {
+            info.instance->process(*this);
+            return;
+        }
+
+        std::size_t visited_entities = 0u;
+        std::size_t*& counter = detail::visited_entities_counter();
+        std::size_t* const prev_counter = counter;
+        counter = &visited_entities;
+
+        const auto begin_time = std::chrono::steady_clock::now();
+        try {
+            info.instance->process(*this);
+        } catch (...) {
+            counter = prev_counter;
+            throw;
+        }
+        const auto end_time = std::chrono::steady_clock::now();
+        counter = prev_counter;
+
+        info.timings.add_sample(
+            std::chrono::duration<double, std::milli>(end_time - begin_time).count(),
+            visited_entities);
+    }
+
     inline registry::memory_usage_info registry::memory_usage() const noexcept {
         memory_usage_info info;
         info.entities += free_entity_ids_.capacity() * sizeof(free_entity_ids_[0]);
@@ -2383,6 +3279,30 @@ namespace ecs_hpp
             : 0u;
     }
 
+    template < typename T >
+    T* registry::find_grouped_component_(
+        detail::component_storage<T>& storage,
+        const detail::owning_group* group,
+        std::size_t index,
+        entity_id id) noexcept
+    {
+        return storage.group() == group
+            ? &storage.component_at(index)
+            : storage.find(id);
+    }
+
+    template < typename T >
+    const T* registry::find_grouped_component_(
+        const detail::component_storage<T>& storage,
+        const detail::owning_group* group,
+        std::size_t index,
+        entity_id id) noexcept
+    {
+        return storage.group() == group
+            ? &storage.component_at(index)
+            : storage.find(id);
+    }
+
     template < typename T >
     detail::component_storage<T>* registry::find_storage_() noexcept {
         const auto family = detail::type_family<T>::id();
@@ -2428,11 +3348,32 @@ namespace ecs_hpp
     {
         (void)iseq;
         const auto ss = std::make_tuple(find_storage_<Ts>()...);
-        if ( !detail::tuple_contains(ss, nullptr) ) {
-            for_each_component<T>([this, &f, &ss](const uentity& e, T& t) {
-                for_joined_components_impl_<Ts...>(e, f, ss, t);
-            });
+        if ( detail::tuple_contains(ss, nullptr) ) {
+            return;
         }
+        detail::component_storage<T>* first = find_storage_<T>();
+        const detail::owning_group* group = first
+            ? first->group()
+            : nullptr;
+        if ( group && group->covered_by({
+            detail::type_family<T>::id(),
+            detail::type_family<Ts>::id()...}) )
+        {
+            // every joined entity is in the group prefix
+            detail::count_visited_entities(group->size());
+            for ( std::size_t i = 0, e = group->size(); i < e; ++i ) {
+                const entity_id id = first->entity_at(i);
+                const auto cs = std::make_tuple(
+                    find_grouped_component_(*std::get<Is - 1u>(ss), group, i, id)...);
+                if ( !detail::tuple_contains(cs, nullptr) ) {
+                    f(uentity{*this, id}, first->component_at(i), *std::get<Is - 1u>(cs)...);
+                }
+            }
+            return;
+        }
+        for_each_component<T>([this, &f, &ss](const uentity& e, T& t) {
+            for_joined_components_impl_<Ts...>(e, f, ss, t);
+        });
     }
 
     template < typename T
@@ -2446,11 +3387,32 @@ namespace ecs_hpp
     {
         (void)iseq;
         const auto ss = std::make_tuple(find_storage_<Ts>()...);
-        if ( !detail::tuple_contains(ss, nullptr) ) {
-            for_each_component<T>([this, &f, &ss](const const_uentity& e, const T& t) {
-                detail::as_const(*this).for_joined_components_impl_<Ts...>(e, f, ss, t);
-            });
+        if ( detail::tuple_contains(ss, nullptr) ) {
+            return;
         }
+        const detail::component_storage<T>* first = find_storage_<T>();
+        const detail::owning_group* group = first
+            ? first->group()
+            : nullptr;
+        if ( group && group->covered_by({
+            detail::type_family<T>::id(),
+            detail::type_family<Ts>::id()...}) )
+        {
+            // every joined entity is in the group prefix
+            detail::count_visited_entities(group->size());
+            for ( std::size_t i = 0, e = group->size(); i < e; ++i ) {
+                const entity_id id = first->entity_at(i);
+                const auto cs = std::make_tuple(
+                    find_grouped_component_(*std::get<Is - 1u>(ss), group, i, id)...);
+                if ( !detail::tuple_contains(cs, nullptr) ) {
+                    f(const_uentity{*this, id}, first->component_at(i), *std::get<Is - 1u>(cs)...);
+                }
+            }
+            return;
+        }
+        for_each_component<T>([this, &f, &ss](const const_uentity& e, const T& t) {
+            detail::as_const(*this).for_joined_components_impl_<Ts...>(e, f, ss, t);
+        });
     }
 
     template < typename T
@@ -2519,3 +3481,98 @@ namespace ecs_hpp
         f(e, cs...);
     }
 }
+
+// -----------------------------------------------------------------------------
+//
+// command_buffer impl
+//
+// -----------------------------------------------------------------------------
+
+namespace ecs_hpp
+{
+    inline command_buffer& command_buffer::create_entity(const prototype& proto) {
+        return invoke([proto](registry& owner){
+            owner.create_entity(proto);
+        });
+    }
+
+    namespace detail
+    {
+        inline void destroy_entity_command::execute(registry& owner, const entity_destroyer& destroyer) {
+            if ( !owner.valid_entity(ent_) ) {
+                return;
+            }
+            if ( destroyer ) {
+                destroyer(owner, ent_);
+            } else {
+                owner.destroy_entity(ent_);
+            }
+        }
+    }
+
+    inline command_buffer& command_buffer::destroy_entity(entity_id ent) {
+        commands_.push_back(std::make_unique<detail::destroy_entity_command>(ent));
+        return *this;
+    }
+
+    template < typename T, typename... Args >
+    command_buffer& command_buffer::assign_component(entity_id ent, Args&&... args) {
+        return invoke([ent, args = std::make_tuple(std::forward<Args>(args)...)](registry& owner) mutable {
+            if ( owner.valid_entity(ent) ) {
+                detail::tiny_tuple_apply([&owner, ent](auto&&... as){
+                    owner.assign_component<T>(ent, std::forward<decltype(as)>(as)...);
+                }, std::move(args));
+            }
+        });
+    }
+
+    template < typename T >
+    command_buffer& command_buffer::remove_component(entity_id ent) {
+        return invoke([ent](registry& owner){
+            if ( owner.valid_entity(ent) ) {
+                owner.remove_component<T>(ent);
+            }
+        });
+    }
+
+    inline command_buffer& command_buffer::remove_all_components(entity_id ent) {
+        return invoke([ent](registry& owner){
+            if ( owner.valid_entity(ent) ) {
+                owner.remove_all_components(ent);
+            }
+        });
+    }
+
+    template < typename F >
+    command_buffer& command_buffer::invoke(F&& f) {
+        using command_t = detail::invoke_command<std::decay_t<F>>;
+        commands_.push_back(std::make_unique<command_t>(std::decay_t<F>(std::forward<F>(f))));
+        return *this;
+    }
+
+    inline void command_buffer::clear() noexcept {
+        commands_.clear();
+    }
+
+    inline bool command_buffer::empty() const noexcept {
+        return commands_.empty();
+    }
+
+    inline std::size_t command_buffer::size() const noexcept {
+        return commands_.size();
+    }
+
+    inline void command_buffer::playback(registry& owner) {
+        playback(owner, entity_destroyer());
+    }
+
+    inline void command_buffer::playback(registry& owner, const entity_destroyer& destroyer) {
+        // commands recorded while playing back
+        // are kept for the next playback
+        std::vector<detail::command_uptr> commands;
+        commands.swap(commands_);
+        for ( const detail::command_uptr& command : commands ) {
+            command->execute(owner, destroyer);
+        }
+    }
+}
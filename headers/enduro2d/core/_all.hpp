@@ -17,5 +17,6 @@
 #include "platform.hpp"
 #include "render.hpp"
 #include "render.inl"
+#include "tracer.hpp"
 #include "vfs.hpp"
 #include "window.hpp"
@@ -45,6 +45,7 @@ namespace e2d
     class pixel_declaration;
     class index_declaration;
     class vertex_declaration;
+    class tracer;
     class vfs;
     class window;
 }
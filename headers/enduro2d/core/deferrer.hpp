@@ -10,7 +10,88 @@
 
 namespace e2d
 {
+    //
+    // deferrer_cancelled_exception
+    //
+
+    class deferrer_cancelled_exception final : public exception {
+    public:
+        const char* what() const noexcept final {
+            return "deferrer cancelled exception";
+        }
+    };
+
+    //
+    // cancellation_token
+    //
+
+    class cancellation_token final {
+    public:
+        // a new token, copies share the cancellation state
+        cancellation_token();
+
+        // a token that is never cancelled
+        static cancellation_token none() noexcept;
+
+        // a token of work shared by several requests, it's cancelled
+        // when all of the joined request tokens are cancelled
+        static cancellation_token all_of(const cancellation_token& token);
+
+        // returns false if the shared work is cancelled already
+        bool join(const cancellation_token& token);
+
+        void cancel() noexcept;
+        bool cancelled() const noexcept;
+    private:
+        struct state;
+        cancellation_token(std::shared_ptr<state> state) noexcept;
+    private:
+        std::shared_ptr<state> state_;
+    };
+
+    //
+    // deferrer
+    //
+
     class deferrer final : public module<deferrer> {
+    public:
+        // tasks inherit the context of the thread scheduling them and run
+        // in it, so continuations of their promises run there too.
+        // tasks of a cancelled context are dropped before they start
+        struct task_context {
+            stdex::jobber_priority priority{stdex::jobber_priority::normal};
+            cancellation_token token{cancellation_token::none()};
+            // the tracer span that spans of the task are nested in
+            u64 trace_span{0u};
+            // asset dependencies with placeholders don't wait for loading
+            bool streaming{false};
+            // requests joining shared work raise its priority,
+            // it applies to the tasks scheduled after the raise
+            std::shared_ptr<std::atomic<stdex::jobber_priority>> raised_priority{};
+
+            stdex::jobber_priority current_priority() const noexcept;
+            void raise_priority(stdex::jobber_priority new_priority) noexcept;
+        };
+
+        class context_scope final : private e2d::noncopyable {
+        public:
+            explicit context_scope(task_context context) noexcept;
+            ~context_scope() noexcept;
+        private:
+            task_context context_;
+            const task_context* prev_context_{nullptr};
+        };
+
+        static const task_context& current_context() noexcept;
+
+        // wraps a task to run it in the context and to settle
+        // 'result' there, for executors other than the deferrer
+        template < typename R, typename F, typename... Args >
+        static auto make_context_task(
+            const task_context& context,
+            stdex::promise<R> result,
+            F&& f,
+            Args&&... args);
     public:
         deferrer();
         ~deferrer() noexcept final = default;
@@ -26,6 +107,16 @@ namespace e2d
                  , typename R = stdex::scheduler::schedule_invoke_result_t<F, Args...> >
         stdex::promise<R> do_in_main_thread(F&& f, Args&&... args);
 
+        // budgeted tasks are heavy main thread work like resource uploads,
+        // they're spread across frames by the main thread budget and
+        // processed in order of priority, 'bytes' is the cost of the task
+        template < typename F
+                 , typename R = stdex::scheduler::schedule_invoke_result_t<F> >
+        stdex::promise<R> do_in_main_thread_budgeted(
+            stdex::scheduler_priority priority,
+            std::size_t bytes,
+            F&& f);
+
         template < typename F
                  , typename... Args
                  , typename R = stdex::jobber::async_invoke_result_t<F, Args...> >
@@ -33,9 +124,29 @@ namespace e2d
 
         template < typename T >
         void active_safe_wait_promise(const stdex::promise<T>& promise) noexcept;
+
+        // zero time or bytes means no limit
+        deferrer& main_thread_budget(microseconds<u64> time, std::size_t bytes) noexcept;
+        microseconds<u64> main_thread_time_budget() const noexcept;
+        std::size_t main_thread_byte_budget() const noexcept;
+
+        // processes all main thread tasks and budgeted ones within
+        // the budget, at least one budgeted task runs to make progress
+        std::size_t process_main_thread_tasks() noexcept;
+        std::size_t budgeted_task_count() const noexcept;
+    private:
+        static stdex::scheduler_priority budgeted_priority_(
+            stdex::scheduler_priority priority,
+            stdex::jobber_priority context_priority) noexcept;
     private:
         stdex::jobber worker_;
         stdex::scheduler scheduler_;
+        stdex::scheduler budgeted_scheduler_;
+    private:
+        microseconds<u64> time_budget_{0u};
+        std::size_t byte_budget_{0u};
+        std::size_t frame_bytes_{0u};
+        std::atomic<std::size_t> budgeted_task_count_{0u};
     };
 }
 
@@ -43,19 +154,96 @@ namespace e2d
 {
     template < typename F , typename... Args , typename R >
     stdex::promise<R> deferrer::do_in_main_thread(F&& f, Args&&... args) {
-        return scheduler_.schedule(std::forward<F>(f), std::forward<Args>(args)...);
+        const task_context& context = current_context();
+        stdex::promise<R> result;
+        scheduler_.schedule(
+            static_cast<stdex::scheduler_priority>(context.current_priority()),
+            make_context_task(context, result, std::forward<F>(f), std::forward<Args>(args)...))
+        .except([result](std::exception_ptr e) mutable {
+            result.reject(e);
+        });
+        return result;
+    }
+
+    template < typename F , typename R >
+    stdex::promise<R> deferrer::do_in_main_thread_budgeted(
+        stdex::scheduler_priority priority,
+        std::size_t bytes,
+        F&& f)
+    {
+        const task_context& context = current_context();
+        stdex::promise<R> result;
+        ++budgeted_task_count_;
+        budgeted_scheduler_.schedule(
+            budgeted_priority_(priority, context.current_priority()),
+            [
+                this,
+                bytes,
+                task = make_context_task(context, result, std::forward<F>(f))
+            ]() mutable {
+                --budgeted_task_count_;
+                frame_bytes_ += bytes;
+                task();
+            })
+        .except([result](std::exception_ptr e) mutable {
+            result.reject(e);
+        });
+        return result;
     }
 
     template < typename F , typename... Args , typename R >
     stdex::promise<R> deferrer::do_in_worker_thread(F&& f, Args&&... args) {
-        return worker_.async(std::forward<F>(f), std::forward<Args>(args)...);
+        const task_context& context = current_context();
+        stdex::promise<R> result;
+        worker_.async(
+            context.current_priority(),
+            make_context_task(context, result, std::forward<F>(f), std::forward<Args>(args)...))
+        .except([result](std::exception_ptr e) mutable {
+            result.reject(e);
+        });
+        return result;
+    }
+
+    template < typename R, typename F, typename... Args >
+    auto deferrer::make_context_task(
+        const task_context& context,
+        stdex::promise<R> result,
+        F&& f,
+        Args&&... args)
+    {
+        return [
+            context,
+            result,
+            f = std::forward<F>(f),
+            args = std::make_tuple(std::forward<Args>(args)...)
+        ]() mutable noexcept {
+            if ( context.token.cancelled() ) {
+                result.reject(deferrer_cancelled_exception());
+                return;
+            }
+            context_scope scope(context);
+            try {
+                if constexpr ( std::is_void_v<R> ) {
+                    std::apply(std::move(f), std::move(args));
+                    result.resolve();
+                } else {
+                    result.resolve(std::apply(std::move(f), std::move(args)));
+                }
+            } catch (...) {
+                result.reject(std::current_exception());
+            }
+        };
     }
 
     template < typename T >
     void deferrer::active_safe_wait_promise(const stdex::promise<T>& promise) noexcept {
         const auto zero_us = time::to_chrono(make_microseconds(0));
         while ( promise.wait_for(zero_us) == stdex::promise_wait_status::timeout ) {
-            if ( !is_in_main_thread() || 0 == scheduler_.process_one_task().second ) {
+            // blocking waits ignore the budget to avoid deadlocks
+            if ( !is_in_main_thread()
+                || (0 == scheduler_.process_one_task().second
+                    && 0 == budgeted_scheduler_.process_one_task().second) )
+            {
                 if ( 0 == worker_.active_wait_one().second ) {
                     std::this_thread::yield();
                 }
@@ -22,6 +22,7 @@ namespace e2d
         class debug_parameters;
         class window_parameters;
         class timer_parameters;
+        class deferrer_parameters;
         class parameters;
     public:
         engine(int argc, char *argv[], const parameters& params);
@@ -37,6 +38,17 @@ namespace e2d
         u32 frame_rate() const noexcept;
         u32 frame_count() const noexcept;
         f32 realtime_time() const noexcept;
+
+        // with a fixed framerate application::frame_tick runs
+        // zero or more times per rendered frame and delta_time
+        // is always the fixed step, input edges like 'just pressed'
+        // are seen by exactly one step
+        bool fixed_time_step() const noexcept;
+
+        // part of the fixed step elapsed since the last frame_tick,
+        // frame_render can use it to interpolate simulation states,
+        // always 1 without a fixed framerate
+        f32 interpolation_factor() const noexcept;
     private:
         class internal_state;
         std::unique_ptr<internal_state> state_;
@@ -104,12 +116,37 @@ namespace e2d
     public:
         timer_parameters& minimal_framerate(u32 value) noexcept;
         timer_parameters& maximal_framerate(u32 value) noexcept;
+        timer_parameters& fixed_framerate(u32 value) noexcept;
+        timer_parameters& maximal_fixed_steps(u32 value) noexcept;
 
         u32 minimal_framerate() const noexcept;
         u32 maximal_framerate() const noexcept;
+        u32 fixed_framerate() const noexcept;
+        u32 maximal_fixed_steps() const noexcept;
     private:
         u32 minimal_framerate_{30u};
         u32 maximal_framerate_{1000u};
+        // zero means one frame_tick per frame with a variable step
+        u32 fixed_framerate_{0u};
+        // the rest of the time is dropped to avoid a death spiral
+        u32 maximal_fixed_steps_{5u};
+    };
+
+    //
+    // engine::deferrer_parameters
+    //
+
+    class engine::deferrer_parameters {
+    public:
+        deferrer_parameters& main_thread_time_budget(microseconds<u64> value) noexcept;
+        deferrer_parameters& main_thread_byte_budget(std::size_t value) noexcept;
+
+        microseconds<u64> main_thread_time_budget() const noexcept;
+        std::size_t main_thread_byte_budget() const noexcept;
+    private:
+        // per frame limits of budgeted main thread tasks, zero is unlimited
+        microseconds<u64> main_thread_time_budget_{make_microseconds<u64>(4000u)};
+        std::size_t main_thread_byte_budget_{0u};
     };
 
     //
@@ -128,6 +165,7 @@ namespace e2d
         parameters& debug_params(const debug_parameters& value);
         parameters& window_params(const window_parameters& value);
         parameters& timer_params(const timer_parameters& value);
+        parameters& deferrer_params(const deferrer_parameters& value);
 
         str& game_name() noexcept;
         str& company_name() noexcept;
@@ -136,6 +174,7 @@ namespace e2d
         debug_parameters& debug_params() noexcept;
         window_parameters& window_params() noexcept;
         timer_parameters& timer_params() noexcept;
+        deferrer_parameters& deferrer_params() noexcept;
 
         const str& game_name() const noexcept;
         const str& company_name() const noexcept;
@@ -144,6 +183,7 @@ namespace e2d
         const debug_parameters& debug_params() const noexcept;
         const window_parameters& window_params() const noexcept;
         const timer_parameters& timer_params() const noexcept;
+        const deferrer_parameters& deferrer_params() const noexcept;
     private:
         str game_name_{"noname"};
         str company_name_{"noname"};
@@ -152,6 +192,7 @@ namespace e2d
         debug_parameters debug_params_;
         window_parameters window_params_;
         timer_parameters timer_params_;
+        deferrer_parameters deferrer_params_;
     };
 }
 
@@ -0,0 +1,90 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include "_core.hpp"
+
+#include "deferrer.hpp"
+
+namespace e2d
+{
+    //
+    // tracer
+    //
+    // in-memory timeline of asset loading stages, spans are
+    // nested through the deferrer task context, so dependency
+    // loads and their stages become children of the load
+    //
+
+    class tracer final : public module<tracer> {
+    public:
+        struct span {
+            u64 id{0u};
+            u64 parent_id{0u};
+            u32 thread_id{0u};
+            str type;
+            str stage;
+            str name;
+            microseconds<u64> begin;
+            microseconds<u64> end;
+        };
+
+        struct summary {
+            str type;
+            str stage;
+            std::size_t count{0u};
+            microseconds<u64> total;
+            microseconds<u64> max;
+        };
+
+        class scope;
+    public:
+        tracer() = default;
+        ~tracer() noexcept final = default;
+
+        u64 next_span_id() noexcept;
+        void add_span(span span);
+
+        vector<span> spans() const;
+        void clear() noexcept;
+
+        // total and maximal durations per type and stage
+        vector<summary> summarize() const;
+
+        // chrome://tracing and perfetto json
+        bool try_save_chrome_trace(str& dst) const noexcept;
+
+        static u32 current_thread_id() noexcept;
+
+        // spans of asynchronous operations, the span is nested in
+        // the current context and has zero id if the tracer isn't
+        // initialized, spans with zero id are ignored on the end
+        static span begin_span(str_view type, str_view stage, str_view name);
+        static void end_span(span span) noexcept;
+    private:
+        mutable std::mutex mutex_;
+        vector<span> spans_;
+        std::atomic<u64> last_span_id_{0u};
+    };
+
+    //
+    // tracer::scope
+    //
+    // a span of the current thread, tasks scheduled
+    // in the scope are nested in it, does nothing
+    // if the tracer isn't initialized
+    //
+
+    class tracer::scope final : private e2d::noncopyable {
+    public:
+        scope(str_view type, str_view stage, str_view name);
+        ~scope() noexcept;
+    private:
+        span span_;
+        std::unique_ptr<deferrer::context_scope> context_;
+    };
+}
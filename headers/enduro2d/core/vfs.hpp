@@ -33,8 +33,10 @@ namespace e2d
             virtual ~file_source() noexcept = default;
             virtual bool valid() const noexcept = 0;
             virtual bool exists(str_view path) const = 0;
+            virtual bool write_time(str_view path, microseconds<u64>& dst) const = 0;
             virtual input_stream_uptr read(str_view path) const = 0;
             virtual output_stream_uptr write(str_view path, bool append) const = 0;
+            virtual bool remove(str_view path) const = 0;
             virtual bool trace(str_view path, filesystem::trace_func func) const = 0;
         };
         using file_source_uptr = std::unique_ptr<file_source>;
@@ -49,8 +51,12 @@ namespace e2d
 
         bool exists(const url& url) const;
 
+        // last modification time since the unix epoch
+        bool write_time(const url& url, microseconds<u64>& dst) const;
+
         input_stream_uptr read(const url& url) const;
         output_stream_uptr write(const url& url, bool append) const;
+        bool remove(const url& url) const;
 
         bool load(const url& url, buffer& dst) const;
         stdex::promise<buffer> load_async(const url& url) const;
@@ -74,8 +80,10 @@ namespace e2d
         ~archive_file_source() noexcept final;
         bool valid() const noexcept final;
         bool exists(str_view path) const final;
+        bool write_time(str_view path, microseconds<u64>& dst) const final;
         input_stream_uptr read(str_view path) const final;
         output_stream_uptr write(str_view path, bool append) const final;
+        bool remove(str_view path) const final;
         bool trace(str_view path, filesystem::trace_func func) const final;
     private:
         class state;
@@ -88,8 +96,10 @@ namespace e2d
         ~filesystem_file_source() noexcept final;
         bool valid() const noexcept final;
         bool exists(str_view path) const final;
+        bool write_time(str_view path, microseconds<u64>& dst) const final;
         input_stream_uptr read(str_view path) const final;
         output_stream_uptr write(str_view path, bool append) const final;
+        bool remove(str_view path) const final;
         bool trace(str_view path, filesystem::trace_func func) const final;
     };
 }
@@ -35,21 +35,27 @@
 
 #include "systems/flipbook_system.hpp"
 #include "systems/render_system.hpp"
+#include "systems/spatial_index_system.hpp"
 
 #include "address.hpp"
 #include "asset.hpp"
 #include "asset.inl"
+#include "asset_manifest.hpp"
 #include "atlas.hpp"
 #include "factory.hpp"
 #include "factory.inl"
 #include "flipbook.hpp"
 #include "gobject.hpp"
+#include "image_cache.hpp"
 #include "library.hpp"
 #include "library.inl"
 #include "model.hpp"
 #include "node.hpp"
 #include "node.inl"
 #include "prefab.hpp"
+#include "sorted_components.hpp"
+#include "spatial_index.hpp"
+#include "spatial_index.inl"
 #include "sprite.hpp"
 #include "starter.hpp"
 #include "world.hpp"
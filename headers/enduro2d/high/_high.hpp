@@ -47,14 +47,17 @@ namespace e2d
 
     class flipbook_system;
     class render_system;
+    class spatial_index_system;
 
     template < typename Asset, typename Content >
     class content_asset;
     class asset;
 
     class factory;
+    class image_cache;
     class library;
     class asset_cache;
+    class asset_manifest;
     class asset_group;
     class asset_dependencies;
 
@@ -64,6 +67,7 @@ namespace e2d
     class model;
     class node;
     class prefab;
+    class spatial_index;
     class sprite;
     class starter;
     class world;
@@ -30,6 +30,11 @@ namespace e2d
     using asset_ptr = intrusive_ptr<asset>;
     using nested_content = hash_map<str_hash, asset_ptr>;
 
+    struct asset_memory_usage final {
+        std::size_t cpu_bytes{0u};
+        std::size_t gpu_bytes{0u};
+    };
+
     class asset
         : private noncopyable
         , public ref_counter<asset> {
@@ -37,6 +42,9 @@ namespace e2d
         asset() = default;
         virtual ~asset() noexcept = default;
         virtual asset_ptr find_nested_asset(str_view nested_address) const noexcept = 0;
+
+        // approximate size of the own content without nested assets
+        virtual asset_memory_usage memory_usage() const noexcept;
     };
 
     //
@@ -60,55 +68,85 @@ namespace e2d
         void fill(Content content);
         void fill(Content content, nested_content nested_content);
 
+        // copies the content and nested assets, fills placeholders
+        void fill_from(const content_asset& other);
+
         const Content& content() const noexcept;
 
+        // unique among assets of the type and changed by every fill,
+        // views into the content stay valid while it's the same
+        u64 content_version() const noexcept;
+
         template < typename NestedAsset >
         typename NestedAsset::ptr find_nested_asset(str_view nested_address) const noexcept;
         asset_ptr find_nested_asset(str_view nested_address) const noexcept override;
     private:
         Content content_;
         nested_content nested_content_;
+        u64 content_version_{next_content_version_()};
+    private:
+        static u64 next_content_version_() noexcept;
     };
 
     //
-    // asset_cache_base
+    // typed_asset_address
+    //
+    // key of the sharded asset tables
     //
 
-    class asset_cache_base : private noncopyable {
-    public:
-        asset_cache_base() = default;
-        virtual ~asset_cache_base() noexcept = default;
+    struct typed_asset_address final {
+        utils::type_family_id type{0u};
+        str_hash address;
 
-        virtual std::size_t asset_count() const noexcept = 0;
-        virtual std::size_t unload_unused_assets() noexcept = 0;
+        std::size_t hash() const noexcept;
+    };
+
+    bool operator==(const typed_asset_address& l, const typed_asset_address& r) noexcept;
+    bool operator!=(const typed_asset_address& l, const typed_asset_address& r) noexcept;
+
+    struct typed_asset_address_hash final {
+        std::size_t operator()(const typed_asset_address& key) const noexcept {
+            return key.hash();
+        }
     };
 
     //
-    // typed_asset_cache
+    // asset_priority
+    //
+    // unused assets are evicted from the lowest priority,
+    // pinned assets are never unloaded by the cache
     //
 
-    template < typename Asset >
-    class typed_asset_cache : public asset_cache_base {
-    public:
-        using asset_ptr = typename Asset::ptr;
-    public:
-        typed_asset_cache() = default;
-        ~typed_asset_cache() noexcept final = default;
+    enum class asset_priority : u8 {
+        low,
+        normal,
+        high,
+        pinned
+    };
 
-        asset_ptr find(str_hash address) const noexcept;
-        void store(str_hash address, const asset_ptr& asset);
+    //
+    // asset_cache_stats
+    //
 
-        std::size_t asset_count() const noexcept override;
-        std::size_t unload_unused_assets() noexcept override;
-    private:
-        hash_map<str_hash, asset_ptr> assets_;
+    struct asset_cache_stats final {
+        std::size_t hits{0u};
+        std::size_t misses{0u};
+        std::size_t evictions{0u};
+        std::size_t cpu_bytes{0u};
+        std::size_t gpu_bytes{0u};
     };
 
     //
     // asset_cache
     //
+    // lock-striped, so concurrent loads of different assets
+    // don't serialize on one mutex, unused assets are evicted
+    // in the least recently used order down to the memory budget
+    //
 
-    class asset_cache final {
+    class asset_cache final : private noncopyable {
+    public:
+        static constexpr std::size_t shard_count = 16u;
     public:
         asset_cache() = default;
         ~asset_cache() noexcept = default;
@@ -116,17 +154,80 @@ namespace e2d
         template < typename Asset >
         void store(str_hash address, const typename Asset::ptr& asset);
 
+        // counts a hit or a miss and refreshes the recency
         template < typename Asset >
         typename Asset::ptr find(str_hash address) const noexcept;
 
+        // doesn't affect the stats and the recency
+        template < typename Asset >
+        typename Asset::ptr peek(str_hash address) const noexcept;
+
+        // can be set before the asset is loaded
+        template < typename Asset >
+        void priority(str_hash address, asset_priority priority);
+
+        template < typename Asset >
+        asset_priority priority(str_hash address) const noexcept;
+
         template < typename Asset >
         std::size_t asset_count() const noexcept;
         std::size_t asset_count() const noexcept;
 
+        // unloads all unused assets except pinned ones
         std::size_t unload_unused_assets() noexcept;
+
+        // zero means unlimited
+        void memory_budget(std::size_t bytes) noexcept;
+        std::size_t memory_budget() const noexcept;
+        std::size_t memory_usage() const noexcept;
+
+        // evicts unused assets until the memory usage fits the budget
+        // or the time slice is over, returns the count of evicted assets
+        std::size_t evict_unused_assets(const microseconds<u64>& time_slice);
+
+        asset_cache_stats stats() const noexcept;
+    private:
+        struct entry {
+            asset_ptr asset;
+            asset_memory_usage usage;
+            asset_priority priority{asset_priority::normal};
+            mutable std::atomic<u64> last_access{0u};
+
+            entry() = default;
+            entry(const entry& other) noexcept;
+            entry& operator=(const entry& other) noexcept;
+        };
+
+        struct shard {
+            mutable std::mutex mutex;
+            hash_map<typed_asset_address, entry, typed_asset_address_hash> assets;
+            hash_map<typed_asset_address, asset_priority, typed_asset_address_hash> priorities;
+        };
+
+        struct eviction_candidate {
+            typed_asset_address key;
+            asset_priority priority;
+            u64 last_access;
+        };
+
+        shard& shard_(const typed_asset_address& key) const noexcept;
+        void store_(const typed_asset_address& key, const asset_ptr& asset);
+        asset_ptr find_(const typed_asset_address& key, bool touch) const noexcept;
+        void erase_usage_(const entry& e) noexcept;
+        void collect_eviction_candidates_();
+        bool evict_candidate_(const eviction_candidate& candidate) noexcept;
     private:
-        using asset_cache_uptr = std::unique_ptr<asset_cache_base>;
-        hash_map<utils::type_family_id, asset_cache_uptr> caches_;
+        mutable std::array<shard, shard_count> shards_;
+        mutable std::atomic<u64> access_clock_{0u};
+        mutable std::atomic<std::size_t> hits_{0u};
+        mutable std::atomic<std::size_t> misses_{0u};
+        std::atomic<std::size_t> evictions_{0u};
+        std::atomic<std::size_t> cpu_bytes_{0u};
+        std::atomic<std::size_t> gpu_bytes_{0u};
+        std::atomic<std::size_t> memory_budget_{0u};
+        std::mutex eviction_mutex_;
+        vector<eviction_candidate> eviction_candidates_;
+        std::size_t next_eviction_candidate_{0u};
     };
 }
 
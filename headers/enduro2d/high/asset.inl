@@ -10,6 +10,14 @@
 
 namespace e2d
 {
+    //
+    // asset
+    //
+
+    inline asset_memory_usage asset::memory_usage() const noexcept {
+        return asset_memory_usage();
+    }
+
     //
     // content_asset
     //
@@ -39,12 +47,21 @@ namespace e2d
     template < typename Asset, typename Content >
     void content_asset<Asset, Content>::fill(Content content) {
         content_ = std::move(content);
+        content_version_ = next_content_version_();
     }
 
     template < typename Asset, typename Content >
     void content_asset<Asset, Content>::fill(Content content, nested_content nested_content) {
         content_ = std::move(content);
         nested_content_ = std::move(nested_content);
+        content_version_ = next_content_version_();
+    }
+
+    template < typename Asset, typename Content >
+    void content_asset<Asset, Content>::fill_from(const content_asset& other) {
+        content_ = other.content_;
+        nested_content_ = other.nested_content_;
+        content_version_ = next_content_version_();
     }
 
     template < typename Asset, typename Content >
@@ -52,6 +69,17 @@ namespace e2d
         return content_;
     }
 
+    template < typename Asset, typename Content >
+    u64 content_asset<Asset, Content>::content_version() const noexcept {
+        return content_version_;
+    }
+
+    template < typename Asset, typename Content >
+    u64 content_asset<Asset, Content>::next_content_version_() noexcept {
+        static std::atomic<u64> last_version{0u};
+        return ++last_version;
+    }
+
     template < typename Asset, typename Content >
     template < typename NestedAsset >
     typename NestedAsset::ptr content_asset<Asset, Content>::find_nested_asset(str_view nested_address) const noexcept {
@@ -71,96 +99,275 @@ namespace e2d
     }
 
     //
-    // typed_asset_cache
+    // typed_asset_address
     //
 
-    template < typename T >
-    typename typed_asset_cache<T>::asset_ptr typed_asset_cache<T>::find(str_hash address) const noexcept {
-        const auto iter = assets_.find(address);
-        return iter != assets_.end()
-            ? iter->second
-            : nullptr;
-    }
-
-    template < typename T >
-    void typed_asset_cache<T>::store(str_hash address, const asset_ptr& asset) {
-        assets_[address] = asset;
+    inline std::size_t typed_asset_address::hash() const noexcept {
+        return utils::hash_combine(
+            std::hash<utils::type_family_id>()(type),
+            std::hash<u32>()(address.hash()));
     }
 
-    template < typename T >
-    std::size_t typed_asset_cache<T>::asset_count() const noexcept {
-        return assets_.size();
+    inline bool operator==(const typed_asset_address& l, const typed_asset_address& r) noexcept {
+        return l.type == r.type
+            && l.address == r.address;
     }
 
-    template < typename T >
-    std::size_t typed_asset_cache<T>::unload_unused_assets() noexcept {
-        std::size_t result = 0u;
-        for ( auto iter = assets_.begin(); iter != assets_.end(); ) {
-            if ( !iter->second || 1 == iter->second->use_count() ) {
-                iter = assets_.erase(iter);
-                ++result;
-            } else {
-                ++iter;
-            }
-        }
-        return result;
+    inline bool operator!=(const typed_asset_address& l, const typed_asset_address& r) noexcept {
+        return !(l == r);
     }
 
     //
     // asset_cache
     //
 
+    inline asset_cache::entry::entry(const entry& other) noexcept
+    : asset(other.asset)
+    , usage(other.usage)
+    , priority(other.priority)
+    , last_access(other.last_access.load()) {}
+
+    inline asset_cache::entry& asset_cache::entry::operator=(const entry& other) noexcept {
+        if ( this != &other ) {
+            asset = other.asset;
+            usage = other.usage;
+            priority = other.priority;
+            last_access.store(other.last_access.load());
+        }
+        return *this;
+    }
+
     template < typename Asset >
     void asset_cache::store(str_hash address, const typename Asset::ptr& asset) {
-        const auto family = utils::type_family<Asset>::id();
-        const auto iter = caches_.find(family);
-        typed_asset_cache<Asset>* cache = iter != caches_.end() && iter->second
-            ? static_cast<typed_asset_cache<Asset>*>(iter->second.get())
-            : nullptr;
-        if ( !cache ) {
-            cache = static_cast<typed_asset_cache<Asset>*>(caches_.emplace(
-                family,
-                std::make_unique<typed_asset_cache<Asset>>()).first->second.get());
-        }
-        cache->store(address, asset);
+        store_({utils::type_family<Asset>::id(), address}, asset);
     }
 
     template < typename Asset >
     typename Asset::ptr asset_cache::find(str_hash address) const noexcept {
-        const auto iter = caches_.find(utils::type_family<Asset>::id());
-        const typed_asset_cache<Asset>* cache = iter != caches_.end() && iter->second
-            ? static_cast<const typed_asset_cache<Asset>*>(iter->second.get())
-            : nullptr;
-        return cache
-            ? cache->find(address)
-            : nullptr;
+        return static_pointer_cast<Asset>(
+            find_({utils::type_family<Asset>::id(), address}, true));
+    }
+
+    template < typename Asset >
+    typename Asset::ptr asset_cache::peek(str_hash address) const noexcept {
+        return static_pointer_cast<Asset>(
+            find_({utils::type_family<Asset>::id(), address}, false));
+    }
+
+    template < typename Asset >
+    void asset_cache::priority(str_hash address, asset_priority priority) {
+        const typed_asset_address key{utils::type_family<Asset>::id(), address};
+        shard& s = shard_(key);
+        std::lock_guard<std::mutex> guard(s.mutex);
+        if ( priority == asset_priority::normal ) {
+            s.priorities.erase(key);
+        } else {
+            s.priorities[key] = priority;
+        }
+        const auto iter = s.assets.find(key);
+        if ( iter != s.assets.end() ) {
+            iter->second.priority = priority;
+        }
+    }
+
+    template < typename Asset >
+    asset_priority asset_cache::priority(str_hash address) const noexcept {
+        const typed_asset_address key{utils::type_family<Asset>::id(), address};
+        const shard& s = shard_(key);
+        std::lock_guard<std::mutex> guard(s.mutex);
+        const auto iter = s.priorities.find(key);
+        return iter != s.priorities.end()
+            ? iter->second
+            : asset_priority::normal;
     }
 
     template < typename Asset >
     std::size_t asset_cache::asset_count() const noexcept {
-        const auto iter = caches_.find(utils::type_family<Asset>::id());
-        return iter != caches_.end() && iter->second
-            ? iter->second->asset_count()
-            : 0u;
+        const utils::type_family_id type = utils::type_family<Asset>::id();
+        std::size_t result = 0u;
+        for ( const shard& s : shards_ ) {
+            std::lock_guard<std::mutex> guard(s.mutex);
+            result += math::numeric_cast<std::size_t>(std::count_if(
+                s.assets.begin(), s.assets.end(),
+                [type](const auto& p) noexcept {
+                    return p.first.type == type;
+                }));
+        }
+        return result;
     }
 
     inline std::size_t asset_cache::asset_count() const noexcept {
-        return std::accumulate(
-            caches_.begin(), caches_.end(), std::size_t(0),
-            [](std::size_t acc, const auto& p){
-                return p.second
-                    ? acc + p.second->asset_count()
-                    : acc;
-            });
+        std::size_t result = 0u;
+        for ( const shard& s : shards_ ) {
+            std::lock_guard<std::mutex> guard(s.mutex);
+            result += s.assets.size();
+        }
+        return result;
     }
 
     inline std::size_t asset_cache::unload_unused_assets() noexcept {
-        return std::accumulate(
-            caches_.begin(), caches_.end(), std::size_t(0),
-            [](std::size_t acc, const auto& p){
-                return p.second
-                    ? acc + p.second->unload_unused_assets()
-                    : acc;
+        std::size_t result = 0u;
+        for ( shard& s : shards_ ) {
+            std::lock_guard<std::mutex> guard(s.mutex);
+            for ( auto iter = s.assets.begin(); iter != s.assets.end(); ) {
+                const entry& e = iter->second;
+                const bool unused = !e.asset || 1 == e.asset->use_count();
+                if ( unused && e.priority != asset_priority::pinned ) {
+                    erase_usage_(e);
+                    iter = s.assets.erase(iter);
+                    ++result;
+                } else {
+                    ++iter;
+                }
+            }
+        }
+        return result;
+    }
+
+    inline void asset_cache::memory_budget(std::size_t bytes) noexcept {
+        memory_budget_.store(bytes);
+    }
+
+    inline std::size_t asset_cache::memory_budget() const noexcept {
+        return memory_budget_.load();
+    }
+
+    inline std::size_t asset_cache::memory_usage() const noexcept {
+        return cpu_bytes_.load() + gpu_bytes_.load();
+    }
+
+    inline std::size_t asset_cache::evict_unused_assets(const microseconds<u64>& time_slice) {
+        std::lock_guard<std::mutex> guard(eviction_mutex_);
+
+        const auto over_budget = [this]() noexcept {
+            const std::size_t budget = memory_budget();
+            return budget > 0u && memory_usage() > budget;
+        };
+
+        if ( !over_budget() ) {
+            eviction_candidates_.clear();
+            next_eviction_candidate_ = 0u;
+            return 0u;
+        }
+
+        const auto end_time = time::now_us<u64>() + time_slice;
+        if ( next_eviction_candidate_ >= eviction_candidates_.size() ) {
+            collect_eviction_candidates_();
+        }
+
+        std::size_t result = 0u;
+        while ( next_eviction_candidate_ < eviction_candidates_.size() && over_budget() ) {
+            if ( evict_candidate_(eviction_candidates_[next_eviction_candidate_++]) ) {
+                ++result;
+            }
+            if ( time::now_us<u64>() >= end_time ) {
+                break;
+            }
+        }
+        return result;
+    }
+
+    inline asset_cache_stats asset_cache::stats() const noexcept {
+        asset_cache_stats result;
+        result.hits = hits_.load();
+        result.misses = misses_.load();
+        result.evictions = evictions_.load();
+        result.cpu_bytes = cpu_bytes_.load();
+        result.gpu_bytes = gpu_bytes_.load();
+        return result;
+    }
+
+    inline asset_cache::shard& asset_cache::shard_(const typed_asset_address& key) const noexcept {
+        return shards_[key.hash() % shard_count];
+    }
+
+    inline void asset_cache::store_(const typed_asset_address& key, const asset_ptr& asset) {
+        entry e;
+        e.asset = asset;
+        e.usage = asset ? asset->memory_usage() : asset_memory_usage();
+        e.last_access.store(++access_clock_);
+
+        shard& s = shard_(key);
+        std::lock_guard<std::mutex> guard(s.mutex);
+        const auto priority_iter = s.priorities.find(key);
+        if ( priority_iter != s.priorities.end() ) {
+            e.priority = priority_iter->second;
+        }
+        const auto iter = s.assets.find(key);
+        if ( iter != s.assets.end() ) {
+            erase_usage_(iter->second);
+            iter->second = e;
+        } else {
+            s.assets.emplace(key, e);
+        }
+        cpu_bytes_ += e.usage.cpu_bytes;
+        gpu_bytes_ += e.usage.gpu_bytes;
+    }
+
+    inline asset_ptr asset_cache::find_(const typed_asset_address& key, bool touch) const noexcept {
+        const shard& s = shard_(key);
+        std::lock_guard<std::mutex> guard(s.mutex);
+        const auto iter = s.assets.find(key);
+        if ( iter == s.assets.end() ) {
+            if ( touch ) {
+                ++misses_;
+            }
+            return nullptr;
+        }
+        if ( touch ) {
+            ++hits_;
+            iter->second.last_access.store(++access_clock_);
+        }
+        return iter->second.asset;
+    }
+
+    inline void asset_cache::erase_usage_(const entry& e) noexcept {
+        cpu_bytes_ -= e.usage.cpu_bytes;
+        gpu_bytes_ -= e.usage.gpu_bytes;
+    }
+
+    inline void asset_cache::collect_eviction_candidates_() {
+        eviction_candidates_.clear();
+        next_eviction_candidate_ = 0u;
+        for ( const shard& s : shards_ ) {
+            std::lock_guard<std::mutex> guard(s.mutex);
+            for ( const auto& p : s.assets ) {
+                const entry& e = p.second;
+                const bool unused = !e.asset || 1 == e.asset->use_count();
+                if ( unused && e.priority != asset_priority::pinned ) {
+                    eviction_candidates_.push_back({p.first, e.priority, e.last_access.load()});
+                }
+            }
+        }
+        std::sort(
+            eviction_candidates_.begin(),
+            eviction_candidates_.end(),
+            [](const eviction_candidate& l, const eviction_candidate& r) noexcept {
+                return l.priority != r.priority
+                    ? l.priority < r.priority
+                    : l.last_access < r.last_access;
             });
     }
+
+    inline bool asset_cache::evict_candidate_(const eviction_candidate& candidate) noexcept {
+        shard& s = shard_(candidate.key);
+        std::lock_guard<std::mutex> guard(s.mutex);
+        const auto iter = s.assets.find(candidate.key);
+        if ( iter == s.assets.end() ) {
+            return false;
+        }
+        // skips assets used or touched after the candidates were collected
+        const entry& e = iter->second;
+        const bool unused = !e.asset || 1 == e.asset->use_count();
+        if ( !unused
+            || e.priority == asset_priority::pinned
+            || e.last_access.load() != candidate.last_access )
+        {
+            return false;
+        }
+        erase_usage_(e);
+        s.assets.erase(iter);
+        ++evictions_;
+        return true;
+    }
 }
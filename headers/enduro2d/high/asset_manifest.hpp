@@ -0,0 +1,91 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include "_high.hpp"
+
+namespace e2d
+{
+    //
+    // asset_manifest
+    //
+    // offline generated description of library assets (see e2d_cook),
+    // lets the library start loading all transitive
+    // dependencies of an asset at once
+    //
+
+    class asset_manifest final {
+    public:
+        struct entry {
+            // main address relative to the library root
+            str address;
+            // type name of the main asset, see Asset::type_name()
+            str type;
+            // size and fnv1a hash of the source file, lets
+            // a loader detect a stale manifest or cooked file
+            u64 size{0u};
+            u64 content_hash{0u};
+            // main addresses of all transitive dependencies
+            vector<str> dependencies;
+        };
+    public:
+        asset_manifest() = default;
+        ~asset_manifest() noexcept = default;
+
+        asset_manifest(asset_manifest&& other) noexcept;
+        asset_manifest& operator=(asset_manifest&& other) noexcept;
+
+        asset_manifest(const asset_manifest& other);
+        asset_manifest& operator=(const asset_manifest& other);
+
+        void clear() noexcept;
+        void swap(asset_manifest& other) noexcept;
+
+        asset_manifest& assign(asset_manifest&& other) noexcept;
+        asset_manifest& assign(const asset_manifest& other);
+
+        asset_manifest& add_entry(entry&& entry);
+        asset_manifest& add_entry(const entry& entry);
+
+        const entry* find_entry(str_hash address) const noexcept;
+        std::size_t entry_count() const noexcept;
+        bool empty() const noexcept;
+
+        template < typename F >
+        void for_each_entry(F&& f) const;
+    private:
+        hash_map<str_hash, entry> entries_;
+    };
+
+    void swap(asset_manifest& l, asset_manifest& r) noexcept;
+}
+
+namespace e2d::asset_manifests
+{
+    bool try_load_manifest(
+        asset_manifest& dst,
+        const buffer& src) noexcept;
+
+    bool try_load_manifest(
+        asset_manifest& dst,
+        const input_stream_uptr& src) noexcept;
+
+    // entries are saved in order of their addresses
+    bool try_save_manifest(
+        buffer& dst,
+        const asset_manifest& src) noexcept;
+}
+
+namespace e2d
+{
+    template < typename F >
+    void asset_manifest::for_each_entry(F&& f) const {
+        for ( const auto& p : entries_ ) {
+            f(p.second);
+        }
+    }
+}
@@ -16,5 +16,6 @@ namespace e2d
     public:
         static const char* type_name() noexcept { return "binary_asset"; }
         static load_async_result load_async(const library& library, str_view address);
+        asset_memory_usage memory_usage() const noexcept final;
     };
 }
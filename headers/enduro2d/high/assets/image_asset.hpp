@@ -16,5 +16,9 @@ namespace e2d
     public:
         static const char* type_name() noexcept { return "image_asset"; }
         static load_async_result load_async(const library& library, str_view address);
+
+        // the cooked dds form is preferred when it's newer than the source
+        static str cooked_address(str_view address);
+        asset_memory_usage memory_usage() const noexcept final;
     };
 }
@@ -17,5 +17,18 @@ namespace e2d
     public:
         static const char* type_name() noexcept { return "json_asset"; }
         static load_async_result load_async(const library& library, str_view address);
+
+        // the cooked form is preferred when it's newer than the source
+        static str cooked_address(str_view address);
+
+        // cooked documents are tagged with the schema they were validated
+        // against by the cooker, the tag is made from the asset type name
+        static u32 schema_tag(str_view type_name) noexcept;
+
+        bool cooked() const noexcept { return cooked_; }
+        bool validated_for(str_view type_name) const noexcept;
+    private:
+        bool cooked_{false};
+        u32 schema_tag_{0u};
     };
 }
@@ -17,5 +17,7 @@ namespace e2d
     public:
         static const char* type_name() noexcept { return "model_asset"; }
         static load_async_result load_async(const library& library, str_view address);
+        static const rapidjson::SchemaDocument& schema();
+        asset_memory_usage memory_usage() const noexcept final;
     };
 }
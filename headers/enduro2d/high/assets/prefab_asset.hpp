@@ -17,5 +17,6 @@ namespace e2d
     public:
         static const char* type_name() noexcept { return "prefab_asset"; }
         static load_async_result load_async(const library& library, str_view address);
+        static const rapidjson::SchemaDocument& schema();
     };
 }
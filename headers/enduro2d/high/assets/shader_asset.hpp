@@ -16,5 +16,6 @@ namespace e2d
     public:
         static const char* type_name() noexcept { return "shader_asset"; }
         static load_async_result load_async(const library& library, str_view address);
+        static const rapidjson::SchemaDocument& schema();
     };
 }
@@ -44,12 +44,37 @@ namespace e2d
 
         flipbook_player& play(f32 ntime) noexcept;
         flipbook_player& play(str_hash nsequence) noexcept;
+    private:
+        friend class flipbook_system;
+
+        // resolved by flipbook_system, reset by a sequence change,
+        // the sequence points into the flipbook content of the version,
+        // copies start empty, so cloned players are resolved again
+        struct playback_cache {
+            playback_cache() = default;
+            playback_cache(const playback_cache&) noexcept {}
+            playback_cache& operator=(const playback_cache&) noexcept {
+                flipbook_version = 0u;
+                sequence = nullptr;
+                frame = 0u;
+                sprite.reset();
+                valid = false;
+                return *this;
+            }
+
+            u64 flipbook_version{0u};
+            const flipbook::sequence* sequence{nullptr};
+            std::size_t frame{0u};
+            sprite_asset::ptr sprite;
+            bool valid{false};
+        };
     private:
         f32 time_{0.f};
         f32 speed_{1.f};
         bool looped_{false};
         bool playing_{false};
         str_hash sequence_;
+        playback_cache cache_;
     };
 
     template <>
@@ -116,6 +141,7 @@ namespace e2d
 
     inline flipbook_player& flipbook_player::sequence(str_hash value) noexcept {
         sequence_ = value;
+        cache_.valid = false;
         return *this;
     }
 
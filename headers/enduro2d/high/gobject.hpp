@@ -25,6 +25,9 @@ namespace e2d
         gobject(ecs::registry& registry, const ecs::prototype& proto);
         ~gobject() noexcept;
 
+        static void* operator new(std::size_t size);
+        static void operator delete(void* ptr) noexcept;
+
         ecs::entity entity() noexcept;
         ecs::const_entity entity() const noexcept;
         ecs::entity_filler entity_filler() noexcept;
@@ -0,0 +1,55 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include "_high.hpp"
+
+namespace e2d
+{
+    //
+    // image_cache_exception
+    //
+
+    class image_cache_exception : public exception {
+        const char* what() const noexcept override {
+            return "image cache exception";
+        }
+    };
+
+    //
+    // image_cache
+    //
+    // persistent storage of decoded images keyed by the hash
+    // of their source bytes, entries are kept in dds layout and
+    // the least recently used ones are removed over the capacity
+    //
+
+    class image_cache final : public module<image_cache> {
+    public:
+        image_cache(const url& root, std::size_t capacity, deferrer& deferrer);
+        ~image_cache() noexcept final;
+
+        const url& root() const noexcept;
+        std::size_t capacity() const noexcept;
+
+        // bytes of all stored entries
+        std::size_t size() const noexcept;
+        std::size_t entry_count() const noexcept;
+
+        static u64 content_hash(const buffer& src) noexcept;
+
+        bool try_load(image& dst, u64 content_hash);
+        stdex::promise<void> store_async(u64 content_hash, image src);
+
+        // removes the least recently used entries
+        // until the size fits, returns their count
+        std::size_t trim(std::size_t max_size);
+    private:
+        class internal_state;
+        std::unique_ptr<internal_state> state_;
+    };
+}
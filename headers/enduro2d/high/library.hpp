@@ -9,6 +9,7 @@
 #include "_high.hpp"
 
 #include "asset.hpp"
+#include "asset_manifest.hpp"
 
 namespace e2d
 {
@@ -33,12 +34,21 @@ namespace e2d
         : private noncopyable
         , public ref_counter<loading_asset> {
     public:
-        loading_asset() = default;
+        // the load runs in its own context shared by all of its
+        // requesters, it takes the highest of their priorities and
+        // is cancelled when all of their tokens are cancelled
+        explicit loading_asset(const deferrer::task_context& requester);
         virtual ~loading_asset() noexcept = default;
 
+        // returns false if all the requesters cancelled the load already
+        bool join(const deferrer::task_context& requester);
+        const deferrer::task_context& context() const noexcept;
+
         virtual void cancel() noexcept = 0;
         virtual str_hash address() const noexcept = 0;
         virtual void wait(deferrer& deferrer) const noexcept = 0;
+    private:
+        deferrer::task_context context_;
     };
 
     template < typename Asset >
@@ -47,7 +57,10 @@ namespace e2d
         using ptr = intrusive_ptr<typed_loading_asset>;
         using promise_type = typename Asset::load_async_result;
     public:
-        typed_loading_asset(str_hash address, promise_type promise);
+        typed_loading_asset(
+            str_hash address,
+            promise_type promise,
+            const deferrer::task_context& requester);
         ~typed_loading_asset() noexcept override = default;
 
         void cancel() noexcept override;
@@ -70,11 +83,32 @@ namespace e2d
         ~library() noexcept final;
 
         const url& root() const noexcept;
+        asset_cache& cache() noexcept;
         const asset_cache& cache() const noexcept;
 
         std::size_t unload_unused_assets() noexcept;
         std::size_t loading_asset_count() const noexcept;
 
+        // asset types and the manifest must be set up before loading,
+        // dependencies are prefetched only for registered types
+        template < typename Asset >
+        library& register_asset_type();
+
+        // placeholders stand in for assets while they are streaming,
+        // each streaming asset gets its own copy of the content
+        template < typename Asset >
+        library& register_placeholder(typename Asset::content_type content);
+
+        template < typename Asset >
+        bool has_placeholder() const noexcept;
+
+        library& manifest(asset_manifest manifest) noexcept;
+        const asset_manifest& manifest() const noexcept;
+        bool load_manifest(str_view address);
+
+        // true when the cooked form exists and isn't older than the source
+        bool is_cooked_asset_actual(str_view address, str_view cooked_address) const;
+
         template < typename Asset >
         typename Asset::load_result load_main_asset(str_view address) const;
 
@@ -86,17 +120,65 @@ namespace e2d
 
         template < typename Asset, typename Nested = Asset >
         typename Nested::load_async_result load_asset_async(str_view address) const;
-    private:
+
+        // dependency loads inherit the priority and the token of the load,
+        // a cancelled load is rejected and its pending reads and decoding
+        // are dropped. requests of an in-flight load join it, the load is
+        // cancelled when all of them are and raised to the highest priority
         template < typename Asset >
-        vector<loading_asset_iptr>::iterator
-        find_loading_asset_iter_(str_hash address) const noexcept;
+        typename Asset::load_async_result load_main_asset_async(
+            str_view address,
+            stdex::jobber_priority priority,
+            const cancellation_token& token = cancellation_token::none()) const;
 
+        template < typename Asset, typename Nested = Asset >
+        typename Nested::load_async_result load_asset_async(
+            str_view address,
+            stdex::jobber_priority priority,
+            const cancellation_token& token = cancellation_token::none()) const;
+
+        // never blocks, returns the loaded asset or starts the load and returns
+        // a placeholder that is filled with the loaded content by 'fill_streamed_assets',
+        // returns nullptr if there is no placeholder for the asset type. dependencies
+        // of the load are streamed too, a failed load keeps its placeholder
         template < typename Asset >
-        typename typed_loading_asset<Asset>::ptr
-        find_loading_asset_(str_hash address) const noexcept;
+        typename Asset::load_result stream_main_asset(str_view address) const;
+
+        // fills placeholders of loaded streaming assets and caches them instead
+        // of the loaded copies, must be called when no systems read the assets
+        std::size_t fill_streamed_assets();
+
+        // dependencies with placeholders are streamed instead of waited for,
+        // so the asset (a prefab for example) is ready as soon as its own data is
+        template < typename Asset, typename Nested = Asset >
+        typename Nested::load_async_result stream_asset_async(str_view address) const;
 
+        // for asset loaders: streams the dependency when the load is streamed
+        // and the dependency has a placeholder, otherwise loads it
+        template < typename Asset, typename Nested = Asset >
+        typename Nested::load_async_result load_dependency_async(str_view address) const;
+    private:
         template < typename Asset >
-        void remove_loading_asset_(str_hash address) const noexcept;
+        typename Asset::load_async_result load_main_asset_async_(
+            str_view address,
+            bool prefetch_dependencies) const;
+
+        template < typename Asset >
+        static void prefetch_asset_(const library& library, str_view address);
+        void prefetch_dependencies_(str_view address) const noexcept;
+    private:
+        // in-flight loads, lock-striped like the asset cache,
+        // a shard lock is never held while an asset is loading
+        struct loading_shard {
+            std::mutex mutex;
+            hash_map<typed_asset_address, loading_asset_iptr, typed_asset_address_hash> assets;
+        };
+        static constexpr std::size_t loading_shard_count = asset_cache::shard_count;
+
+        loading_shard& loading_shard_(const typed_asset_address& key) const noexcept;
+        void remove_loading_asset_(
+            const typed_asset_address& key,
+            const loading_asset_iptr& asset) const noexcept;
 
         void wait_all_loading_assets_() noexcept;
     private:
@@ -105,8 +187,22 @@ namespace e2d
         std::atomic<bool> cancelled_{false};
     private:
         mutable asset_cache cache_;
-        mutable std::recursive_mutex mutex_;
-        mutable vector<loading_asset_iptr> loading_assets_;
+        mutable std::array<loading_shard, loading_shard_count> loading_shards_;
+    private:
+        using asset_prefetcher = void(*)(const library&, str_view);
+        asset_manifest manifest_;
+        hash_map<str_hash, asset_prefetcher> asset_prefetchers_;
+    private:
+        // placeholders of streaming assets, shared with the load
+        // continuations that can outlive the library
+        struct streaming_state {
+            std::mutex mutex;
+            hash_map<typed_asset_address, asset_ptr, typed_asset_address_hash> assets;
+            vector<std::function<void(asset_cache&)>> fills;
+        };
+        using placeholder_creator = std::function<asset_ptr()>;
+        hash_map<utils::type_family_id, placeholder_creator> placeholders_;
+        std::shared_ptr<streaming_state> streaming_{std::make_shared<streaming_state>()};
     };
 
     //
@@ -163,6 +259,8 @@ namespace e2d
         stdex::promise<asset_ptr> load_async(const library& library) override;
     private:
         str main_address_;
+        // nested assets can't be found in placeholders
+        bool streamable_{false};
     };
 
     //
@@ -14,9 +14,32 @@ namespace e2d
     // loading_asset
     //
 
+    inline loading_asset::loading_asset(const deferrer::task_context& requester)
+    : context_(requester) {
+        context_.token = cancellation_token::all_of(requester.token);
+        context_.raised_priority = std::make_shared<std::atomic<stdex::jobber_priority>>(
+            requester.current_priority());
+    }
+
+    inline bool loading_asset::join(const deferrer::task_context& requester) {
+        if ( !context_.token.join(requester.token) ) {
+            return false;
+        }
+        context_.raise_priority(requester.current_priority());
+        return true;
+    }
+
+    inline const deferrer::task_context& loading_asset::context() const noexcept {
+        return context_;
+    }
+
     template < typename Asset >
-    typed_loading_asset<Asset>::typed_loading_asset(str_hash address, promise_type promise)
-    : address_(address)
+    typed_loading_asset<Asset>::typed_loading_asset(
+        str_hash address,
+        promise_type promise,
+        const deferrer::task_context& requester)
+    : loading_asset(requester)
+    , address_(address)
     , promise_(std::move(promise)) {}
 
     template < typename Asset >
@@ -57,6 +80,10 @@ namespace e2d
         return root_;
     }
 
+    inline asset_cache& library::cache() noexcept {
+        return cache_;
+    }
+
     inline const asset_cache& library::cache() const noexcept {
         return cache_;
     }
@@ -66,8 +93,66 @@ namespace e2d
     }
 
     inline std::size_t library::loading_asset_count() const noexcept {
-        std::lock_guard<std::recursive_mutex> guard(mutex_);
-        return loading_assets_.size();
+        std::size_t result = 0u;
+        for ( loading_shard& s : loading_shards_ ) {
+            std::lock_guard<std::mutex> guard(s.mutex);
+            result += s.assets.size();
+        }
+        return result;
+    }
+
+    template < typename Asset >
+    library& library::register_asset_type() {
+        asset_prefetchers_[make_hash(Asset::type_name())] = &prefetch_asset_<Asset>;
+        return *this;
+    }
+
+    template < typename Asset >
+    library& library::register_placeholder(typename Asset::content_type content) {
+        placeholders_[utils::type_family<Asset>::id()] = [content = std::move(content)](){
+            return asset_ptr(Asset::create(content));
+        };
+        return *this;
+    }
+
+    template < typename Asset >
+    bool library::has_placeholder() const noexcept {
+        return placeholders_.count(utils::type_family<Asset>::id()) > 0u;
+    }
+
+    inline library& library::manifest(asset_manifest manifest) noexcept {
+        manifest_ = std::move(manifest);
+        return *this;
+    }
+
+    inline const asset_manifest& library::manifest() const noexcept {
+        return manifest_;
+    }
+
+    inline bool library::load_manifest(str_view address) {
+        const url manifest_url = root_ / address;
+        asset_manifest new_manifest;
+        if ( !asset_manifests::try_load_manifest(new_manifest, the<vfs>().read(manifest_url)) ) {
+            the<debug>().error("LIBRARY: Failed to load asset manifest:\n"
+                "--> Url: %0",
+                manifest_url);
+            return false;
+        }
+        manifest_ = std::move(new_manifest);
+        return true;
+    }
+
+    inline bool library::is_cooked_asset_actual(
+        str_view address,
+        str_view cooked_address) const
+    {
+        microseconds<u64> cooked_time;
+        if ( !the<vfs>().write_time(root_ / cooked_address, cooked_time) ) {
+            return false;
+        }
+        microseconds<u64> source_time;
+        return !the<vfs>().write_time(root_ / address, source_time)
+            || cooked_time >= source_time;
     }
 
     template < typename Asset >
@@ -79,43 +164,121 @@ namespace e2d
 
     template < typename Asset >
     typename Asset::load_async_result library::load_main_asset_async(str_view address) const {
+        return load_main_asset_async_<Asset>(address, true);
+    }
+
+    template < typename Asset >
+    typename Asset::load_async_result library::load_main_asset_async(
+        str_view address,
+        stdex::jobber_priority priority,
+        const cancellation_token& token) const
+    {
+        deferrer::context_scope scope({priority, token});
+        return load_main_asset_async<Asset>(address);
+    }
+
+    template < typename Asset >
+    typename Asset::load_async_result library::load_main_asset_async_(
+        str_view address,
+        bool prefetch_dependencies) const
+    {
         const str main_address = address::parent(address);
         const str_hash main_address_hash = make_hash(main_address);
 
-        std::lock_guard<std::recursive_mutex> guard(mutex_);
-
         if ( cancelled_ ) {
             return stdex::make_rejected_promise<typename Asset::load_result>(library_cancelled_exception());
         }
 
+        if ( deferrer::current_context().token.cancelled() ) {
+            return stdex::make_rejected_promise<typename Asset::load_result>(deferrer_cancelled_exception());
+        }
+
         if ( auto cached_asset = cache_.find<Asset>(main_address_hash) ) {
             return stdex::make_resolved_promise(std::move(cached_asset));
         }
 
-        if ( auto asset = find_loading_asset_<Asset>(main_address_hash) )  {
-            return asset->promise();
+        const typed_asset_address key{utils::type_family<Asset>::id(), main_address_hash};
+        typename Asset::load_async_result result;
+        loading_asset_iptr loading;
+        {
+            loading_shard& s = loading_shard_(key);
+            std::lock_guard<std::mutex> guard(s.mutex);
+
+            // the load could be finished before the shard was locked
+            if ( auto cached_asset = cache_.peek<Asset>(main_address_hash) ) {
+                return stdex::make_resolved_promise(std::move(cached_asset));
+            }
+
+            // joining requesters share the running load, it's started
+            // again if all of the previous ones cancelled it already
+            const auto iter = s.assets.find(key);
+            if ( iter != s.assets.end() && iter->second->join(deferrer::current_context()) ) {
+                return static_pointer_cast<typed_loading_asset<Asset>>(iter->second)->promise();
+            }
+
+            loading = new typed_loading_asset<Asset>(
+                main_address_hash,
+                result,
+                deferrer::current_context());
+            s.assets[key] = loading;
         }
 
-        auto p = Asset::load_async(*this, main_address)
-        .then([
+        // the load span lasts until the asset is ready, stages and
+        // dependency loads started from here become its children
+        tracer::span trace_span = tracer::begin_span(
+            Asset::type_name(), "load", main_address);
+
+        typename Asset::load_async_result p;
+        try {
+            deferrer::task_context context = loading->context();
+            context.trace_span = trace_span.id ? trace_span.id : context.trace_span;
+            deferrer::context_scope scope(std::move(context));
+
+            // starts all transitive dependencies at once instead of
+            // discovering them level by level while parsing
+            if ( prefetch_dependencies ) {
+                prefetch_dependencies_(main_address);
+            }
+
+            p = Asset::load_async(*this, main_address);
+        } catch (...) {
+            remove_loading_asset_(key, loading);
+            result.reject(std::current_exception());
+            throw;
+        }
+
+        p.then([
             this,
-            main_address_hash
-        ](const typename Asset::load_result& new_asset){
-            std::lock_guard<std::recursive_mutex> guard(mutex_);
-            cache_.store<Asset>(main_address_hash, new_asset);
-            remove_loading_asset_<Asset>(main_address_hash);
-            return new_asset;
+            key,
+            result,
+            loading,
+            trace_span
+        ](const typename Asset::load_result& new_asset) mutable {
+            {
+                loading_shard& s = loading_shard_(key);
+                std::lock_guard<std::mutex> guard(s.mutex);
+                cache_.store<Asset>(key.address, new_asset);
+                const auto iter = s.assets.find(key);
+                if ( iter != s.assets.end() && iter->second == loading ) {
+                    s.assets.erase(iter);
+                }
+            }
+            tracer::end_span(std::move(trace_span));
+            result.resolve(new_asset);
         }).except([
             this,
+            key,
+            result,
+            loading,
             main_address,
-            main_address_hash
-        ](std::exception_ptr e) -> typename Asset::load_result {
-            {
-                std::lock_guard<std::recursive_mutex> guard(mutex_);
-                remove_loading_asset_<Asset>(main_address_hash);
-            }
+            trace_span
+        ](std::exception_ptr e) mutable {
+            remove_loading_asset_(key, loading);
+            tracer::end_span(std::move(trace_span));
             try {
                 std::rethrow_exception(e);
+            } catch ( const deferrer_cancelled_exception& ) {
+                // cancelled by the caller, not an error
             } catch ( const std::exception& ee ) {
                 the<debug>().error("LIBRARY: Failed to load asset:\n"
                     "--> Asset: %0\n"
@@ -132,15 +295,10 @@ namespace e2d
                     Asset::type_name(),
                     main_address);
             }
-            std::rethrow_exception(e);
+            result.reject(e);
         });
 
-        const auto zero_us = time::to_chrono(make_microseconds(0));
-        if ( p.wait_for(zero_us) == stdex::promise_wait_status::timeout ) {
-            loading_assets_.push_back(new typed_loading_asset<Asset>(main_address_hash, p));
-        }
-
-        return p;
+        return result;
     }
 
     template < typename Asset, typename Nested >
@@ -174,42 +332,187 @@ namespace e2d
         });
     }
 
+    template < typename Asset, typename Nested >
+    typename Nested::load_async_result library::load_asset_async(
+        str_view address,
+        stdex::jobber_priority priority,
+        const cancellation_token& token) const
+    {
+        deferrer::context_scope scope({priority, token});
+        return load_asset_async<Asset, Nested>(address);
+    }
+
     template < typename Asset >
-    vector<loading_asset_iptr>::iterator
-    library::find_loading_asset_iter_(str_hash address) const noexcept {
-        return std::find_if(
-            loading_assets_.begin(), loading_assets_.end(),
-            [address](const loading_asset_iptr& asset) noexcept {
-                return asset->address() == address
-                    && dynamic_pointer_cast<typed_loading_asset<Asset>>(asset);
+    typename Asset::load_result library::stream_main_asset(str_view address) const {
+        const str main_address = address::parent(address);
+        const str_hash main_address_hash = make_hash(main_address);
+        const typed_asset_address key{utils::type_family<Asset>::id(), main_address_hash};
+
+        // loaded placeholders are kept until they are filled,
+        // so all users share one object with the cached asset
+        {
+            std::lock_guard<std::mutex> guard(streaming_->mutex);
+            const auto iter = streaming_->assets.find(key);
+            if ( iter != streaming_->assets.end() ) {
+                return static_pointer_cast<Asset>(iter->second);
+            }
+        }
+
+        if ( auto cached_asset = cache_.find<Asset>(main_address_hash) ) {
+            return cached_asset;
+        }
+
+        const auto placeholder_iter = placeholders_.find(utils::type_family<Asset>::id());
+        if ( placeholder_iter == placeholders_.end() ) {
+            return nullptr;
+        }
+
+        typename Asset::load_result placeholder;
+        {
+            std::lock_guard<std::mutex> guard(streaming_->mutex);
+            const auto iter = streaming_->assets.find(key);
+            if ( iter != streaming_->assets.end() ) {
+                return static_pointer_cast<Asset>(iter->second);
+            }
+            placeholder = static_pointer_cast<Asset>(placeholder_iter->second());
+            streaming_->assets.emplace(key, placeholder);
+        }
+
+        // dependencies of the real content are streamed as well,
+        // so it is filled as soon as its own data is loaded
+        deferrer::task_context context = deferrer::current_context();
+        context.streaming = true;
+        deferrer::context_scope scope(std::move(context));
+
+        load_main_asset_async<Asset>(main_address)
+        .then([
+            streaming = streaming_,
+            key,
+            placeholder
+        ](const typename Asset::load_result& new_asset){
+            // systems can read the placeholder content at any time
+            // until the frame point where the fills are applied
+            std::lock_guard<std::mutex> guard(streaming->mutex);
+            streaming->fills.push_back([
+                streaming_ptr = streaming.get(),
+                key,
+                placeholder,
+                new_asset
+            ](asset_cache& cache){
+                placeholder->fill_from(*new_asset);
+                cache.store<Asset>(key.address, placeholder);
+                streaming_ptr->assets.erase(key);
             });
+        }).except([](std::exception_ptr){
+            // the failed load is already reported, the placeholder
+            // stays in the streaming assets, so it is not loaded again
+        });
+
+        return placeholder;
     }
 
-    template < typename Asset >
-    typename typed_loading_asset<Asset>::ptr
-    library::find_loading_asset_(str_hash address) const noexcept {
-        auto iter = find_loading_asset_iter_<Asset>(address);
-        return iter != loading_assets_.end()
-            ? static_pointer_cast<typed_loading_asset<Asset>>(*iter)
-            : nullptr;
+    inline std::size_t library::fill_streamed_assets() {
+        std::lock_guard<std::mutex> guard(streaming_->mutex);
+        const std::size_t filled = streaming_->fills.size();
+        for ( const auto& fill : streaming_->fills ) {
+            fill(cache_);
+        }
+        streaming_->fills.clear();
+        return filled;
+    }
+
+    template < typename Asset, typename Nested >
+    typename Nested::load_async_result library::stream_asset_async(str_view address) const {
+        deferrer::task_context context = deferrer::current_context();
+        context.streaming = true;
+        deferrer::context_scope scope(std::move(context));
+        return load_asset_async<Asset, Nested>(address);
+    }
+
+    template < typename Asset, typename Nested >
+    typename Nested::load_async_result library::load_dependency_async(str_view address) const {
+        // nested assets can't be found in placeholders
+        if ( deferrer::current_context().streaming && address::nested(address).empty() ) {
+            if ( auto main_asset = stream_main_asset<Asset>(address) ) {
+                if ( auto nested_asset = dynamic_pointer_cast<Nested>(main_asset) ) {
+                    return stdex::make_resolved_promise(std::move(nested_asset));
+                }
+            }
+        }
+        return load_asset_async<Asset, Nested>(address);
     }
 
     template < typename Asset >
-    void library::remove_loading_asset_(str_hash address) const noexcept {
-        auto iter = find_loading_asset_iter_<Asset>(address);
-        if ( iter != loading_assets_.end() ) {
-            loading_assets_.erase(iter);
+    void library::prefetch_asset_(const library& library, str_view address) {
+        // dependencies of dependencies are in the same manifest entry
+        library.load_main_asset_async_<Asset>(address, false);
+    }
+
+    inline void library::prefetch_dependencies_(str_view address) const noexcept {
+        if ( manifest_.empty() ) {
+            return;
+        }
+        // manifest addresses are normalized by the cooker
+        const asset_manifest::entry* entry = nullptr;
+        try {
+            entry = manifest_.find_entry(make_hash(path::normalize(address)));
+        } catch (...) {
+            return;
+        }
+        if ( !entry ) {
+            return;
+        }
+        for ( const str& dependency : entry->dependencies ) {
+            const asset_manifest::entry* dependency_entry =
+                manifest_.find_entry(make_hash(dependency));
+            if ( !dependency_entry ) {
+                continue;
+            }
+            const auto iter = asset_prefetchers_.find(make_hash(dependency_entry->type));
+            if ( iter == asset_prefetchers_.end() ) {
+                continue;
+            }
+            try {
+                iter->second(*this, dependency);
+            } catch (...) {
+                // the regular load of the dependency reports it
+            }
+        }
+    }
+
+    inline library::loading_shard& library::loading_shard_(
+        const typed_asset_address& key) const noexcept
+    {
+        return loading_shards_[key.hash() % loading_shard_count];
+    }
+
+    inline void library::remove_loading_asset_(
+        const typed_asset_address& key,
+        const loading_asset_iptr& asset) const noexcept
+    {
+        // the load could be replaced by a new one after its cancellation
+        loading_shard& s = loading_shard_(key);
+        std::lock_guard<std::mutex> guard(s.mutex);
+        const auto iter = s.assets.find(key);
+        if ( iter != s.assets.end() && iter->second == asset ) {
+            s.assets.erase(iter);
         }
     }
 
     inline void library::wait_all_loading_assets_() noexcept {
         while ( true ) {
-            std::unique_lock<std::recursive_mutex> lock(mutex_);
-            if ( loading_assets_.empty() ) {
+            // a waited load can start new ones in any shard
+            loading_asset_iptr loading_asset_copy;
+            for ( loading_shard& s : loading_shards_ ) {
+                std::lock_guard<std::mutex> guard(s.mutex);
+                if ( !s.assets.empty() ) {
+                    loading_asset_copy = s.assets.begin()->second;
+                    break;
+                }
+            }
+            if ( !loading_asset_copy ) {
                 break;
             }
-            const auto loading_asset_copy = loading_assets_.back();
-            lock.unlock();
             loading_asset_copy->wait(deferrer_);
         }
     }
@@ -264,7 +567,8 @@ namespace e2d
 
     template < typename Asset >
     typed_asset_dependency<Asset>::typed_asset_dependency(str_view address)
-    : main_address_(address::parent(address)) {}
+    : main_address_(address::parent(address))
+    , streamable_(address::nested(address).empty()) {}
 
     template < typename Asset >
     typed_asset_dependency<Asset>::~typed_asset_dependency() noexcept = default;
@@ -276,8 +580,10 @@ namespace e2d
 
     template < typename Asset >
     stdex::promise<asset_ptr> typed_asset_dependency<Asset>::load_async(const library& library) {
-        return library.load_main_asset_async<Asset>(main_address_)
-        .then([](const typename Asset::load_result& main_asset){
+        auto main_asset_p = streamable_
+            ? library.load_dependency_async<Asset>(main_address_)
+            : library.load_main_asset_async<Asset>(main_address_);
+        return main_asset_p.then([](const typename Asset::load_result& main_asset){
             return asset_ptr(main_asset);
         });
     }
@@ -32,12 +32,16 @@ namespace e2d
         model& set_mesh(const mesh_asset::ptr& mesh);
         const mesh_asset::ptr& mesh() const noexcept;
 
+        // local bounds of the mesh vertices
+        const b3f& bounds() const noexcept;
+
         // It can only be called from the main thread
         void regenerate_geometry(render& render);
         const render::geometry& geometry() const noexcept;
     private:
         mesh_asset::ptr mesh_;
         render::geometry geometry_;
+        b3f bounds_;
     };
 
     void swap(model& l, model& r) noexcept;
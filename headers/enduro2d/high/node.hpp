@@ -26,6 +26,8 @@ namespace e2d
         : private noncopyable
         , public ref_counter<node>
         , public intrusive_list_hook<node_children_ilist_tag> {
+    public:
+        class read_scope;
     public:
         virtual ~node() noexcept;
 
@@ -35,6 +37,20 @@ namespace e2d
         static node_iptr create(const gobject_iptr& owner);
         static node_iptr create(const gobject_iptr& owner, const node_iptr& parent);
 
+        static void* operator new(std::size_t size);
+        static void operator delete(void* ptr) noexcept;
+
+        // appends owners of nodes created, moved, reparented or resized
+        // since the previous call, a node stands for its whole subtree,
+        // returns false if changes were lost and all nodes are suspect
+        static bool extract_changed_owners(vector<ecs::entity_id>& owners);
+
+        // owners of nodes moved in the step with their transforms before
+        // the first move, nodes created in the step are not recorded,
+        // returns false if moves were lost
+        static void begin_transform_step();
+        static bool end_transform_step(vector<std::pair<ecs::entity_id, t3f>>& previous);
+
         void owner(const gobject_iptr& owner) noexcept;
 
         gobject_iptr owner() noexcept;
@@ -55,6 +71,22 @@ namespace e2d
         const m4f& local_matrix() const noexcept;
         const m4f& world_matrix() const noexcept;
 
+        void local_bounds(const b3f& bounds) noexcept;
+        const b3f& local_bounds() const noexcept;
+
+        bool has_local_bounds() const noexcept;
+        bool reset_local_bounds() noexcept;
+
+        // local bounds of the node itself in world space
+        b3f local_bounds_in_world() const noexcept;
+
+        // changes whenever 'local_bounds_in_world' may change
+        u32 local_bounds_in_world_version() const noexcept;
+
+        // merged world space bounds of the node and all its descendants
+        const b3f& world_bounds() const noexcept;
+        bool has_world_bounds() const noexcept;
+
         node_iptr root() noexcept;
         const_node_iptr root() const noexcept;
 
@@ -135,22 +167,59 @@ namespace e2d
         node(const gobject_iptr& owner);
     private:
         enum flag_masks : u32 {
-            fm_dirty_local_matrix = 1u << 0,
-            fm_dirty_world_matrix = 1u << 1,
+            fm_dirty_world_bounds = 1u << 0,
+            fm_has_local_bounds = 1u << 1,
+            fm_has_world_bounds = 1u << 2,
         };
+        void mark_moved_() noexcept;
+        void mark_changed_() noexcept;
+        void mark_changed_subtree_() noexcept;
         void mark_dirty_local_matrix_() noexcept;
         void mark_dirty_world_matrix_() noexcept;
+        void mark_dirty_world_bounds_() noexcept;
         void update_local_matrix_() const noexcept;
         void update_world_matrix_() const noexcept;
+        void update_world_bounds_() const noexcept;
     private:
         t3f transform_;
         gobject_iptr owner_;
         node* parent_{nullptr};
         node_children children_;
+        b3f local_bounds_;
+        u32 local_version_{0u};
+        u32 local_bounds_version_{0u};
+        u32 change_generation_{0u};
+        u32 step_generation_{0u};
     private:
         mutable u32 flags_{0u};
+        mutable u32 world_version_{0u};
+        mutable u32 world_local_version_{0u};
+        mutable u32 world_parent_version_{0u};
+        mutable u32 local_matrix_version_{0u};
+        mutable u32 world_bounds_version_{0u};
+        mutable u32 read_stamp_{0u};
         mutable m4f local_matrix_;
         mutable m4f world_matrix_;
+        mutable b3f world_bounds_;
+    };
+}
+
+namespace e2d
+{
+    //
+    // node::read_scope
+    //
+    // Marks a part of the frame where transforms are only read, like
+    // the render section. A world matrix validated once in the scope
+    // is returned as is, a change in the scope invalidates them all.
+    //
+
+    class node::read_scope final : private noncopyable {
+    public:
+        read_scope() noexcept;
+        ~read_scope() noexcept;
+    private:
+        u32 prev_stamp_{0u};
     };
 }
 
@@ -0,0 +1,78 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include "_high.hpp"
+
+namespace e2d
+{
+    //
+    // sorted_components
+    //
+    // Entities sorted by the component depth. The order is rebuilt
+    // only when a component was added, removed or changed its depth,
+    // or when a cached entity was destroyed and its slot reused.
+    //
+
+    template < typename T >
+    class sorted_components final {
+    public:
+        void update(const ecs::registry& owner) {
+            if ( !is_actual_(owner) ) {
+                rebuild_(owner);
+            }
+        }
+
+        template < typename F >
+        void for_each(const ecs::registry& owner, F&& f) const {
+            for ( const entry& e : entries_ ) {
+                const ecs::const_entity ent(owner, e.id);
+                f(ent, *owner.find_component<T>(ent));
+            }
+        }
+
+        std::size_t size() const noexcept {
+            return entries_.size();
+        }
+    private:
+        bool is_actual_(const ecs::registry& owner) const noexcept {
+            if ( owner.component_count<T>() != entries_.size() ) {
+                return false;
+            }
+            for ( const entry& e : entries_ ) {
+                if ( !owner.valid_entity(e.id) ) {
+                    return false;
+                }
+                const T* t = owner.find_component<T>(ecs::const_entity(owner, e.id));
+                if ( !t || t->depth() != e.depth ) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        void rebuild_(const ecs::registry& owner) {
+            entries_.clear();
+            entries_.reserve(owner.component_count<T>());
+            owner.for_each_component<T>([this](const ecs::const_entity& e, const T& t){
+                entries_.push_back({e.id(), t.depth()});
+            });
+            std::stable_sort(
+                entries_.begin(),
+                entries_.end(),
+                [](const entry& l, const entry& r) noexcept {
+                    return l.depth < r.depth;
+                });
+        }
+    private:
+        struct entry {
+            ecs::entity_id id;
+            i32 depth;
+        };
+        vector<entry> entries_;
+    };
+}
@@ -0,0 +1,100 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include "_high.hpp"
+
+namespace e2d
+{
+    //
+    // spatial_index
+    //
+    // Dynamic AABB tree keyed by entity. Leaves keep fattened bounds,
+    // so small moves do not touch the tree structure. Queries test
+    // the exact bounds and write matched keys to the output iterator.
+    //
+
+    class spatial_index final : private noncopyable {
+    public:
+        using key_type = ecs::entity_id;
+        static constexpr f32 default_margin = 1.f;
+    public:
+        explicit spatial_index(f32 margin = default_margin);
+        ~spatial_index() noexcept;
+
+        // returns true if the tree structure was changed
+        bool update(key_type key, const b3f& bounds);
+        bool remove(key_type key) noexcept;
+        void clear() noexcept;
+
+        bool has(key_type key) const noexcept;
+        bool find_bounds(key_type key, b3f& bounds) const noexcept;
+
+        f32 margin() const noexcept;
+        std::size_t size() const noexcept;
+        std::size_t height() const noexcept;
+
+        template < typename Iter >
+        std::size_t query_point(const v3f& point, Iter iter) const;
+
+        template < typename Iter >
+        std::size_t query_bounds(const b3f& bounds, Iter iter) const;
+
+        // z axis is ignored
+        template < typename Iter >
+        std::size_t query_rect(const b2f& rect, Iter iter) const;
+
+        template < typename Iter >
+        std::size_t query_ray(
+            const v3f& origin,
+            const v3f& direction,
+            f32 max_distance,
+            Iter iter) const;
+
+        template < typename Iter >
+        std::size_t query_frustum(const m4f& view_proj, Iter iter) const;
+    private:
+        using index_type = u32;
+        static constexpr index_type null_index = ~index_type(0);
+        static constexpr std::size_t max_query_depth = 64u;
+
+        struct tree_node {
+            v3f min;
+            v3f max;
+            v3f tight_min;
+            v3f tight_max;
+            key_type key{0u};
+            index_type parent{null_index};
+            index_type child1{null_index};
+            index_type child2{null_index};
+            i32 height{-1};
+
+            bool is_leaf() const noexcept {
+                return child1 == null_index;
+            }
+        };
+
+        template < typename Pred, typename Iter >
+        std::size_t query_(Pred&& pred, Iter iter) const;
+
+        index_type allocate_node_();
+        void free_node_(index_type index) noexcept;
+
+        void insert_leaf_(index_type leaf);
+        void remove_leaf_(index_type leaf) noexcept;
+        index_type balance_(index_type index) noexcept;
+        void refit_(index_type index) noexcept;
+    private:
+        f32 margin_{default_margin};
+        index_type root_{null_index};
+        index_type free_list_{null_index};
+        vector<tree_node> nodes_;
+        hash_map<key_type, index_type> leaves_;
+    };
+}
+
+#include "spatial_index.inl"
@@ -0,0 +1,119 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include "spatial_index.hpp"
+
+namespace e2d
+{
+    template < typename Iter >
+    std::size_t spatial_index::query_point(const v3f& point, Iter iter) const {
+        return query_([&point](const v3f& min, const v3f& max) noexcept {
+            return point.x >= min.x && point.x <= max.x
+                && point.y >= min.y && point.y <= max.y
+                && point.z >= min.z && point.z <= max.z;
+        }, iter);
+    }
+
+    template < typename Iter >
+    std::size_t spatial_index::query_bounds(const b3f& bounds, Iter iter) const {
+        const v3f b_min = math::minimum(bounds);
+        const v3f b_max = math::maximum(bounds);
+        return query_([&b_min, &b_max](const v3f& min, const v3f& max) noexcept {
+            return b_min.x <= max.x && b_max.x >= min.x
+                && b_min.y <= max.y && b_max.y >= min.y
+                && b_min.z <= max.z && b_max.z >= min.z;
+        }, iter);
+    }
+
+    template < typename Iter >
+    std::size_t spatial_index::query_rect(const b2f& rect, Iter iter) const {
+        const v2f r_min = math::minimum(rect);
+        const v2f r_max = math::maximum(rect);
+        return query_([&r_min, &r_max](const v3f& min, const v3f& max) noexcept {
+            return r_min.x <= max.x && r_max.x >= min.x
+                && r_min.y <= max.y && r_max.y >= min.y;
+        }, iter);
+    }
+
+    template < typename Iter >
+    std::size_t spatial_index::query_ray(
+        const v3f& origin,
+        const v3f& direction,
+        f32 max_distance,
+        Iter iter) const
+    {
+        const v3f inv_dir{
+            1.f / direction.x,
+            1.f / direction.y,
+            1.f / direction.z};
+        return query_([&origin, &direction, &inv_dir, max_distance](
+            const v3f& min,
+            const v3f& max) noexcept
+        {
+            f32 t_min = 0.f;
+            f32 t_max = max_distance;
+            for ( std::size_t i = 0; i < 3; ++i ) {
+                if ( math::is_near_zero(direction[i]) ) {
+                    if ( origin[i] < min[i] || origin[i] > max[i] ) {
+                        return false;
+                    }
+                    continue;
+                }
+                f32 t1 = (min[i] - origin[i]) * inv_dir[i];
+                f32 t2 = (max[i] - origin[i]) * inv_dir[i];
+                if ( t1 > t2 ) {
+                    std::swap(t1, t2);
+                }
+                t_min = math::max(t_min, t1);
+                t_max = math::min(t_max, t2);
+                if ( t_min > t_max ) {
+                    return false;
+                }
+            }
+            return true;
+        }, iter);
+    }
+
+    template < typename Iter >
+    std::size_t spatial_index::query_frustum(const m4f& view_proj, Iter iter) const {
+        return query_([&view_proj](const v3f& min, const v3f& max) noexcept {
+            return math::overlaps_frustum(math::make_minmax_aabb(min, max), view_proj);
+        }, iter);
+    }
+
+    template < typename Pred, typename Iter >
+    std::size_t spatial_index::query_(Pred&& pred, Iter iter) const {
+        if ( root_ == null_index ) {
+            return 0u;
+        }
+
+        std::size_t count{0u};
+        std::size_t stack_size{0u};
+        std::array<index_type, max_query_depth> stack;
+        stack[stack_size++] = root_;
+
+        while ( stack_size > 0u ) {
+            const tree_node& n = nodes_[stack[--stack_size]];
+            if ( !pred(n.min, n.max) ) {
+                continue;
+            }
+            if ( n.is_leaf() ) {
+                if ( pred(n.tight_min, n.tight_max) ) {
+                    iter++ = n.key;
+                    ++count;
+                }
+            } else {
+                E2D_ASSERT(stack_size + 2u <= stack.size());
+                stack[stack_size++] = n.child1;
+                stack[stack_size++] = n.child2;
+            }
+        }
+
+        return count;
+    }
+}
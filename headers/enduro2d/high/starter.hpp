@@ -27,6 +27,10 @@ namespace e2d
         template < typename HighApplication, typename... Args >
         bool start(Args&&... args);
         bool start(application_uptr app);
+    private:
+        url profile_dump_;
+        url load_trace_dump_;
+        microseconds<u64> asset_eviction_slice_;
     };
 
     //
@@ -51,15 +55,50 @@ namespace e2d
         parameters(const engine::parameters& engine_params);
 
         parameters& library_root(const url& value);
+        parameters& library_manifest(str_view value);
+        parameters& image_cache_root(const url& value);
+        parameters& profile_dump(const url& value);
+        parameters& load_trace_dump(const url& value);
+        parameters& asset_memory_budget(std::size_t value) noexcept;
+        parameters& image_cache_capacity(std::size_t value) noexcept;
+        parameters& asset_eviction_slice(const microseconds<u64>& value) noexcept;
         parameters& engine_params(const engine::parameters& value);
 
         url& library_root() noexcept;
+        str& library_manifest() noexcept;
+        url& image_cache_root() noexcept;
+        url& profile_dump() noexcept;
+        url& load_trace_dump() noexcept;
+        std::size_t& asset_memory_budget() noexcept;
+        std::size_t& image_cache_capacity() noexcept;
+        microseconds<u64>& asset_eviction_slice() noexcept;
         engine::parameters& engine_params() noexcept;
 
         const url& library_root() const noexcept;
+        const str& library_manifest() const noexcept;
+        const url& image_cache_root() const noexcept;
+        const url& profile_dump() const noexcept;
+        const url& load_trace_dump() const noexcept;
+        const std::size_t& asset_memory_budget() const noexcept;
+        const std::size_t& image_cache_capacity() const noexcept;
+        const microseconds<u64>& asset_eviction_slice() const noexcept;
         const engine::parameters& engine_params() const noexcept;
     private:
         url library_root_{"resources://bin/library"};
+        // address of the asset manifest in the library, empty to disable
+        str library_manifest_;
+        // decoded images are kept here between launches, empty to disable
+        url image_cache_root_;
+        // least recently used images are removed over this size
+        std::size_t image_cache_capacity_{256u * 1024u * 1024u};
+        // writes per-system timings on shutdown, empty to disable
+        url profile_dump_;
+        // writes asset loading spans in chrome trace format on shutdown, empty to disable
+        url load_trace_dump_;
+        // unused assets are evicted over this budget, zero to disable
+        std::size_t asset_memory_budget_{0u};
+        // time for evicting unused assets per frame
+        microseconds<u64> asset_eviction_slice_{make_microseconds<u64>(500u)};
         engine::parameters engine_params_;
     };
 }
@@ -10,6 +10,7 @@
 
 #include "prefab.hpp"
 #include "gobject.hpp"
+#include "spatial_index.hpp"
 
 namespace e2d
 {
@@ -35,14 +36,76 @@ namespace e2d
         ecs::registry& registry() noexcept;
         const ecs::registry& registry() const noexcept;
 
+        slab_allocator& allocator() noexcept;
+        const slab_allocator& allocator() const noexcept;
+
+        spatial_index& spatial() noexcept;
+        const spatial_index& spatial() const noexcept;
+
+        // command buffer of the calling thread, systems record structural
+        // changes here and the starter plays them back after each section,
+        // the buffer must not be used after the next 'flush_commands' call
+        ecs::command_buffer& commands();
+
+        // destroyed instance entities go through 'destroy_instance'
+        void flush_commands();
+
         gobject_iptr instantiate();
         gobject_iptr instantiate(const prefab& prefab);
+
+        // 'instantiate' and 'destroy_instance' recorded
+        // to the command buffer of the calling thread
+        void instantiate_deferred(const prefab& prefab);
+        void destroy_instance_deferred(ecs::entity_id ent);
+
+        // instantiates 'count' copies of the prefab at once,
+        // root nodes take the given transforms when provided
+        vector<gobject_iptr> instantiate_many(const prefab& prefab, std::size_t count);
+        vector<gobject_iptr> instantiate_many(const prefab& prefab, const vector<t3f>& transforms);
+
         void destroy_instance(const gobject_iptr& inst) noexcept;
 
         gobject_iptr resolve(ecs::entity_id ent) const noexcept;
         gobject_iptr resolve(const ecs::const_entity& ent) const noexcept;
+
+        std::size_t instance_count() const noexcept;
+
+        // instances must not be created or destroyed from 'f'
+        template < typename F >
+        void for_each_instance(F&& f) const;
+    private:
+        vector<gobject_iptr> instantiate_many_(
+            const prefab& prefab,
+            std::size_t count,
+            const t3f* transforms);
+
+        std::size_t find_gobject_(ecs::entity_id ent) const noexcept;
+        void insert_gobject_(const gobject_iptr& inst);
+        void erase_gobject_(ecs::entity_id ent) noexcept;
     private:
         ecs::registry registry_;
-        hash_map<ecs::entity_id, gobject_iptr> gobjects_;
+        slab_allocator_iptr allocator_{make_intrusive<slab_allocator>()};
+        spatial_index spatial_;
+    private:
+        // dense slot map: entity index -> dense index + 1,
+        // entity ids are kept to check the entity version
+        vector<u32> gobject_slots_;
+        vector<ecs::entity_id> gobject_ids_;
+        vector<gobject_iptr> gobjects_;
+    private:
+        std::mutex commands_mutex_;
+        vector<std::pair<
+            std::thread::id,
+            std::unique_ptr<ecs::command_buffer>>> commands_;
     };
 }
+
+namespace e2d
+{
+    template < typename F >
+    void world::for_each_instance(F&& f) const {
+        for ( const gobject_iptr& inst : gobjects_ ) {
+            f(inst);
+        }
+    }
+}
@@ -9,6 +9,7 @@
 #include "_math.hpp"
 
 #include "aabb.hpp"
+#include "batch.hpp"
 #include "mat2.hpp"
 #include "mat3.hpp"
 #include "mat4.hpp"
@@ -0,0 +1,354 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include "_math.hpp"
+#include "aabb.hpp"
+#include "mat4.hpp"
+#include "rect.hpp"
+#include "vec2.hpp"
+#include "vec3.hpp"
+#include "vec4.hpp"
+
+//
+// E2D_MATH_SSE2
+//
+
+#ifndef E2D_MATH_SSE2
+#  if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define E2D_MATH_SSE2 1
+#  else
+#    define E2D_MATH_SSE2 0
+#  endif
+#endif
+
+#if E2D_MATH_SSE2
+#  include <emmintrin.h>
+#endif
+
+namespace e2d::math
+{
+    namespace impl
+    {
+        //
+        // point_transformer
+        //
+
+        template < typename T >
+        class point_transformer final {
+        public:
+            point_transformer(const mat4<T>& m) noexcept
+            : m_(m) {}
+
+            vec4<T> operator()(T x, T y, T z) const noexcept {
+                const T* const rm = m_.data();
+                return {
+                    x * rm[0] + y * rm[4] + z * rm[8]  + rm[12],
+                    x * rm[1] + y * rm[5] + z * rm[9]  + rm[13],
+                    x * rm[2] + y * rm[6] + z * rm[10] + rm[14],
+                    x * rm[3] + y * rm[7] + z * rm[11] + rm[15]};
+            }
+        private:
+            const mat4<T>& m_;
+        };
+
+    #if E2D_MATH_SSE2
+        template <>
+        class point_transformer<f32> final {
+        public:
+            point_transformer(const mat4<f32>& m) noexcept
+            : row0_(_mm_loadu_ps(m.data() + 0))
+            , row1_(_mm_loadu_ps(m.data() + 4))
+            , row2_(_mm_loadu_ps(m.data() + 8))
+            , row3_(_mm_loadu_ps(m.data() + 12)) {}
+
+            vec4<f32> operator()(f32 x, f32 y, f32 z) const noexcept {
+                const __m128 r = _mm_add_ps(
+                    _mm_add_ps(
+                        _mm_mul_ps(_mm_set1_ps(x), row0_),
+                        _mm_mul_ps(_mm_set1_ps(y), row1_)),
+                    _mm_add_ps(
+                        _mm_mul_ps(_mm_set1_ps(z), row2_),
+                        row3_));
+                vec4<f32> result;
+                _mm_storeu_ps(result.data(), r);
+                return result;
+            }
+        private:
+            __m128 row0_;
+            __m128 row1_;
+            __m128 row2_;
+            __m128 row3_;
+        };
+    #endif
+
+        //
+        // frustum_outcode
+        //
+
+        template < typename T >
+        u32 frustum_outcode(const vec4<T>& p) noexcept {
+            return (p.x < -p.w ? 0x01u : 0u)
+                 | (p.x >  p.w ? 0x02u : 0u)
+                 | (p.y < -p.w ? 0x04u : 0u)
+                 | (p.y >  p.w ? 0x08u : 0u)
+                 | (p.z < -p.w ? 0x10u : 0u)
+                 | (p.z >  p.w ? 0x20u : 0u);
+        }
+
+        template < typename T >
+        bool overlaps_frustum(
+            const vec3<T>& min,
+            const vec3<T>& max,
+            const point_transformer<T>& view_proj) noexcept
+        {
+            // rejects bounds only when all corners are
+            // outside of the same clip plane
+            u32 outside_mask = 0x3Fu;
+            for ( std::size_t i = 0; i < 8; ++i ) {
+                outside_mask &= frustum_outcode(view_proj(
+                    (i & 1u) ? max.x : min.x,
+                    (i & 2u) ? max.y : min.y,
+                    (i & 4u) ? max.z : min.z));
+            }
+            return !outside_mask;
+        }
+    }
+
+    //
+    // transform_points
+    //
+    // result[i] = points[i] * m with w = 1,
+    // 'result' may be the same array as 'points'
+    //
+
+    template < typename T >
+    void transform_points(
+        const vec3<T>* points,
+        std::size_t count,
+        const mat4<T>& m,
+        vec3<T>* result) noexcept
+    {
+        const impl::point_transformer<T> transformer(m);
+        for ( std::size_t i = 0; i < count; ++i ) {
+            const vec3<T> p = points[i];
+            result[i] = vec3<T>(transformer(p.x, p.y, p.z));
+        }
+    }
+
+    template < typename T >
+    void transform_points(
+        const vec2<T>* points,
+        std::size_t count,
+        const mat4<T>& m,
+        vec3<T>* result) noexcept
+    {
+        const impl::point_transformer<T> transformer(m);
+        for ( std::size_t i = 0; i < count; ++i ) {
+            const vec2<T> p = points[i];
+            result[i] = vec3<T>(transformer(p.x, p.y, T(0)));
+        }
+    }
+
+    template < typename T >
+    void transform_points(
+        const vec2<T>* points,
+        std::size_t count,
+        const mat4<T>& m,
+        vec2<T>* result) noexcept
+    {
+        const impl::point_transformer<T> transformer(m);
+        for ( std::size_t i = 0; i < count; ++i ) {
+            const vec2<T> p = points[i];
+            const vec4<T> r = transformer(p.x, p.y, T(0));
+            result[i] = vec2<T>(r.x, r.y);
+        }
+    }
+
+    //
+    // make_minmax_aabb/make_minmax_rect
+    //
+    // bounds of N points, zero bounds for empty input
+    //
+
+    template < typename T >
+    aabb<T> make_minmax_aabb(const vec3<T>* points, std::size_t count) noexcept {
+        if ( !count ) {
+            return aabb<T>::zero();
+        }
+        vec3<T> min = points[0];
+        vec3<T> max = points[0];
+        for ( std::size_t i = 1; i < count; ++i ) {
+            const vec3<T> p = points[i];
+            min.x = p.x < min.x ? p.x : min.x;
+            min.y = p.y < min.y ? p.y : min.y;
+            min.z = p.z < min.z ? p.z : min.z;
+            max.x = p.x > max.x ? p.x : max.x;
+            max.y = p.y > max.y ? p.y : max.y;
+            max.z = p.z > max.z ? p.z : max.z;
+        }
+        return {min, max - min};
+    }
+
+    template < typename T >
+    rect<T> make_minmax_rect(const vec2<T>* points, std::size_t count) noexcept {
+        if ( !count ) {
+            return rect<T>::zero();
+        }
+        vec2<T> min = points[0];
+        vec2<T> max = points[0];
+        for ( std::size_t i = 1; i < count; ++i ) {
+            const vec2<T> p = points[i];
+            min.x = p.x < min.x ? p.x : min.x;
+            min.y = p.y < min.y ? p.y : min.y;
+            max.x = p.x > max.x ? p.x : max.x;
+            max.y = p.y > max.y ? p.y : max.y;
+        }
+        return {min, max - min};
+    }
+
+    //
+    // transformed
+    //
+    // bounds of the transformed corners
+    //
+
+    template < typename T >
+    aabb<T> transformed(const aabb<T>& b, const mat4<T>& m) noexcept {
+        const vec3<T> min = minimum(b);
+        const vec3<T> max = maximum(b);
+        const vec3<T> corners[] = {
+            {min.x, min.y, min.z}, {max.x, min.y, min.z},
+            {min.x, max.y, min.z}, {max.x, max.y, min.z},
+            {min.x, min.y, max.z}, {max.x, min.y, max.z},
+            {min.x, max.y, max.z}, {max.x, max.y, max.z}};
+        vec3<T> result[std::size(corners)];
+        transform_points(corners, std::size(corners), m, result);
+        return make_minmax_aabb(result, std::size(result));
+    }
+
+    //
+    // merged
+    //
+    // merged bounds of N aabbs/rects, zero bounds for empty input
+    //
+
+    template < typename T >
+    aabb<T> merged(const aabb<T>* boxes, std::size_t count) noexcept {
+        if ( !count ) {
+            return aabb<T>::zero();
+        }
+        vec3<T> min = minimum(boxes[0]);
+        vec3<T> max = maximum(boxes[0]);
+        for ( std::size_t i = 1; i < count; ++i ) {
+            min = minimized(min, minimum(boxes[i]));
+            max = maximized(max, maximum(boxes[i]));
+        }
+        return make_minmax_aabb(min, max);
+    }
+
+    template < typename T >
+    rect<T> merged(const rect<T>* rects, std::size_t count) noexcept {
+        if ( !count ) {
+            return rect<T>::zero();
+        }
+        vec2<T> min = minimum(rects[0]);
+        vec2<T> max = maximum(rects[0]);
+        for ( std::size_t i = 1; i < count; ++i ) {
+            min = minimized(min, minimum(rects[i]));
+            max = maximized(max, maximum(rects[i]));
+        }
+        return make_minmax_rect(min, max);
+    }
+
+    //
+    // overlaps_frustum
+    //
+    // conservative test against the clip space of 'view_proj',
+    // batch version writes 1/0 to 'result' and returns the count of 1
+    //
+
+    template < typename T >
+    bool overlaps_frustum(const aabb<T>& b, const mat4<T>& view_proj) noexcept {
+        return impl::overlaps_frustum(
+            minimum(b),
+            maximum(b),
+            impl::point_transformer<T>(view_proj));
+    }
+
+    template < typename T >
+    std::size_t overlaps_frustum(
+        const aabb<T>* boxes,
+        std::size_t count,
+        const mat4<T>& view_proj,
+        u8* result) noexcept
+    {
+        std::size_t overlapped{0u};
+        const impl::point_transformer<T> transformer(view_proj);
+        for ( std::size_t i = 0; i < count; ++i ) {
+            const bool r = impl::overlaps_frustum(
+                minimum(boxes[i]),
+                maximum(boxes[i]),
+                transformer);
+            result[i] = r ? 1u : 0u;
+            overlapped += r ? 1u : 0u;
+        }
+        return overlapped;
+    }
+
+    //
+    // overlaps
+    //
+    // batch versions of overlaps, write 1/0 to 'result'
+    // and return the count of 1
+    //
+
+    template < typename T >
+    std::size_t overlaps(
+        const aabb<T>* boxes,
+        std::size_t count,
+        const aabb<T>& b,
+        u8* result) noexcept
+    {
+        std::size_t overlapped{0u};
+        const vec3<T> min_r = minimum(b);
+        const vec3<T> max_r = maximum(b);
+        for ( std::size_t i = 0; i < count; ++i ) {
+            const vec3<T> min_l = minimum(boxes[i]);
+            const vec3<T> max_l = maximum(boxes[i]);
+            const bool r =
+                (max_l.x > min_r.x) & (min_l.x < max_r.x) &
+                (max_l.y > min_r.y) & (min_l.y < max_r.y) &
+                (max_l.z > min_r.z) & (min_l.z < max_r.z);
+            result[i] = r ? 1u : 0u;
+            overlapped += r ? 1u : 0u;
+        }
+        return overlapped;
+    }
+
+    template < typename T >
+    std::size_t overlaps(
+        const rect<T>* rects,
+        std::size_t count,
+        const rect<T>& b,
+        u8* result) noexcept
+    {
+        std::size_t overlapped{0u};
+        const vec2<T> min_r = minimum(b);
+        const vec2<T> max_r = maximum(b);
+        for ( std::size_t i = 0; i < count; ++i ) {
+            const vec2<T> min_l = minimum(rects[i]);
+            const vec2<T> max_l = maximum(rects[i]);
+            const bool r =
+                (max_l.x > min_r.x) & (min_l.x < max_r.x) &
+                (max_l.y > min_r.y) & (min_l.y < max_r.y);
+            result[i] = r ? 1u : 0u;
+            overlapped += r ? 1u : 0u;
+        }
+        return overlapped;
+    }
+}
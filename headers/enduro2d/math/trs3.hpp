@@ -140,6 +140,23 @@ namespace e2d::math
             && math::approximately(l.scale, r.scale, precision);
     }
 
+    //
+    // lerp
+    //
+    // rotation is normalized lerp along the shortest arc
+    //
+
+    template < typename T >
+    trs3<T> lerp(const trs3<T>& l, const trs3<T>& r, T v) noexcept {
+        const quat<T> r_rotation = math::dot(l.rotation, r.rotation) < T(0)
+            ? r.rotation * T(-1)
+            : r.rotation;
+        return trs3<T>(
+            math::lerp(l.translation, r.translation, v),
+            math::normalized(math::lerp(l.rotation, r_rotation, v)),
+            math::lerp(l.scale, r.scale, v));
+    }
+
     template < typename T >
     bool contains_nan(const trs3<T>& v) noexcept {
         return contains_nan(v.translation)
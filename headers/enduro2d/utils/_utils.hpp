@@ -20,6 +20,7 @@ namespace e2d
     class image;
     class mesh;
     class shape;
+    class slab_allocator;
     class input_stream;
     class output_stream;
     class input_sequence;
@@ -150,6 +151,38 @@ namespace e2d::utils
         return impl::sdbm_hash_impl(init, first, last);
     }
 
+    //
+    // fnv1a_hash
+    //
+
+    namespace impl
+    {
+        // Inspired by:
+        // http://www.isthe.com/chongo/tech/comp/fnv/
+
+        template < typename Iter >
+        u64 fnv1a_hash_impl(u64 init, Iter first, Iter last) noexcept {
+            static_assert(
+                sizeof(*first) == 1u,
+                "fnv1a hash is defined for bytes");
+            while ( first != last ) {
+                init ^= static_cast<u8>(*first++);
+                init *= 1099511628211ull;
+            }
+            return init;
+        }
+    }
+
+    template < typename Iter >
+    u64 fnv1a_hash(Iter first, Iter last) noexcept {
+        return impl::fnv1a_hash_impl(14695981039346656037ull, first, last);
+    }
+
+    template < typename Iter >
+    u64 fnv1a_hash(u64 init, Iter first, Iter last) noexcept {
+        return impl::fnv1a_hash_impl(init, first, last);
+    }
+
     //
     // hash_combine
     //
@@ -45,6 +45,9 @@ namespace e2d::filesystem
     bool file_exists(str_view path);
     bool directory_exists(str_view path);
 
+    // last modification time since the unix epoch
+    bool try_get_write_time(microseconds<u64>& dst, str_view path) noexcept;
+
     bool create_file(str_view path);
     bool create_directory(str_view path);
     bool create_directory_recursive(str_view path);
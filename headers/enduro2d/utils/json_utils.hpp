@@ -16,6 +16,28 @@ namespace e2d::json_utils
     void add_common_schema_definitions(rapidjson::Document& schema);
 }
 
+namespace e2d::json_utils
+{
+    // cooked json is a versioned flat array of typed values in
+    // pre-order with a string table, it's read without text parsing.
+    // 'schema' is an optional tag of the schema the value was validated
+    // against before cooking, zero means the value wasn't validated
+
+    bool try_load_cooked_json(
+        rapidjson::Document& dst,
+        const buffer& src) noexcept;
+
+    bool try_load_cooked_json(
+        rapidjson::Document& dst,
+        u32& schema,
+        const buffer& src) noexcept;
+
+    bool try_save_cooked_json(
+        buffer& dst,
+        const rapidjson::Value& src,
+        u32 schema = 0u) noexcept;
+}
+
 namespace e2d::json_utils
 {
     bool try_parse_value(const rapidjson::Value& root, v2i& v) noexcept;
@@ -12,6 +12,8 @@ namespace e2d::path
 {
     str combine(str_view lhs, str_view rhs);
 
+    str normalize(str_view path);
+
     str remove_filename(str_view path);
     str remove_extension(str_view path);
 
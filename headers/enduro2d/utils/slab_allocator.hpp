@@ -0,0 +1,77 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include "_utils.hpp"
+#include "intrusive_ptr.hpp"
+
+namespace e2d
+{
+    class slab_allocator;
+    using slab_allocator_iptr = intrusive_ptr<slab_allocator>;
+}
+
+namespace e2d
+{
+    //
+    // slab_allocator
+    //
+    // Size-class free lists carved from big slabs. Blocks remember
+    // their allocator, so deallocation does not need it. The allocator
+    // keeps itself alive while it has live blocks, so create it
+    // with make_intrusive only.
+    //
+
+    class slab_allocator final
+        : private noncopyable
+        , public ref_counter<slab_allocator> {
+    public:
+        class scope;
+
+        struct statistics {
+            std::size_t allocations{0u};
+            std::size_t deallocations{0u};
+            std::size_t live_blocks{0u};
+            std::size_t heap_fallbacks{0u};
+            std::size_t slab_count{0u};
+            std::size_t reserved_bytes{0u};
+        };
+
+        static constexpr std::size_t granularity = 16u;
+        static constexpr std::size_t max_block_size = 1024u;
+        static constexpr std::size_t default_slab_size = 64u * 1024u;
+    public:
+        explicit slab_allocator(std::size_t slab_size = default_slab_size);
+        ~slab_allocator() noexcept;
+
+        void* allocate(std::size_t size);
+        static void deallocate(void* ptr) noexcept;
+
+        statistics stats() const noexcept;
+
+        static slab_allocator& shared();
+        static slab_allocator& current();
+    private:
+        class internal_state;
+        std::unique_ptr<internal_state> state_;
+    };
+
+    //
+    // slab_allocator::scope
+    //
+    // Redirects 'slab_allocator::current' of the calling thread
+    // to the allocator while the scope is alive.
+    //
+
+    class slab_allocator::scope final : private noncopyable {
+    public:
+        explicit scope(slab_allocator& allocator) noexcept;
+        ~scope() noexcept;
+    private:
+        slab_allocator* prev_{nullptr};
+    };
+}
@@ -6,8 +6,145 @@
 
 #include <enduro2d/core/deferrer.hpp>
 
+namespace
+{
+    using namespace e2d;
+
+    const deferrer::task_context default_task_context;
+    thread_local const deferrer::task_context* current_task_context = nullptr;
+}
+
 namespace e2d
 {
+    //
+    // cancellation_token
+    //
+
+    struct cancellation_token::state {
+        std::atomic<bool> cancelled{false};
+        // tokens joined to a shared one, guarded by the mutex
+        std::mutex mutex;
+        bool shared{false};
+        bool pinned{false};
+        vector<cancellation_token> joined;
+
+        // the mutex must be locked
+        bool check_joined() noexcept {
+            if ( cancelled.load() ) {
+                return true;
+            }
+            if ( pinned ) {
+                return false;
+            }
+            joined.erase(
+                std::remove_if(joined.begin(), joined.end(), [](const cancellation_token& token){
+                    return token.cancelled();
+                }),
+                joined.end());
+            if ( !joined.empty() ) {
+                return false;
+            }
+            cancelled.store(true);
+            return true;
+        }
+    };
+
+    cancellation_token::cancellation_token()
+    : state_(std::make_shared<state>()) {}
+
+    cancellation_token::cancellation_token(std::shared_ptr<state> state) noexcept
+    : state_(std::move(state)) {}
+
+    cancellation_token cancellation_token::none() noexcept {
+        return cancellation_token(nullptr);
+    }
+
+    cancellation_token cancellation_token::all_of(const cancellation_token& token) {
+        cancellation_token result;
+        result.state_->shared = true;
+        result.join(token);
+        return result;
+    }
+
+    bool cancellation_token::join(const cancellation_token& token) {
+        E2D_ASSERT(state_ && state_->shared);
+        std::lock_guard<std::mutex> guard(state_->mutex);
+        if ( state_->cancelled.load()
+            || (!state_->joined.empty() && state_->check_joined()) )
+        {
+            return false;
+        }
+        if ( !token.state_ ) {
+            // a request that is never cancelled keeps the work
+            state_->pinned = true;
+            state_->joined.clear();
+        } else if ( !state_->pinned ) {
+            state_->joined.push_back(token);
+        }
+        return true;
+    }
+
+    void cancellation_token::cancel() noexcept {
+        if ( state_ ) {
+            state_->cancelled.store(true);
+        }
+    }
+
+    bool cancellation_token::cancelled() const noexcept {
+        if ( !state_ ) {
+            return false;
+        }
+        if ( state_->cancelled.load() ) {
+            return true;
+        }
+        if ( !state_->shared ) {
+            return false;
+        }
+        std::lock_guard<std::mutex> guard(state_->mutex);
+        return state_->check_joined();
+    }
+
+    //
+    // deferrer::task_context
+    //
+
+    stdex::jobber_priority deferrer::task_context::current_priority() const noexcept {
+        return raised_priority
+            ? std::max(priority, raised_priority->load())
+            : priority;
+    }
+
+    void deferrer::task_context::raise_priority(stdex::jobber_priority new_priority) noexcept {
+        E2D_ASSERT(raised_priority);
+        stdex::jobber_priority prev = raised_priority->load();
+        while ( prev < new_priority
+            && !raised_priority->compare_exchange_weak(prev, new_priority) ) {}
+    }
+
+    //
+    // deferrer::context_scope
+    //
+
+    deferrer::context_scope::context_scope(task_context context) noexcept
+    : context_(std::move(context))
+    , prev_context_(current_task_context) {
+        current_task_context = &context_;
+    }
+
+    deferrer::context_scope::~context_scope() noexcept {
+        current_task_context = prev_context_;
+    }
+
+    //
+    // deferrer
+    //
+
+    const deferrer::task_context& deferrer::current_context() noexcept {
+        return current_task_context
+            ? *current_task_context
+            : default_task_context;
+    }
+
     deferrer::deferrer()
     : worker_(math::max(2u, std::thread::hardware_concurrency()) - 1u) {}
 
@@ -26,4 +163,61 @@ namespace e2d
     const stdex::scheduler& deferrer::scheduler() const noexcept {
         return scheduler_;
     }
+
+    deferrer& deferrer::main_thread_budget(microseconds<u64> time, std::size_t bytes) noexcept {
+        time_budget_ = time;
+        byte_budget_ = bytes;
+        return *this;
+    }
+
+    microseconds<u64> deferrer::main_thread_time_budget() const noexcept {
+        return time_budget_;
+    }
+
+    std::size_t deferrer::main_thread_byte_budget() const noexcept {
+        return byte_budget_;
+    }
+
+    std::size_t deferrer::process_main_thread_tasks() noexcept {
+        E2D_ASSERT(is_in_main_thread());
+        std::size_t processed_tasks = scheduler_.process_all_tasks().second;
+
+        frame_bytes_ = 0u;
+        const microseconds<u64> begin_time = time::now_us<u64>();
+        for ( bool first = true; ; first = false ) {
+            if ( !first ) {
+                if ( byte_budget_ && frame_bytes_ >= byte_budget_ ) {
+                    break;
+                }
+                if ( time_budget_.value && time::now_us<u64>() - begin_time >= time_budget_ ) {
+                    break;
+                }
+            }
+            if ( 0 == budgeted_scheduler_.process_one_task().second ) {
+                break;
+            }
+            ++processed_tasks;
+        }
+
+        return processed_tasks;
+    }
+
+    std::size_t deferrer::budgeted_task_count() const noexcept {
+        return budgeted_task_count_;
+    }
+
+    stdex::scheduler_priority deferrer::budgeted_priority_(
+        stdex::scheduler_priority priority,
+        stdex::jobber_priority context_priority) noexcept
+    {
+        // the context shifts the lane of the task relative to the normal one
+        const int shifted =
+            static_cast<int>(priority) +
+            static_cast<int>(context_priority) -
+            static_cast<int>(stdex::jobber_priority::normal);
+        return static_cast<stdex::scheduler_priority>(math::clamp(
+            shifted,
+            static_cast<int>(stdex::scheduler_priority::lowest),
+            static_cast<int>(stdex::scheduler_priority::highest)));
+    }
 }
@@ -104,6 +104,16 @@ namespace e2d
         return *this;
     }
 
+    engine::timer_parameters& engine::timer_parameters::fixed_framerate(u32 value) noexcept {
+        fixed_framerate_ = value;
+        return *this;
+    }
+
+    engine::timer_parameters& engine::timer_parameters::maximal_fixed_steps(u32 value) noexcept {
+        maximal_fixed_steps_ = value;
+        return *this;
+    }
+
     u32 engine::timer_parameters::minimal_framerate() const noexcept {
         return minimal_framerate_;
     }
@@ -112,6 +122,36 @@ namespace e2d
         return maximal_framerate_;
     }
 
+    u32 engine::timer_parameters::fixed_framerate() const noexcept {
+        return fixed_framerate_;
+    }
+
+    u32 engine::timer_parameters::maximal_fixed_steps() const noexcept {
+        return maximal_fixed_steps_;
+    }
+
+    //
+    // engine::deferrer_parameters
+    //
+
+    engine::deferrer_parameters& engine::deferrer_parameters::main_thread_time_budget(microseconds<u64> value) noexcept {
+        main_thread_time_budget_ = value;
+        return *this;
+    }
+
+    engine::deferrer_parameters& engine::deferrer_parameters::main_thread_byte_budget(std::size_t value) noexcept {
+        main_thread_byte_budget_ = value;
+        return *this;
+    }
+
+    microseconds<u64> engine::deferrer_parameters::main_thread_time_budget() const noexcept {
+        return main_thread_time_budget_;
+    }
+
+    std::size_t engine::deferrer_parameters::main_thread_byte_budget() const noexcept {
+        return main_thread_byte_budget_;
+    }
+
     //
     // engine::window_parameters
     //
@@ -195,6 +235,11 @@ namespace e2d
         return *this;
     }
 
+    engine::parameters& engine::parameters::deferrer_params(const deferrer_parameters& value) {
+        deferrer_params_ = value;
+        return *this;
+    }
+
     str& engine::parameters::game_name() noexcept {
         return game_name_;
     }
@@ -223,6 +268,10 @@ namespace e2d
         return timer_params_;
     }
 
+    engine::deferrer_parameters& engine::parameters::deferrer_params() noexcept {
+        return deferrer_params_;
+    }
+
     const str& engine::parameters::game_name() const noexcept {
         return game_name_;
     }
@@ -251,6 +300,10 @@ namespace e2d
         return timer_params_;
     }
 
+    const engine::deferrer_parameters& engine::parameters::deferrer_params() const noexcept {
+        return deferrer_params_;
+    }
+
     //
     // engine
     //
@@ -266,6 +319,14 @@ namespace e2d
                 1000u);
             delta_time_us_.store(
                 (time::second_us<u64>() / math::numeric_cast<u64>(first_frame_time)).value);
+
+            if ( timer_params_.fixed_framerate() > 0u ) {
+                fixed_step_us_ = time::second_us<u64>() / math::numeric_cast<u64>(
+                    math::clamp(timer_params_.fixed_framerate(), 1u, 1000u));
+                // the first frame always runs one step
+                fixed_accumulator_us_ = fixed_step_us_;
+                delta_time_us_.store(fixed_step_us_.value);
+            }
         }
         ~internal_state() noexcept = default;
     public:
@@ -291,7 +352,39 @@ namespace e2d
             const auto delta_us = time::now_us<u64>() - init_time_;
             return time::to_seconds(delta_us.cast_to<f32>()).value;
         }
+
+        bool fixed_time_step() const noexcept {
+            return fixed_step_us_.value > 0u;
+        }
+
+        f32 interpolation_factor() const noexcept {
+            return interpolation_factor_.load();
+        }
     public:
+        u32 consume_fixed_steps() noexcept {
+            if ( !fixed_time_step() ) {
+                return 1u;
+            }
+
+            u32 steps = math::numeric_cast<u32>(
+                fixed_accumulator_us_.value / fixed_step_us_.value);
+            fixed_accumulator_us_ -= fixed_step_us_ * math::numeric_cast<u64>(steps);
+
+            const u32 max_steps = math::max(1u, timer_params_.maximal_fixed_steps());
+            if ( steps > max_steps ) {
+                // the simulation can't keep up, drops the time
+                // instead of accumulating it for the next frames
+                steps = max_steps;
+                fixed_accumulator_us_ = microseconds<u64>(0u);
+            }
+
+            interpolation_factor_.store(
+                fixed_accumulator_us_.cast_to<f32>().value /
+                fixed_step_us_.cast_to<f32>().value);
+
+            return steps;
+        }
+
         void calculate_end_frame_timers() noexcept {
             const auto second_us = time::second_us<u64>();
 
@@ -315,9 +408,15 @@ namespace e2d
                 now_us = time::now_us<u64>();
             }
 
-            delta_time_us_.store(math::minimized(
+            const auto frame_time_us = math::minimized(
                 now_us - prev_frame_time_,
-                maximal_delta_time_us).value);
+                maximal_delta_time_us);
+
+            if ( fixed_time_step() ) {
+                fixed_accumulator_us_ += frame_time_us;
+            } else {
+                delta_time_us_.store(frame_time_us.value);
+            }
 
             time_us_.store((now_us - init_time_).value);
             prev_frame_time_ = now_us;
@@ -339,6 +438,9 @@ namespace e2d
         std::atomic<u32> frame_rate_{0};
         std::atomic<u32> frame_count_{0};
         std::atomic<u32> frame_rate_counter_{0};
+        microseconds<u64> fixed_step_us_{0u};
+        microseconds<u64> fixed_accumulator_us_{0u};
+        std::atomic<f32> interpolation_factor_{1.f};
     };
 
     //
@@ -356,6 +458,10 @@ namespace e2d
 
         safe_module_initialize<deferrer>();
 
+        the<deferrer>().main_thread_budget(
+            params.deferrer_params().main_thread_time_budget(),
+            params.deferrer_params().main_thread_byte_budget());
+
         // setup debug
 
         safe_module_initialize<debug>();
@@ -450,9 +556,20 @@ namespace e2d
         while ( true ) {
             try {
                 the<dbgui>().frame_tick();
-                the<deferrer>().scheduler().process_all_tasks();
+                the<deferrer>().process_main_thread_tasks();
+
+                bool should_continue = true;
+                const u32 steps = state_->consume_fixed_steps();
+                for ( u32 i = 0; i < steps && should_continue; ++i ) {
+                    should_continue = app->frame_tick();
+                    if ( state_->fixed_time_step() ) {
+                        // input edges are seen by one fixed step only,
+                        // without a step they wait for the next frames
+                        the<input>().frame_tick();
+                    }
+                }
 
-                if ( !app->frame_tick() ) {
+                if ( !should_continue ) {
                     break;
                 }
 
@@ -467,7 +584,9 @@ namespace e2d
                 app->shutdown();
                 throw;
             }
-            the<input>().frame_tick();
+            if ( !state_->fixed_time_step() ) {
+                the<input>().frame_tick();
+            }
             window::poll_events();
         }
 
@@ -494,4 +613,12 @@ namespace e2d
     f32 engine::realtime_time() const noexcept {
         return state_->realtime_time();
     }
+
+    bool engine::fixed_time_step() const noexcept {
+        return state_->fixed_time_step();
+    }
+
+    f32 engine::interpolation_factor() const noexcept {
+        return state_->interpolation_factor();
+    }
 }
@@ -0,0 +1,218 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include <enduro2d/core/tracer.hpp>
+
+#include <3rdparty/rapidjson/writer.h>
+#include <3rdparty/rapidjson/stringbuffer.h>
+
+namespace
+{
+    using namespace e2d;
+
+    std::atomic<u32> last_thread_id{0u};
+
+    void write_trace_event(
+        rapidjson::Writer<rapidjson::StringBuffer>& writer,
+        const tracer::span& span)
+    {
+        writer.StartObject();
+        writer.Key("name");
+        writer.String(span.name.c_str(), math::numeric_cast<rapidjson::SizeType>(span.name.size()));
+        writer.Key("cat");
+        writer.String(span.stage.c_str(), math::numeric_cast<rapidjson::SizeType>(span.stage.size()));
+        writer.Key("ph");
+        writer.String("X");
+        writer.Key("ts");
+        writer.Uint64(span.begin.value);
+        writer.Key("dur");
+        writer.Uint64(span.end.value - span.begin.value);
+        writer.Key("pid");
+        writer.Uint(0u);
+        writer.Key("tid");
+        writer.Uint(span.thread_id);
+        writer.Key("args");
+        writer.StartObject();
+        writer.Key("type");
+        writer.String(span.type.c_str(), math::numeric_cast<rapidjson::SizeType>(span.type.size()));
+        writer.Key("id");
+        writer.Uint64(span.id);
+        writer.Key("parent");
+        writer.Uint64(span.parent_id);
+        writer.EndObject();
+        writer.EndObject();
+    }
+
+    // an arrow from the parent span to the start of the child
+    void write_flow_events(
+        rapidjson::Writer<rapidjson::StringBuffer>& writer,
+        const tracer::span& parent,
+        const tracer::span& child)
+    {
+        const u64 ts = math::clamp(child.begin.value, parent.begin.value, parent.end.value);
+        const std::pair<const char*, const tracer::span*> events[] = {
+            {"s", &parent},
+            {"f", &child}};
+        for ( const auto& event : events ) {
+            writer.StartObject();
+            writer.Key("name");
+            writer.String("dependency");
+            writer.Key("cat");
+            writer.String("dependency");
+            writer.Key("ph");
+            writer.String(event.first);
+            if ( event.second == &child ) {
+                writer.Key("bp");
+                writer.String("e");
+            }
+            writer.Key("id");
+            writer.Uint64(child.id);
+            writer.Key("ts");
+            writer.Uint64(event.second == &child ? child.begin.value : ts);
+            writer.Key("pid");
+            writer.Uint(0u);
+            writer.Key("tid");
+            writer.Uint(event.second->thread_id);
+            writer.EndObject();
+        }
+    }
+}
+
+namespace e2d
+{
+    //
+    // tracer
+    //
+
+    u64 tracer::next_span_id() noexcept {
+        return ++last_span_id_;
+    }
+
+    void tracer::add_span(span span) {
+        std::lock_guard<std::mutex> guard(mutex_);
+        spans_.push_back(std::move(span));
+    }
+
+    vector<tracer::span> tracer::spans() const {
+        std::lock_guard<std::mutex> guard(mutex_);
+        return spans_;
+    }
+
+    void tracer::clear() noexcept {
+        std::lock_guard<std::mutex> guard(mutex_);
+        spans_.clear();
+    }
+
+    vector<tracer::summary> tracer::summarize() const {
+        vector<summary> result;
+        std::lock_guard<std::mutex> guard(mutex_);
+        for ( const span& s : spans_ ) {
+            auto iter = std::find_if(result.begin(), result.end(), [&s](const summary& r){
+                return r.type == s.type && r.stage == s.stage;
+            });
+            if ( iter == result.end() ) {
+                iter = result.insert(result.end(), summary{
+                    s.type, s.stage, 0u,
+                    make_microseconds<u64>(0u),
+                    make_microseconds<u64>(0u)});
+            }
+            const microseconds<u64> duration = s.end - s.begin;
+            ++iter->count;
+            iter->total += duration;
+            if ( duration > iter->max ) {
+                iter->max = duration;
+            }
+        }
+        std::sort(result.begin(), result.end(), [](const summary& l, const summary& r){
+            return l.total > r.total;
+        });
+        return result;
+    }
+
+    bool tracer::try_save_chrome_trace(str& dst) const noexcept {
+        try {
+            const vector<span> spans = this->spans();
+
+            hash_map<u64, const span*> spans_by_id;
+            for ( const span& s : spans ) {
+                spans_by_id.emplace(s.id, &s);
+            }
+
+            rapidjson::StringBuffer sb;
+            rapidjson::Writer<rapidjson::StringBuffer> writer(sb);
+            writer.StartObject();
+            writer.Key("displayTimeUnit");
+            writer.String("ms");
+            writer.Key("traceEvents");
+            writer.StartArray();
+            for ( const span& s : spans ) {
+                write_trace_event(writer, s);
+                const auto parent = spans_by_id.find(s.parent_id);
+                if ( parent != spans_by_id.end() && parent->second->thread_id != s.thread_id ) {
+                    write_flow_events(writer, *parent->second, s);
+                }
+            }
+            writer.EndArray();
+            writer.EndObject();
+
+            dst.assign(sb.GetString(), sb.GetSize());
+            return true;
+        } catch (...) {
+            return false;
+        }
+    }
+
+    u32 tracer::current_thread_id() noexcept {
+        thread_local const u32 thread_id = ++last_thread_id;
+        return thread_id;
+    }
+
+    tracer::span tracer::begin_span(str_view type, str_view stage, str_view name) {
+        span result;
+        if ( modules::is_initialized<tracer>() ) {
+            result.id = the<tracer>().next_span_id();
+            result.parent_id = deferrer::current_context().trace_span;
+            result.thread_id = current_thread_id();
+            result.type = type;
+            result.stage = stage;
+            result.name = name;
+            result.begin = time::now_us<u64>();
+        }
+        return result;
+    }
+
+    void tracer::end_span(span span) noexcept {
+        if ( !span.id ) {
+            return;
+        }
+        span.end = time::now_us<u64>();
+        try {
+            if ( modules::is_initialized<tracer>() ) {
+                the<tracer>().add_span(std::move(span));
+            }
+        } catch (...) {
+            // nothing
+        }
+    }
+
+    //
+    // tracer::scope
+    //
+
+    tracer::scope::scope(str_view type, str_view stage, str_view name)
+    : span_(begin_span(type, stage, name)) {
+        if ( span_.id ) {
+            deferrer::task_context context = deferrer::current_context();
+            context.trace_span = span_.id;
+            context_ = std::make_unique<deferrer::context_scope>(std::move(context));
+        }
+    }
+
+    tracer::scope::~scope() noexcept {
+        context_.reset();
+        end_span(std::move(span_));
+    }
+}
@@ -5,6 +5,8 @@
  ******************************************************************************/
 
 #include <enduro2d/core/vfs.hpp>
+#include <enduro2d/core/deferrer.hpp>
+#include <enduro2d/core/tracer.hpp>
 
 #include <3rdparty/miniz/miniz.h>
 
@@ -147,6 +149,14 @@ namespace e2d
             }, false);
     }
 
+    bool vfs::write_time(const url& url, microseconds<u64>& dst) const {
+        std::lock_guard<std::mutex> guard(state_->mutex);
+        return state_->with_file_source(url,
+            [&dst](const file_source_uptr& source, const str& path) {
+                return source->write_time(path, dst);
+            }, false);
+    }
+
     input_stream_uptr vfs::read(const url& url) const {
         std::lock_guard<std::mutex> guard(state_->mutex);
         return state_->with_file_source(url,
@@ -163,6 +173,14 @@ namespace e2d
             }, output_stream_uptr());
     }
 
+    bool vfs::remove(const url& url) const {
+        std::lock_guard<std::mutex> guard(state_->mutex);
+        return state_->with_file_source(url,
+            [](const file_source_uptr& source, const str& path) {
+                return source->remove(path);
+            }, false);
+    }
+
     bool vfs::load(const url& url, buffer& dst) const {
         return load_async(url)
             .then([&dst](auto&& src){
@@ -172,14 +190,24 @@ namespace e2d
     }
 
     stdex::promise<buffer> vfs::load_async(const url& url) const {
-        return state_->worker.async([this, url](){
-            buffer content;
-            const input_stream_uptr stream = read(url);
-            if ( !stream || !streams::try_read_tail(content, stream) ) {
-                throw vfs_load_async_exception();
-            }
-            return content;
+        // cancelled reads are dropped before IO starts
+        const deferrer::task_context& context = deferrer::current_context();
+        stdex::promise<buffer> result;
+        state_->worker.async(
+            context.current_priority(),
+            deferrer::make_context_task(context, result, [this, url](){
+                const tracer::scope trace_scope("vfs", "read", url.path());
+                buffer content;
+                const input_stream_uptr stream = read(url);
+                if ( !stream || !streams::try_read_tail(content, stream) ) {
+                    throw vfs_load_async_exception();
+                }
+                return content;
+            }))
+        .except([result](std::exception_ptr e) mutable {
+            result.reject(e);
         });
+        return result;
     }
 
     bool vfs::load_as_string(const url& url, str& dst) const {
@@ -191,14 +219,24 @@ namespace e2d
     }
 
     stdex::promise<str> vfs::load_as_string_async(const url& url) const {
-        return state_->worker.async([this, url](){
-            str content;
-            const input_stream_uptr stream = read(url);
-            if ( !stream || !streams::try_read_tail(content, stream) ) {
-                throw vfs_load_async_exception();
-            }
-            return content;
+        // cancelled reads are dropped before IO starts
+        const deferrer::task_context& context = deferrer::current_context();
+        stdex::promise<str> result;
+        state_->worker.async(
+            context.current_priority(),
+            deferrer::make_context_task(context, result, [this, url](){
+                const tracer::scope trace_scope("vfs", "read", url.path());
+                str content;
+                const input_stream_uptr stream = read(url);
+                if ( !stream || !streams::try_read_tail(content, stream) ) {
+                    throw vfs_load_async_exception();
+                }
+                return content;
+            }))
+        .except([result](std::exception_ptr e) mutable {
+            result.reject(e);
         });
+        return result;
     }
 
     bool vfs::trace(const url& url, filesystem::trace_func func) const {
@@ -278,6 +316,31 @@ namespace e2d
             MZ_ZIP_FLAG_CASE_SENSITIVE);
     }
 
+    bool archive_file_source::write_time(str_view path, microseconds<u64>& dst) const {
+    #ifdef MINIZ_NO_TIME
+        E2D_UNUSED(path, dst);
+        return false;
+    #else
+        mz_uint32 file_index = 0;
+        if ( !mz_zip_reader_locate_file_v2(
+            state_->archive.get(),
+            make_utf8(path).c_str(),
+            nullptr,
+            MZ_ZIP_FLAG_CASE_SENSITIVE,
+            &file_index) )
+        {
+            return false;
+        }
+        mz_zip_archive_file_stat file_stat;
+        if ( !mz_zip_reader_file_stat(state_->archive.get(), file_index, &file_stat) ) {
+            return false;
+        }
+        dst = make_seconds(static_cast<u64>(file_stat.m_time))
+            .convert_to<microseconds_tag>();
+        return true;
+    #endif
+    }
+
     input_stream_uptr archive_file_source::read(str_view path) const {
         try {
             struct owned_state_t {
@@ -298,6 +361,11 @@ namespace e2d
         return nullptr;
     }
 
+    bool archive_file_source::remove(str_view path) const {
+        E2D_UNUSED(path);
+        return false;
+    }
+
     bool archive_file_source::trace(str_view path, filesystem::trace_func func) const {
         str parent = make_utf8(path);
         if ( !parent.empty() ) {
@@ -353,6 +421,10 @@ namespace e2d
         return filesystem::file_exists(path);
     }
 
+    bool filesystem_file_source::write_time(str_view path, microseconds<u64>& dst) const {
+        return filesystem::try_get_write_time(dst, path);
+    }
+
     input_stream_uptr filesystem_file_source::read(str_view path) const {
         return make_read_file(path);
     }
@@ -364,6 +436,10 @@ namespace e2d
         return make_write_file(path, append);
     }
 
+    bool filesystem_file_source::remove(str_view path) const {
+        return filesystem::remove_file(path);
+    }
+
     bool filesystem_file_source::trace(str_view path, filesystem::trace_func func) const {
         return filesystem::trace_directory_recursive(path, func);
     }
@@ -0,0 +1,265 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include <enduro2d/high/asset_manifest.hpp>
+#include <enduro2d/high/address.hpp>
+
+#include <3rdparty/rapidjson/writer.h>
+#include <3rdparty/rapidjson/stringbuffer.h>
+
+namespace
+{
+    using namespace e2d;
+
+    bool try_parse_u64(const rapidjson::Value& root, const char* name, u64& dst) noexcept {
+        if ( !root.HasMember(name) ) {
+            return true;
+        }
+        if ( !root[name].IsUint64() ) {
+            return false;
+        }
+        dst = root[name].GetUint64();
+        return true;
+    }
+
+    bool try_parse_manifest_entry(
+        asset_manifest::entry& dst,
+        const rapidjson::Value& root) noexcept
+    {
+        if ( !root.IsObject() ) {
+            return false;
+        }
+
+        asset_manifest::entry entry;
+
+        if ( !root.HasMember("address") || !root.HasMember("type") ) {
+            return false;
+        }
+
+        if ( !json_utils::try_parse_value(root["address"], entry.address) ) {
+            return false;
+        }
+
+        if ( !json_utils::try_parse_value(root["type"], entry.type) ) {
+            return false;
+        }
+
+        if ( !try_parse_u64(root, "size", entry.size) ) {
+            return false;
+        }
+
+        if ( !try_parse_u64(root, "hash", entry.content_hash) ) {
+            return false;
+        }
+
+        if ( root.HasMember("dependencies") ) {
+            const rapidjson::Value& deps_json = root["dependencies"];
+            if ( !deps_json.IsArray() ) {
+                return false;
+            }
+            entry.dependencies.reserve(deps_json.Size());
+            for ( rapidjson::SizeType i = 0; i < deps_json.Size(); ++i ) {
+                str dependency;
+                if ( !json_utils::try_parse_value(deps_json[i], dependency) ) {
+                    return false;
+                }
+                entry.dependencies.push_back(address::parent(dependency));
+            }
+        }
+
+        entry.address = address::parent(entry.address);
+        dst = std::move(entry);
+        return true;
+    }
+
+    void write_manifest_string(
+        rapidjson::Writer<rapidjson::StringBuffer>& writer,
+        const str& value)
+    {
+        writer.String(value.c_str(), math::numeric_cast<rapidjson::SizeType>(value.size()));
+    }
+
+    void write_manifest_entry(
+        rapidjson::Writer<rapidjson::StringBuffer>& writer,
+        const asset_manifest::entry& entry)
+    {
+        writer.StartObject();
+        writer.Key("address");
+        write_manifest_string(writer, entry.address);
+        writer.Key("type");
+        write_manifest_string(writer, entry.type);
+        writer.Key("size");
+        writer.Uint64(entry.size);
+        writer.Key("hash");
+        writer.Uint64(entry.content_hash);
+        if ( !entry.dependencies.empty() ) {
+            writer.Key("dependencies");
+            writer.StartArray();
+            for ( const str& dependency : entry.dependencies ) {
+                write_manifest_string(writer, dependency);
+            }
+            writer.EndArray();
+        }
+        writer.EndObject();
+    }
+}
+
+namespace e2d
+{
+    asset_manifest::asset_manifest(asset_manifest&& other) noexcept {
+        assign(std::move(other));
+    }
+
+    asset_manifest& asset_manifest::operator=(asset_manifest&& other) noexcept {
+        return assign(std::move(other));
+    }
+
+    asset_manifest::asset_manifest(const asset_manifest& other) {
+        assign(other);
+    }
+
+    asset_manifest& asset_manifest::operator=(const asset_manifest& other) {
+        return assign(other);
+    }
+
+    void asset_manifest::clear() noexcept {
+        entries_.clear();
+    }
+
+    void asset_manifest::swap(asset_manifest& other) noexcept {
+        using std::swap;
+        swap(entries_, other.entries_);
+    }
+
+    asset_manifest& asset_manifest::assign(asset_manifest&& other) noexcept {
+        if ( this != &other ) {
+            swap(other);
+            other.clear();
+        }
+        return *this;
+    }
+
+    asset_manifest& asset_manifest::assign(const asset_manifest& other) {
+        if ( this != &other ) {
+            asset_manifest s;
+            s.entries_ = other.entries_;
+            swap(s);
+        }
+        return *this;
+    }
+
+    asset_manifest& asset_manifest::add_entry(entry&& entry) {
+        const str_hash address_hash = make_hash(entry.address);
+        entries_[address_hash] = std::move(entry);
+        return *this;
+    }
+
+    asset_manifest& asset_manifest::add_entry(const entry& entry) {
+        entries_[make_hash(entry.address)] = entry;
+        return *this;
+    }
+
+    const asset_manifest::entry* asset_manifest::find_entry(str_hash address) const noexcept {
+        const auto iter = entries_.find(address);
+        return iter != entries_.end()
+            ? &iter->second
+            : nullptr;
+    }
+
+    std::size_t asset_manifest::entry_count() const noexcept {
+        return entries_.size();
+    }
+
+    bool asset_manifest::empty() const noexcept {
+        return entries_.empty();
+    }
+
+    void swap(asset_manifest& l, asset_manifest& r) noexcept {
+        l.swap(r);
+    }
+}
+
+namespace e2d::asset_manifests
+{
+    bool try_load_manifest(
+        asset_manifest& dst,
+        const buffer& src) noexcept
+    {
+        try {
+            rapidjson::Document doc;
+            doc.Parse(
+                reinterpret_cast<const char*>(src.data()),
+                src.size());
+            if ( doc.HasParseError() || !doc.IsObject() ) {
+                return false;
+            }
+
+            asset_manifest manifest;
+            if ( doc.HasMember("assets") ) {
+                const rapidjson::Value& assets_json = doc["assets"];
+                if ( !assets_json.IsArray() ) {
+                    return false;
+                }
+                for ( rapidjson::SizeType i = 0; i < assets_json.Size(); ++i ) {
+                    asset_manifest::entry entry;
+                    if ( !try_parse_manifest_entry(entry, assets_json[i]) ) {
+                        return false;
+                    }
+                    manifest.add_entry(std::move(entry));
+                }
+            }
+
+            dst = std::move(manifest);
+            return true;
+        } catch (...) {
+            return false;
+        }
+    }
+
+    bool try_load_manifest(
+        asset_manifest& dst,
+        const input_stream_uptr& src) noexcept
+    {
+        buffer file_data;
+        return streams::try_read_tail(file_data, src)
+            && try_load_manifest(dst, file_data);
+    }
+
+    bool try_save_manifest(
+        buffer& dst,
+        const asset_manifest& src) noexcept
+    {
+        try {
+            vector<const asset_manifest::entry*> entries;
+            entries.reserve(src.entry_count());
+            src.for_each_entry([&entries](const asset_manifest::entry& entry){
+                entries.push_back(&entry);
+            });
+            std::sort(entries.begin(), entries.end(), [](
+                const asset_manifest::entry* l,
+                const asset_manifest::entry* r)
+            {
+                return l->address < r->address;
+            });
+
+            rapidjson::StringBuffer sb;
+            rapidjson::Writer<rapidjson::StringBuffer> writer(sb);
+            writer.StartObject();
+            writer.Key("assets");
+            writer.StartArray();
+            for ( const asset_manifest::entry* entry : entries ) {
+                write_manifest_entry(writer, *entry);
+            }
+            writer.EndArray();
+            writer.EndObject();
+
+            dst.assign(sb.GetString(), sb.GetSize());
+            return true;
+        } catch (...) {
+            return false;
+        }
+    }
+}
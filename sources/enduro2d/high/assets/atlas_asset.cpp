@@ -112,7 +112,7 @@ namespace
         const rapidjson::Value& root)
     {
         E2D_ASSERT(root.HasMember("texture") && root["texture"].IsString());
-        auto texture_p = library.load_asset_async<texture_asset>(
+        auto texture_p = library.load_dependency_async<texture_asset>(
             path::combine(parent_address, root["texture"].GetString()));
 
         vector<sprite_desc> sprite_descs;
@@ -146,6 +146,10 @@ namespace
 
 namespace e2d
 {
+    const rapidjson::SchemaDocument& atlas_asset::schema() {
+        return atlas_asset_schema();
+    }
+
     atlas_asset::load_async_result atlas_asset::load_async(
         const library& library, str_view address)
     {
@@ -156,6 +160,11 @@ namespace e2d
             parent_address = path::parent_path(address)
         ](const json_asset::load_result& atlas_data){
             return the<deferrer>().do_in_worker_thread([address, atlas_data](){
+                const tracer::scope trace_scope(atlas_asset::type_name(), "validate", address);
+                if ( atlas_data->validated_for(atlas_asset::type_name()) ) {
+                    return;
+                }
+
                 const rapidjson::Document& doc = *atlas_data->content();
                 rapidjson::SchemaValidator validator(atlas_asset_schema());
 
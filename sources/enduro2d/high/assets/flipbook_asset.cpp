@@ -94,7 +94,7 @@ namespace
     {
         if ( root.HasMember("atlas") ) {
             E2D_ASSERT(root["atlas"].IsString());
-            return library.load_asset_async<atlas_asset, sprite_asset>(
+            return library.load_dependency_async<atlas_asset, sprite_asset>(
                 path::combine(parent_address, root["atlas"].GetString()))
             .then([](const sprite_asset::load_result& sprite){
                 flipbook::frame frame;
@@ -105,7 +105,7 @@ namespace
 
         if ( root.HasMember("sprite") ) {
             E2D_ASSERT(root["sprite"].IsString());
-            return library.load_asset_async<sprite_asset>(
+            return library.load_dependency_async<sprite_asset>(
                 path::combine(parent_address, root["sprite"].GetString()))
             .then([](const sprite_asset::load_result& sprite){
                 flipbook::frame frame;
@@ -205,6 +205,10 @@ namespace
 
 namespace e2d
 {
+    const rapidjson::SchemaDocument& flipbook_asset::schema() {
+        return flipbook_asset_schema();
+    }
+
     flipbook_asset::load_async_result flipbook_asset::load_async(
         const library& library, str_view address)
     {
@@ -215,6 +219,11 @@ namespace e2d
             parent_address = path::parent_path(address)
         ](const json_asset::load_result& flipbook_data){
             return the<deferrer>().do_in_worker_thread([address, flipbook_data](){
+                const tracer::scope trace_scope(flipbook_asset::type_name(), "validate", address);
+                if ( flipbook_data->validated_for(flipbook_asset::type_name()) ) {
+                    return;
+                }
+
                 const rapidjson::Document& doc = *flipbook_data->content();
                 rapidjson::SchemaValidator validator(flipbook_asset_schema());
 
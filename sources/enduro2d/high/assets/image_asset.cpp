@@ -7,6 +7,8 @@
 #include <enduro2d/high/assets/image_asset.hpp>
 #include <enduro2d/high/assets/binary_asset.hpp>
 
+#include <enduro2d/high/image_cache.hpp>
+
 namespace
 {
     using namespace e2d;
@@ -23,15 +25,49 @@ namespace e2d
     image_asset::load_async_result image_asset::load_async(
         const library& library, str_view address)
     {
-        return library.load_asset_async<binary_asset>(address)
-        .then([](const binary_asset::load_result& image_data){
-            return the<deferrer>().do_in_worker_thread([image_data](){
+        const str cooked = cooked_address(address);
+        const bool is_cooked = library.is_cooked_asset_actual(address, cooked);
+        return library.load_asset_async<binary_asset>(
+            is_cooked ? str_view(cooked) : address)
+        .then([address = str(address), is_cooked](const binary_asset::load_result& image_data){
+            return the<deferrer>().do_in_worker_thread([address, is_cooked, image_data](){
+                // cooked images are decoded already
+                image_cache* cache = !is_cooked && modules::is_initialized<image_cache>()
+                    ? &the<image_cache>()
+                    : nullptr;
+
+                u64 content_hash = 0u;
+                if ( cache ) {
+                    const tracer::scope trace_scope(image_asset::type_name(), "cache", address);
+                    image content;
+                    content_hash = image_cache::content_hash(image_data->content());
+                    if ( cache->try_load(content, content_hash) ) {
+                        return image_asset::create(std::move(content));
+                    }
+                }
+
+                const tracer::scope trace_scope(image_asset::type_name(), "decode", address);
                 image content;
                 if ( !images::try_load_image(content, image_data->content()) ) {
                     throw image_asset_loading_exception();
                 }
+                if ( cache ) {
+                    cache->store_async(content_hash, content);
+                }
                 return image_asset::create(std::move(content));
             });
         });
     }
+
+    str image_asset::cooked_address(str_view address) {
+        str result(address);
+        result += ".dds";
+        return result;
+    }
+
+    asset_memory_usage image_asset::memory_usage() const noexcept {
+        asset_memory_usage result;
+        result.cpu_bytes = content().data().size();
+        return result;
+    }
 }
@@ -6,6 +6,7 @@
 
 #include <enduro2d/high/assets/json_asset.hpp>
 #include <enduro2d/high/assets/text_asset.hpp>
+#include <enduro2d/high/assets/binary_asset.hpp>
 
 namespace
 {
@@ -23,9 +24,29 @@ namespace e2d
     json_asset::load_async_result json_asset::load_async(
         const library& library, str_view address)
     {
+        const str cooked = cooked_address(address);
+        if ( library.is_cooked_asset_actual(address, cooked) ) {
+            return library.load_asset_async<binary_asset>(cooked)
+            .then([address = str(address)](const binary_asset::load_result& json_data){
+                return the<deferrer>().do_in_worker_thread([address, json_data](){
+                    const tracer::scope trace_scope(json_asset::type_name(), "decode", address);
+                    u32 schema_tag = 0u;
+                    auto json = std::make_unique<rapidjson::Document>();
+                    if ( !json_utils::try_load_cooked_json(*json, schema_tag, json_data->content()) ) {
+                        throw json_asset_loading_exception();
+                    }
+                    auto result = json_asset::create(std::move(json));
+                    result->cooked_ = true;
+                    result->schema_tag_ = schema_tag;
+                    return result;
+                });
+            });
+        }
+
         return library.load_asset_async<text_asset>(address)
-        .then([](const text_asset::load_result& json_data){
-            return the<deferrer>().do_in_worker_thread([json_data](){
+        .then([address = str(address)](const text_asset::load_result& json_data){
+            return the<deferrer>().do_in_worker_thread([address, json_data](){
+                const tracer::scope trace_scope(json_asset::type_name(), "parse", address);
                 auto json = std::make_unique<rapidjson::Document>();
                 if ( json->Parse(json_data->content().c_str()).HasParseError() ) {
                     throw json_asset_loading_exception();
@@ -34,4 +55,20 @@ namespace e2d
             });
         });
     }
+
+    str json_asset::cooked_address(str_view address) {
+        str result(address);
+        result += ".e2d_json";
+        return result;
+    }
+
+    u32 json_asset::schema_tag(str_view type_name) noexcept {
+        return make_hash(type_name).hash();
+    }
+
+    bool json_asset::validated_for(str_view type_name) const noexcept {
+        return cooked_
+            && schema_tag_
+            && schema_tag_ == schema_tag(type_name);
+    }
 }
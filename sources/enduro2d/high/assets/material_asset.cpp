@@ -1168,6 +1168,10 @@ namespace
 
 namespace e2d
 {
+    const rapidjson::SchemaDocument& material_asset::schema() {
+        return material_asset_schema();
+    }
+
     material_asset::load_async_result material_asset::load_async(
         const library& library, str_view address)
     {
@@ -1178,6 +1182,11 @@ namespace e2d
             parent_address = path::parent_path(address)
         ](const json_asset::load_result& material_data){
             return the<deferrer>().do_in_worker_thread([address, material_data](){
+                const tracer::scope trace_scope(material_asset::type_name(), "validate", address);
+                if ( material_data->validated_for(material_asset::type_name()) ) {
+                    return;
+                }
+
                 const rapidjson::Document& doc = *material_data->content();
                 rapidjson::SchemaValidator validator(material_asset_schema());
 
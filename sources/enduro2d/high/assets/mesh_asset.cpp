@@ -11,6 +11,11 @@ namespace
 {
     using namespace e2d;
 
+    template < typename T >
+    std::size_t vector_bytes(const vector<T>& v) noexcept {
+        return v.size() * sizeof(T);
+    }
+
     class mesh_asset_loading_exception final : public asset_loading_exception {
         const char* what() const noexcept final {
             return "mesh asset loading exception";
@@ -34,4 +39,23 @@ namespace e2d
             });
         });
     }
+
+    asset_memory_usage mesh_asset::memory_usage() const noexcept {
+        const mesh& m = content();
+        asset_memory_usage result;
+        result.cpu_bytes += vector_bytes(m.vertices());
+        result.cpu_bytes += vector_bytes(m.normals());
+        result.cpu_bytes += vector_bytes(m.tangents());
+        result.cpu_bytes += vector_bytes(m.bitangents());
+        for ( std::size_t i = 0; i < m.uvs_channel_count(); ++i ) {
+            result.cpu_bytes += vector_bytes(m.uvs(i));
+        }
+        for ( std::size_t i = 0; i < m.colors_channel_count(); ++i ) {
+            result.cpu_bytes += vector_bytes(m.colors(i));
+        }
+        for ( std::size_t i = 0; i < m.indices_submesh_count(); ++i ) {
+            result.cpu_bytes += vector_bytes(m.indices(i));
+        }
+        return result;
+    }
 }
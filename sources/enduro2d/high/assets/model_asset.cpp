@@ -52,23 +52,32 @@ namespace
         const rapidjson::Value& root)
     {
         E2D_ASSERT(root.HasMember("mesh") && root["mesh"].IsString());
-        auto mesh_p = library.load_asset_async<mesh_asset>(
-            path::combine(parent_address, root["mesh"].GetString()));
+        const str mesh_address = path::combine(parent_address, root["mesh"].GetString());
+        auto mesh_p = library.load_asset_async<mesh_asset>(mesh_address);
 
         return mesh_p.then([
+            mesh_address
         ](const mesh_asset::load_result& mesh){
-            return the<deferrer>().do_in_main_thread([mesh](){
-                model content;
-                content.set_mesh(mesh);
-                content.regenerate_geometry(the<render>());
-                return content;
-            });
+            return the<deferrer>().do_in_main_thread_budgeted(
+                stdex::scheduler_priority::normal,
+                mesh->memory_usage().cpu_bytes,
+                [mesh_address, mesh](){
+                    const tracer::scope trace_scope(model_asset::type_name(), "upload", mesh_address);
+                    model content;
+                    content.set_mesh(mesh);
+                    content.regenerate_geometry(the<render>());
+                    return content;
+                });
         });
     }
 }
 
 namespace e2d
 {
+    const rapidjson::SchemaDocument& model_asset::schema() {
+        return model_asset_schema();
+    }
+
     model_asset::load_async_result model_asset::load_async(
         const library& library, str_view address)
     {
@@ -79,6 +88,11 @@ namespace e2d
             parent_address = path::parent_path(address)
         ](const json_asset::load_result& model_data){
             return the<deferrer>().do_in_worker_thread([address, model_data](){
+                const tracer::scope trace_scope(model_asset::type_name(), "validate", address);
+                if ( model_data->validated_for(model_asset::type_name()) ) {
+                    return;
+                }
+
                 const rapidjson::Document& doc = *model_data->content();
                 rapidjson::SchemaValidator validator(model_asset_schema());
 
@@ -111,4 +125,19 @@ namespace e2d
             });
         });
     }
+
+    asset_memory_usage model_asset::memory_usage() const noexcept {
+        // the source mesh is a nested asset and counted separately
+        const render::geometry& geo = content().geometry();
+        asset_memory_usage result;
+        if ( geo.indices() ) {
+            result.gpu_bytes += geo.indices()->buffer_size();
+        }
+        for ( std::size_t i = 0; i < geo.vertices_count(); ++i ) {
+            if ( geo.vertices(i) ) {
+                result.gpu_bytes += geo.vertices(i)->buffer_size();
+            }
+        }
+        return result;
+    }
 }
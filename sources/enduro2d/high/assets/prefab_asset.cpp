@@ -184,6 +184,10 @@ namespace
 
 namespace e2d
 {
+    const rapidjson::SchemaDocument& prefab_asset::schema() {
+        return prefab_asset_schema();
+    }
+
     prefab_asset::load_async_result prefab_asset::load_async(
         const library& library, str_view address)
     {
@@ -194,6 +198,11 @@ namespace e2d
             parent_address = path::parent_path(address)
         ](const json_asset::load_result& prefab_data){
             return the<deferrer>().do_in_worker_thread([address, prefab_data](){
+                const tracer::scope trace_scope(prefab_asset::type_name(), "validate", address);
+                if ( prefab_data->validated_for(prefab_asset::type_name()) ) {
+                    return;
+                }
+
                 const rapidjson::Document& doc = *prefab_data->content();
                 rapidjson::SchemaValidator validator(prefab_asset_schema());
 
@@ -54,8 +54,8 @@ namespace
         const rapidjson::Value& root)
     {
         E2D_ASSERT(root.HasMember("vertex") && root["vertex"].IsString());
-        auto vertex_p = library.load_asset_async<text_asset>(
-            path::combine(parent_address, root["vertex"].GetString()));
+        const str vertex_address = path::combine(parent_address, root["vertex"].GetString());
+        auto vertex_p = library.load_asset_async<text_asset>(vertex_address);
 
         E2D_ASSERT(root.HasMember("fragment") && root["fragment"].IsString());
         auto fragment_p = library.load_asset_async<text_asset>(
@@ -64,25 +64,35 @@ namespace
         return stdex::make_tuple_promise(std::make_tuple(
             std::move(vertex_p),
             std::move(fragment_p)))
-        .then([](const std::tuple<
+        .then([vertex_address](const std::tuple<
             text_asset::load_result,
             text_asset::load_result
         >& results){
-            return the<deferrer>().do_in_main_thread([results](){
-                const shader_ptr content = the<render>().create_shader(
-                    std::get<0>(results)->content(),
-                    std::get<1>(results)->content());
-                if ( !content ) {
-                    throw shader_asset_loading_exception();
-                }
-                return content;
-            });
+            // shaders are small and block materials, so they go first
+            return the<deferrer>().do_in_main_thread_budgeted(
+                stdex::scheduler_priority::above_normal,
+                std::get<0>(results)->content().size() +
+                std::get<1>(results)->content().size(),
+                [vertex_address, results](){
+                    const tracer::scope trace_scope(shader_asset::type_name(), "upload", vertex_address);
+                    const shader_ptr content = the<render>().create_shader(
+                        std::get<0>(results)->content(),
+                        std::get<1>(results)->content());
+                    if ( !content ) {
+                        throw shader_asset_loading_exception();
+                    }
+                    return content;
+                });
         });
     }
 }
 
 namespace e2d
 {
+    const rapidjson::SchemaDocument& shader_asset::schema() {
+        return shader_asset_schema();
+    }
+
     shader_asset::load_async_result shader_asset::load_async(
         const library& library, str_view address)
     {
@@ -93,6 +103,11 @@ namespace e2d
             parent_address = path::parent_path(address)
         ](const json_asset::load_result& shader_data){
             return the<deferrer>().do_in_worker_thread([address, shader_data](){
+                const tracer::scope trace_scope(shader_asset::type_name(), "validate", address);
+                if ( shader_data->validated_for(shader_asset::type_name()) ) {
+                    return;
+                }
+
                 const rapidjson::Document& doc = *shader_data->content();
                 rapidjson::SchemaValidator validator(shader_asset_schema());
 
@@ -11,6 +11,11 @@ namespace
 {
     using namespace e2d;
 
+    template < typename T >
+    std::size_t vector_bytes(const vector<T>& v) noexcept {
+        return v.size() * sizeof(T);
+    }
+
     class shape_asset_loading_exception final : public asset_loading_exception {
         const char* what() const noexcept final {
             return "shape asset loading exception";
@@ -34,4 +39,20 @@ namespace e2d
             });
         });
     }
+
+    asset_memory_usage shape_asset::memory_usage() const noexcept {
+        const shape& s = content();
+        asset_memory_usage result;
+        result.cpu_bytes += vector_bytes(s.vertices());
+        for ( std::size_t i = 0; i < s.uvs_channel_count(); ++i ) {
+            result.cpu_bytes += vector_bytes(s.uvs(i));
+        }
+        for ( std::size_t i = 0; i < s.colors_channel_count(); ++i ) {
+            result.cpu_bytes += vector_bytes(s.colors(i));
+        }
+        for ( std::size_t i = 0; i < s.indices_subshape_count(); ++i ) {
+            result.cpu_bytes += vector_bytes(s.indices(i));
+        }
+        return result;
+    }
 }
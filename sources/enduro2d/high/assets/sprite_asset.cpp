@@ -55,7 +55,7 @@ namespace
         const rapidjson::Value& root)
     {
         E2D_ASSERT(root.HasMember("texture") && root["texture"].IsString());
-        auto texture_p = library.load_asset_async<texture_asset>(
+        auto texture_p = library.load_dependency_async<texture_asset>(
             path::combine(parent_address, root["texture"].GetString()));
 
         v2f pivot;
@@ -87,6 +87,10 @@ namespace
 
 namespace e2d
 {
+    const rapidjson::SchemaDocument& sprite_asset::schema() {
+        return sprite_asset_schema();
+    }
+
     sprite_asset::load_async_result sprite_asset::load_async(
         const library& library, str_view address)
     {
@@ -97,6 +101,11 @@ namespace e2d
             parent_address = path::parent_path(address)
         ](const json_asset::load_result& sprite_data){
             return the<deferrer>().do_in_worker_thread([address, sprite_data](){
+                const tracer::scope trace_scope(sprite_asset::type_name(), "validate", address);
+                if ( sprite_data->validated_for(sprite_asset::type_name()) ) {
+                    return;
+                }
+
                 const rapidjson::Document& doc = *sprite_data->content();
                 rapidjson::SchemaValidator validator(sprite_asset_schema());
 
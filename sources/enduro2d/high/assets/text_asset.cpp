@@ -29,4 +29,10 @@ namespace e2d
                 std::forward<decltype(content)>(content));
         });
     }
+
+    asset_memory_usage text_asset::memory_usage() const noexcept {
+        asset_memory_usage result;
+        result.cpu_bytes = content().size();
+        return result;
+    }
 }
@@ -24,15 +24,30 @@ namespace e2d
         const library& library, str_view address)
     {
         return library.load_asset_async<image_asset>(address)
-        .then([](const image_asset::load_result& texture_data){
-            return the<deferrer>().do_in_main_thread([texture_data](){
-                const texture_ptr content = the<render>().create_texture(
-                    texture_data->content());
-                if ( !content ) {
-                    throw texture_asset_loading_exception();
-                }
-                return texture_asset::create(content);
-            });
+        .then([address = str(address)](const image_asset::load_result& texture_data){
+            return the<deferrer>().do_in_main_thread_budgeted(
+                stdex::scheduler_priority::normal,
+                texture_data->content().data().size(),
+                [address, texture_data](){
+                    const tracer::scope trace_scope(texture_asset::type_name(), "upload", address);
+                    const texture_ptr content = the<render>().create_texture(
+                        texture_data->content());
+                    if ( !content ) {
+                        throw texture_asset_loading_exception();
+                    }
+                    return texture_asset::create(content);
+                });
         });
     }
+
+    asset_memory_usage texture_asset::memory_usage() const noexcept {
+        asset_memory_usage result;
+        if ( content() ) {
+            const v2u& size = content()->size();
+            result.gpu_bytes =
+                std::size_t(size.x) * size.y *
+                content()->decl().bits_per_pixel() / 8u;
+        }
+        return result;
+    }
 }
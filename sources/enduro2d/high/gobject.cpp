@@ -18,6 +18,14 @@ namespace e2d
         entity_.destroy();
     }
 
+    void* gobject::operator new(std::size_t size) {
+        return slab_allocator::current().allocate(size);
+    }
+
+    void gobject::operator delete(void* ptr) noexcept {
+        slab_allocator::deallocate(ptr);
+    }
+
     ecs::entity gobject::entity() noexcept {
         return entity_;
     }
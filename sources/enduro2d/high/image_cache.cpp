@@ -0,0 +1,317 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include <enduro2d/high/image_cache.hpp>
+
+namespace
+{
+    using namespace e2d;
+
+    const char* image_cache_index_name = "index";
+
+    // the index is written on destruction and once per this
+    // count of changes, so a crash loses a few entries at most
+    const std::size_t image_cache_index_save_period = 16u;
+
+    str entry_name(u64 content_hash) {
+        char name[32] = {0};
+        std::snprintf(
+            name, sizeof(name),
+            "%016llx.dds",
+            static_cast<unsigned long long>(content_hash));
+        return name;
+    }
+}
+
+namespace e2d
+{
+    //
+    // image_cache::internal_state
+    //
+
+    class image_cache::internal_state final : private e2d::noncopyable {
+    public:
+        struct entry {
+            std::size_t size{0u};
+            u64 last_use{0u};
+        };
+    public:
+        internal_state(const url& root, std::size_t capacity, deferrer& deferrer)
+        : root_(root)
+        , capacity_(capacity)
+        , deferrer_(deferrer) {
+            load_index_();
+        }
+
+        ~internal_state() noexcept {
+            std::unique_lock<std::mutex> lock(mutex_);
+            stored_cond_.wait(lock, [this](){
+                return storing_.empty();
+            });
+            lock.unlock();
+            save_index_();
+        }
+    public:
+        const url& root() const noexcept {
+            return root_;
+        }
+
+        std::size_t capacity() const noexcept {
+            return capacity_;
+        }
+
+        std::size_t size() const noexcept {
+            std::lock_guard<std::mutex> guard(mutex_);
+            return size_;
+        }
+
+        std::size_t entry_count() const noexcept {
+            std::lock_guard<std::mutex> guard(mutex_);
+            return entries_.size();
+        }
+
+        bool try_load(image& dst, u64 content_hash) {
+            {
+                std::lock_guard<std::mutex> guard(mutex_);
+                const auto iter = entries_.find(content_hash);
+                if ( iter == entries_.end() ) {
+                    return false;
+                }
+                iter->second.last_use = ++use_clock_;
+            }
+
+            // read in the calling thread, it's a worker one already
+            buffer data;
+            const input_stream_uptr stream = the<vfs>().read(root_ / entry_name(content_hash));
+            if ( stream
+                && streams::try_read_tail(data, stream)
+                && images::try_load_image(dst, data) )
+            {
+                return true;
+            }
+
+            // removed or damaged outside of the cache
+            remove_entry_(content_hash);
+            return false;
+        }
+
+        stdex::promise<void> store_async(u64 content_hash, image src) {
+            {
+                std::lock_guard<std::mutex> guard(mutex_);
+                if ( !capacity_
+                    || entries_.count(content_hash)
+                    || !storing_.insert(content_hash).second )
+                {
+                    return stdex::make_resolved_promise();
+                }
+            }
+
+            // the store outlives the load that started it
+            deferrer::context_scope scope({
+                stdex::jobber_priority::lowest,
+                cancellation_token::none()});
+            return deferrer_.do_in_worker_thread([this, content_hash, src = std::move(src)](){
+                store_(content_hash, src);
+            }).except([this, content_hash](std::exception_ptr e){
+                stored_(content_hash, 0u);
+                std::rethrow_exception(e);
+            });
+        }
+
+        std::size_t trim(std::size_t max_size) {
+            vector<std::pair<u64, u64>> victims;
+            {
+                std::lock_guard<std::mutex> guard(mutex_);
+                if ( size_ <= max_size ) {
+                    return 0u;
+                }
+                victims.reserve(entries_.size());
+                for ( const auto& e : entries_ ) {
+                    victims.emplace_back(e.second.last_use, e.first);
+                }
+            }
+
+            std::sort(victims.begin(), victims.end());
+
+            std::size_t removed = 0u;
+            for ( const auto& victim : victims ) {
+                if ( size() <= max_size ) {
+                    break;
+                }
+                remove_entry_(victim.second);
+                ++removed;
+            }
+            return removed;
+        }
+    private:
+        void store_(u64 content_hash, const image& src) {
+            buffer data;
+            if ( !images::try_save_image(src, image_file_format::dds, data) ) {
+                throw image_cache_exception();
+            }
+
+            // entries over the whole capacity are never kept
+            if ( data.size() > capacity_ ) {
+                stored_(content_hash, 0u);
+                return;
+            }
+
+            output_stream_uptr stream = the<vfs>().write(root_ / entry_name(content_hash), false);
+            if ( !stream || !streams::try_write_tail(data, stream) ) {
+                throw image_cache_exception();
+            }
+            stream.reset();
+
+            stored_(content_hash, data.size());
+            trim(capacity_);
+
+            bool save_index = false;
+            {
+                std::lock_guard<std::mutex> guard(mutex_);
+                save_index = unsaved_changes_ >= image_cache_index_save_period;
+            }
+            if ( save_index ) {
+                save_index_();
+            }
+        }
+
+        void stored_(u64 content_hash, std::size_t size) noexcept {
+            {
+                std::lock_guard<std::mutex> guard(mutex_);
+                if ( size ) {
+                    entries_[content_hash] = {size, ++use_clock_};
+                    size_ += size;
+                    ++unsaved_changes_;
+                }
+                storing_.erase(content_hash);
+            }
+            stored_cond_.notify_all();
+        }
+
+        void remove_entry_(u64 content_hash) {
+            {
+                std::lock_guard<std::mutex> guard(mutex_);
+                const auto iter = entries_.find(content_hash);
+                if ( iter == entries_.end() ) {
+                    return;
+                }
+                size_ -= iter->second.size;
+                entries_.erase(iter);
+                ++unsaved_changes_;
+            }
+            the<vfs>().remove(root_ / entry_name(content_hash));
+        }
+
+        // one line per entry: <hash> <size> <last use>
+        void load_index_() {
+            str content;
+            const input_stream_uptr stream = the<vfs>().read(root_ / image_cache_index_name);
+            if ( !stream || !streams::try_read_tail(content, stream) ) {
+                return;
+            }
+            std::size_t line_begin = 0u;
+            while ( line_begin < content.size() ) {
+                std::size_t line_end = content.find('\n', line_begin);
+                if ( line_end == str::npos ) {
+                    line_end = content.size();
+                }
+                unsigned long long content_hash = 0u;
+                unsigned long long size = 0u;
+                unsigned long long last_use = 0u;
+                const str line = content.substr(line_begin, line_end - line_begin);
+                if ( 3 == std::sscanf(line.c_str(), "%llx %llu %llu", &content_hash, &size, &last_use) ) {
+                    entries_[content_hash] = {
+                        math::numeric_cast<std::size_t>(size),
+                        math::numeric_cast<u64>(last_use)};
+                    size_ += math::numeric_cast<std::size_t>(size);
+                    use_clock_ = math::max(use_clock_, math::numeric_cast<u64>(last_use));
+                }
+                line_begin = line_end + 1u;
+            }
+        }
+
+        void save_index_() noexcept {
+            try {
+                str content;
+                {
+                    std::lock_guard<std::mutex> guard(mutex_);
+                    unsaved_changes_ = 0u;
+                    char line[96] = {0};
+                    for ( const auto& e : entries_ ) {
+                        std::snprintf(
+                            line, sizeof(line),
+                            "%016llx %llu %llu\n",
+                            static_cast<unsigned long long>(e.first),
+                            static_cast<unsigned long long>(e.second.size),
+                            static_cast<unsigned long long>(e.second.last_use));
+                        content += line;
+                    }
+                }
+                std::lock_guard<std::mutex> guard(index_mutex_);
+                output_stream_uptr stream = the<vfs>().write(root_ / image_cache_index_name, false);
+                if ( !stream || !streams::try_write_tail(content, stream) ) {
+                    the<debug>().error("IMAGE_CACHE: Failed to write the index:\n"
+                        "--> Url: %0",
+                        root_ / image_cache_index_name);
+                }
+            } catch (...) {
+                // nothing
+            }
+        }
+    private:
+        url root_;
+        std::size_t capacity_{0u};
+        deferrer& deferrer_;
+        mutable std::mutex mutex_;
+        std::mutex index_mutex_;
+        std::condition_variable stored_cond_;
+        hash_map<u64, entry> entries_;
+        hash_set<u64> storing_;
+        std::size_t size_{0u};
+        std::size_t unsaved_changes_{0u};
+        u64 use_clock_{0u};
+    };
+
+    //
+    // image_cache
+    //
+
+    image_cache::image_cache(const url& root, std::size_t capacity, deferrer& deferrer)
+    : state_(new internal_state(root, capacity, deferrer)) {}
+    image_cache::~image_cache() noexcept = default;
+
+    const url& image_cache::root() const noexcept {
+        return state_->root();
+    }
+
+    std::size_t image_cache::capacity() const noexcept {
+        return state_->capacity();
+    }
+
+    std::size_t image_cache::size() const noexcept {
+        return state_->size();
+    }
+
+    std::size_t image_cache::entry_count() const noexcept {
+        return state_->entry_count();
+    }
+
+    u64 image_cache::content_hash(const buffer& src) noexcept {
+        return utils::fnv1a_hash(src.data(), src.data() + src.size());
+    }
+
+    bool image_cache::try_load(image& dst, u64 content_hash) {
+        return state_->try_load(dst, content_hash);
+    }
+
+    stdex::promise<void> image_cache::store_async(u64 content_hash, image src) {
+        return state_->store_async(content_hash, std::move(src));
+    }
+
+    std::size_t image_cache::trim(std::size_t max_size) {
+        return state_->trim(max_size);
+    }
+}
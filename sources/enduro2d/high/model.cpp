@@ -140,6 +140,11 @@ namespace
 
         return geo;
     }
+
+    b3f make_bounds(const mesh& mesh) noexcept {
+        const vector<v3f>& vertices = mesh.vertices();
+        return math::make_minmax_aabb(vertices.data(), vertices.size());
+    }
 }
 
 namespace e2d
@@ -163,12 +168,14 @@ namespace e2d
     void model::clear() noexcept {
         mesh_.reset();
         geometry_.clear();
+        bounds_ = b3f::zero();
     }
 
     void model::swap(model& other) noexcept {
         using std::swap;
         swap(mesh_, other.mesh_);
         swap(geometry_, other.geometry_);
+        swap(bounds_, other.bounds_);
     }
 
     model& model::assign(model&& other) noexcept {
@@ -184,6 +191,7 @@ namespace e2d
             model m;
             m.mesh_ = other.mesh_;
             m.geometry_ = other.geometry_;
+            m.bounds_ = other.bounds_;
             swap(m);
         }
         return *this;
@@ -192,6 +200,9 @@ namespace e2d
     model& model::set_mesh(const mesh_asset::ptr& mesh) {
         mesh_ = mesh;
         geometry_.clear();
+        bounds_ = mesh
+            ? make_bounds(mesh->content())
+            : b3f::zero();
         return *this;
     }
 
@@ -199,6 +210,10 @@ namespace e2d
         return mesh_;
     }
 
+    const b3f& model::bounds() const noexcept {
+        return bounds_;
+    }
+
     void model::regenerate_geometry(render& render) {
         if ( mesh_ ) {
             geometry_ = make_geometry(render, mesh_->content());
@@ -7,10 +7,174 @@
 #include <enduro2d/high/node.hpp>
 #include <enduro2d/high/world.hpp>
 
+namespace
+{
+    using namespace e2d;
+
+    // stamp of the active read scope, zero outside of scopes
+    std::atomic<u32> current_read_stamp{0u};
+    std::atomic<u32> last_read_stamp{0u};
+
+    //
+    // change_log
+    //
+    // records of changed nodes, every thread records to its own
+    // buffer, so the buffer lock is taken by the thread and
+    // the extracting one only, a node is recorded once per
+    // generation, a generation ends with an extraction,
+    // nothing is recorded in the zero generation
+    //
+
+    template < typename T >
+    class change_log final : private noncopyable {
+    public:
+        struct buffer {
+            std::mutex mutex;
+            vector<T> records;
+        };
+
+        class thread_buffer final : public buffer {
+        public:
+            thread_buffer(change_log& log)
+            : log_(log) {
+                log_.attach_(*this);
+            }
+
+            ~thread_buffer() noexcept {
+                log_.detach_(*this);
+            }
+        private:
+            change_log& log_;
+        };
+    public:
+        explicit change_log(u32 generation) noexcept
+        : generation_(generation) {}
+
+        u32 generation() const noexcept {
+            return generation_.load(std::memory_order_acquire);
+        }
+
+        void record(buffer& b, const T& record) noexcept {
+            try {
+                std::lock_guard<std::mutex> guard(b.mutex);
+                b.records.push_back(record);
+            } catch (...) {
+                lost_changes();
+            }
+        }
+
+        void lost_changes() noexcept {
+            lost_.store(true, std::memory_order_relaxed);
+        }
+
+        // nodes changed from now on are recorded to the next generation
+        bool extract(vector<T>& records, u32 next_generation) {
+            generation_.store(next_generation, std::memory_order_release);
+            std::lock_guard<std::mutex> guard(mutex_);
+            records.insert(records.end(), orphans_.begin(), orphans_.end());
+            orphans_.clear();
+            for ( buffer* b : buffers_ ) {
+                std::lock_guard<std::mutex> buffer_guard(b->mutex);
+                records.insert(records.end(), b->records.begin(), b->records.end());
+                b->records.clear();
+            }
+            return !lost_.exchange(false, std::memory_order_relaxed);
+        }
+    private:
+        void attach_(buffer& b) {
+            std::lock_guard<std::mutex> guard(mutex_);
+            buffers_.push_back(&b);
+        }
+
+        void detach_(buffer& b) noexcept {
+            std::lock_guard<std::mutex> guard(mutex_);
+            try {
+                orphans_.insert(orphans_.end(), b.records.begin(), b.records.end());
+            } catch (...) {
+                lost_changes();
+            }
+            buffers_.erase(std::remove(buffers_.begin(), buffers_.end(), &b), buffers_.end());
+        }
+    private:
+        std::mutex mutex_;
+        vector<buffer*> buffers_;
+        vector<T> orphans_;
+        std::atomic<u32> generation_;
+        std::atomic<bool> lost_{false};
+    };
+
+    // owners of changed nodes for the spatial index
+    using owner_log = change_log<ecs::entity_id>;
+
+    // owners of moved nodes with their transforms before the step
+    using step_log = change_log<std::pair<ecs::entity_id, t3f>>;
+
+    owner_log& owner_changes() noexcept {
+        static owner_log log(1u);
+        return log;
+    }
+
+    step_log& step_changes() noexcept {
+        static step_log log(0u);
+        return log;
+    }
+
+    void record_owner_change(ecs::entity_id owner) noexcept {
+        try {
+            thread_local owner_log::thread_buffer buffer(owner_changes());
+            owner_changes().record(buffer, owner);
+        } catch (...) {
+            owner_changes().lost_changes();
+        }
+    }
+
+    void record_step_change(ecs::entity_id owner, const t3f& previous) noexcept {
+        try {
+            thread_local step_log::thread_buffer buffer(step_changes());
+            step_changes().record(buffer, {owner, previous});
+        } catch (...) {
+            step_changes().lost_changes();
+        }
+    }
+
+    u32 next_read_stamp() noexcept {
+        u32 stamp = last_read_stamp.fetch_add(1u, std::memory_order_relaxed) + 1u;
+        while ( !stamp ) {
+            stamp = last_read_stamp.fetch_add(1u, std::memory_order_relaxed) + 1u;
+        }
+        return stamp;
+    }
+}
+
 namespace e2d
 {
+    //
+    // node::read_scope
+    //
+
+    node::read_scope::read_scope() noexcept
+    : prev_stamp_(current_read_stamp.exchange(
+        next_read_stamp(),
+        std::memory_order_relaxed)) {}
+
+    node::read_scope::~read_scope() noexcept {
+        // an outer scope gets a new stamp, the inner
+        // one could have seen changes it does not know
+        current_read_stamp.store(
+            prev_stamp_ ? next_read_stamp() : 0u,
+            std::memory_order_relaxed);
+    }
+
+    //
+    // node
+    //
+
     node::node(const gobject_iptr& owner)
-    : owner_(owner) {}
+    : owner_(owner)
+    , step_generation_(step_changes().generation()) {
+        // new nodes have no transform before the step
+        mark_changed_();
+    }
 
     node::~node() noexcept {
         E2D_ASSERT(!parent_);
@@ -41,8 +205,37 @@ namespace e2d
         return child;
     }
 
+    void* node::operator new(std::size_t size) {
+        return slab_allocator::current().allocate(size);
+    }
+
+    void node::operator delete(void* ptr) noexcept {
+        slab_allocator::deallocate(ptr);
+    }
+
+    bool node::extract_changed_owners(vector<ecs::entity_id>& owners) {
+        const u32 generation = owner_changes().generation() + 1u;
+        return owner_changes().extract(owners, generation ? generation : 1u);
+    }
+
+    void node::begin_transform_step() {
+        static std::atomic<u32> last_step_generation{0u};
+        u32 generation = last_step_generation.fetch_add(1u, std::memory_order_relaxed) + 1u;
+        while ( !generation ) {
+            generation = last_step_generation.fetch_add(1u, std::memory_order_relaxed) + 1u;
+        }
+        vector<std::pair<ecs::entity_id, t3f>> unfinished;
+        step_changes().extract(unfinished, generation);
+    }
+
+    bool node::end_transform_step(vector<std::pair<ecs::entity_id, t3f>>& previous) {
+        return step_changes().extract(previous, 0u);
+    }
+
     void node::owner(const gobject_iptr& owner) noexcept {
         owner_ = owner;
+        change_generation_ = 0u;
+        mark_changed_();
     }
 
     gobject_iptr node::owner() noexcept {
@@ -54,6 +247,7 @@ namespace e2d
     }
 
     void node::transform(const t3f& transform) noexcept {
+        mark_moved_();
         transform_ = transform;
         mark_dirty_local_matrix_();
     }
@@ -63,6 +257,7 @@ namespace e2d
     }
 
     void node::translation(const v3f& translation) noexcept {
+        mark_moved_();
         transform_.translation = translation;
         mark_dirty_local_matrix_();
     }
@@ -72,6 +267,7 @@ namespace e2d
     }
 
     void node::rotation(const q4f& rotation) noexcept {
+        mark_moved_();
         transform_.rotation = rotation;
         mark_dirty_local_matrix_();
     }
@@ -81,6 +277,7 @@ namespace e2d
     }
 
     void node::scale(const v3f& scale) noexcept {
+        mark_moved_();
         transform_.scale = scale;
         mark_dirty_local_matrix_();
     }
@@ -90,19 +287,69 @@ namespace e2d
     }
 
     const m4f& node::local_matrix() const noexcept {
-        if ( math::check_and_clear_any_flags(flags_, fm_dirty_local_matrix) ) {
+        if ( local_matrix_version_ != local_version_ ) {
             update_local_matrix_();
         }
         return local_matrix_;
     }
 
     const m4f& node::world_matrix() const noexcept {
-        if ( math::check_and_clear_any_flags(flags_, fm_dirty_world_matrix) ) {
-            update_world_matrix_();
-        }
+        update_world_matrix_();
         return world_matrix_;
     }
 
+    void node::local_bounds(const b3f& bounds) noexcept {
+        if ( math::check_any_flags(flags_, fm_has_local_bounds) && local_bounds_ == bounds ) {
+            return;
+        }
+        local_bounds_ = bounds;
+        ++local_bounds_version_;
+        math::set_flags_inplace(flags_, fm_has_local_bounds);
+        mark_dirty_world_bounds_();
+        mark_changed_();
+    }
+
+    const b3f& node::local_bounds() const noexcept {
+        return local_bounds_;
+    }
+
+    bool node::has_local_bounds() const noexcept {
+        return math::check_any_flags(flags_, fm_has_local_bounds);
+    }
+
+    bool node::reset_local_bounds() noexcept {
+        if ( !math::check_and_clear_any_flags(flags_, fm_has_local_bounds) ) {
+            return false;
+        }
+        local_bounds_ = b3f::zero();
+        ++local_bounds_version_;
+        mark_dirty_world_bounds_();
+        mark_changed_();
+        return true;
+    }
+
+    b3f node::local_bounds_in_world() const noexcept {
+        return math::check_any_flags(flags_, fm_has_local_bounds)
+            ? math::transformed(local_bounds_, world_matrix())
+            : b3f::zero();
+    }
+
+    u32 node::local_bounds_in_world_version() const noexcept {
+        // both versions only grow, so does their sum
+        update_world_matrix_();
+        return world_version_ + local_bounds_version_;
+    }
+
+    const b3f& node::world_bounds() const noexcept {
+        update_world_bounds_();
+        return world_bounds_;
+    }
+
+    bool node::has_world_bounds() const noexcept {
+        update_world_bounds_();
+        return math::check_any_flags(flags_, fm_has_world_bounds);
+    }
+
     node_iptr node::root() noexcept {
         node* n = this;
         while ( n->parent_ ) {
@@ -200,6 +447,7 @@ namespace e2d
         children_.push_front(*child);
         child->parent_ = this;
         child->mark_dirty_world_matrix_();
+        mark_dirty_world_bounds_();
         return true;
     }
 
@@ -219,6 +467,7 @@ namespace e2d
         children_.push_back(*child);
         child->parent_ = this;
         child->mark_dirty_world_matrix_();
+        mark_dirty_world_bounds_();
         return true;
     }
 
@@ -241,6 +490,7 @@ namespace e2d
             *child);
         child->parent_ = this;
         child->mark_dirty_world_matrix_();
+        mark_dirty_world_bounds_();
         return true;
     }
 
@@ -263,6 +513,7 @@ namespace e2d
             *child);
         child->parent_ = this;
         child->mark_dirty_world_matrix_();
+        mark_dirty_world_bounds_();
         return true;
     }
 
@@ -289,6 +540,7 @@ namespace e2d
                 n->mark_dirty_world_matrix_();
                 intrusive_ptr_release(n);
             });
+        mark_dirty_world_bounds_();
         return true;
     }
 
@@ -391,27 +643,146 @@ namespace e2d
 
 namespace e2d
 {
-    void node::mark_dirty_local_matrix_() noexcept {
-        if ( math::check_and_set_any_flags(flags_, fm_dirty_local_matrix) ) {
-            mark_dirty_world_matrix_();
+    void node::mark_moved_() noexcept {
+        const u32 generation = step_changes().generation();
+        if ( !generation || step_generation_ == generation ) {
+            return;
+        }
+        step_generation_ = generation;
+        if ( owner_ ) {
+            record_step_change(owner_->entity().id(), transform_);
         }
     }
 
+    void node::mark_dirty_local_matrix_() noexcept {
+        ++local_version_;
+        mark_dirty_world_matrix_();
+    }
+
     void node::mark_dirty_world_matrix_() noexcept {
-        if ( math::check_and_set_any_flags(flags_, fm_dirty_world_matrix) ) {
-            for ( node& child : children_ ) {
-                child.mark_dirty_world_matrix_();
+        // changes are not expected in read scopes, but stay correct
+        if ( current_read_stamp.load(std::memory_order_relaxed) ) {
+            current_read_stamp.store(next_read_stamp(), std::memory_order_relaxed);
+        }
+
+        // descendants are not touched here, they notice
+        // a new world version of the parent when they are read
+        world_local_version_ = local_version_ - 1u;
+
+        // ancestors need to know about it only if our subtree has bounds
+        if ( parent_ && math::check_any_flags(flags_, fm_dirty_world_bounds | fm_has_world_bounds) ) {
+            parent_->mark_dirty_world_bounds_();
+        }
+
+        mark_changed_();
+    }
+
+    void node::mark_changed_() noexcept {
+        const u32 generation = owner_changes().generation();
+        if ( change_generation_ == generation ) {
+            return;
+        }
+        change_generation_ = generation;
+
+        // the nearest owned node stands for the subtree
+        for ( const node* n = this; n; n = n->parent_ ) {
+            if ( n->owner_ ) {
+                record_owner_change(n->owner_->entity().id());
+                return;
+            }
+        }
+
+        // without owned ancestors the topmost owned descendants do
+        for ( node& child : children_ ) {
+            child.mark_changed_subtree_();
+        }
+    }
+
+    void node::mark_changed_subtree_() noexcept {
+        if ( owner_ ) {
+            const u32 generation = owner_changes().generation();
+            if ( change_generation_ != generation ) {
+                change_generation_ = generation;
+                record_owner_change(owner_->entity().id());
             }
+            return;
+        }
+        for ( node& child : children_ ) {
+            child.mark_changed_subtree_();
+        }
+    }
+
+    void node::mark_dirty_world_bounds_() noexcept {
+        // a dirty node always has dirty ancestors,
+        // so we can stop at the first already dirty one
+        node* n = this;
+        while ( n && math::check_and_set_any_flags(n->flags_, fm_dirty_world_bounds) ) {
+            n = n->parent_;
         }
     }
 
     void node::update_local_matrix_() const noexcept {
         local_matrix_ = math::make_trs_matrix4(transform_);
+        local_matrix_version_ = local_version_;
     }
 
     void node::update_world_matrix_() const noexcept {
-        world_matrix_ = parent_
-            ? local_matrix() * parent_->world_matrix()
-            : local_matrix();
+        // a node validated in the current read scope
+        // has validated ancestors, nothing to compare
+        const u32 read_stamp = current_read_stamp.load(std::memory_order_relaxed);
+        if ( read_stamp && read_stamp_ == read_stamp ) {
+            return;
+        }
+
+        // otherwise a read compares versions along the parent
+        // chain and recomputes the matrices that are out of date
+        u32 parent_version{0u};
+        if ( parent_ ) {
+            parent_->update_world_matrix_();
+            parent_version = parent_->world_version_;
+        }
+
+        if ( world_local_version_ != local_version_ || world_parent_version_ != parent_version ) {
+            world_matrix_ = parent_
+                ? local_matrix() * parent_->world_matrix_
+                : local_matrix();
+            world_local_version_ = local_version_;
+            world_parent_version_ = parent_version;
+            ++world_version_;
+        }
+        read_stamp_ = read_stamp;
+    }
+
+    void node::update_world_bounds_() const noexcept {
+        const bool dirty = math::check_and_clear_any_flags(flags_, fm_dirty_world_bounds);
+        if ( !dirty && !math::check_any_flags(flags_, fm_has_world_bounds) ) {
+            // there are no bounds in the subtree at all
+            return;
+        }
+
+        update_world_matrix_();
+        if ( !dirty && world_bounds_version_ == world_version_ ) {
+            return;
+        }
+        world_bounds_version_ = world_version_;
+
+        bool has_bounds = math::check_any_flags(flags_, fm_has_local_bounds);
+        b3f bounds = has_bounds
+            ? math::transformed(local_bounds_, world_matrix_)
+            : b3f::zero();
+        for ( const node& child : children_ ) {
+            if ( child.has_world_bounds() ) {
+                bounds = has_bounds
+                    ? math::merged(bounds, child.world_bounds_)
+                    : child.world_bounds_;
+                has_bounds = true;
+            }
+        }
+        world_bounds_ = bounds;
+        if ( has_bounds ) {
+            math::set_flags_inplace(flags_, fm_has_world_bounds);
+        } else {
+            math::clear_flags_inplace(flags_, fm_has_world_bounds);
+        }
     }
 }
@@ -0,0 +1,360 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include <enduro2d/high/spatial_index.hpp>
+
+namespace
+{
+    using namespace e2d;
+
+    // sum of extents is the 3d analog of the perimeter
+    // and still works for flat 2d bounds
+    f32 bounds_cost(const v3f& min, const v3f& max) noexcept {
+        return (max.x - min.x) + (max.y - min.y) + (max.z - min.z);
+    }
+
+    f32 merged_bounds_cost(
+        const v3f& min1, const v3f& max1,
+        const v3f& min2, const v3f& max2) noexcept
+    {
+        return bounds_cost(
+            math::minimized(min1, min2),
+            math::maximized(max1, max2));
+    }
+
+    bool contains_bounds(
+        const v3f& outer_min, const v3f& outer_max,
+        const v3f& inner_min, const v3f& inner_max) noexcept
+    {
+        return outer_min.x <= inner_min.x && outer_max.x >= inner_max.x
+            && outer_min.y <= inner_min.y && outer_max.y >= inner_max.y
+            && outer_min.z <= inner_min.z && outer_max.z >= inner_max.z;
+    }
+}
+
+namespace e2d
+{
+    spatial_index::spatial_index(f32 margin)
+    : margin_(margin) {}
+
+    spatial_index::~spatial_index() noexcept = default;
+
+    bool spatial_index::update(key_type key, const b3f& bounds) {
+        const v3f min = math::minimum(bounds);
+        const v3f max = math::maximum(bounds);
+        const v3f fat = v3f(margin_);
+
+        const auto iter = leaves_.find(key);
+        if ( iter != leaves_.end() ) {
+            tree_node& leaf = nodes_[iter->second];
+            leaf.tight_min = min;
+            leaf.tight_max = max;
+            if ( contains_bounds(leaf.min, leaf.max, min, max) ) {
+                return false;
+            }
+            const index_type leaf_index = iter->second;
+            remove_leaf_(leaf_index);
+            nodes_[leaf_index].min = min - fat;
+            nodes_[leaf_index].max = max + fat;
+            insert_leaf_(leaf_index);
+            return true;
+        }
+
+        leaves_.reserve(leaves_.size() + 1u);
+        const index_type leaf_index = allocate_node_();
+        tree_node& leaf = nodes_[leaf_index];
+        leaf.min = min - fat;
+        leaf.max = max + fat;
+        leaf.tight_min = min;
+        leaf.tight_max = max;
+        leaf.key = key;
+        leaf.height = 0;
+        insert_leaf_(leaf_index);
+        leaves_.emplace(key, leaf_index);
+        return true;
+    }
+
+    bool spatial_index::remove(key_type key) noexcept {
+        const auto iter = leaves_.find(key);
+        if ( iter == leaves_.end() ) {
+            return false;
+        }
+        remove_leaf_(iter->second);
+        free_node_(iter->second);
+        leaves_.erase(iter);
+        return true;
+    }
+
+    void spatial_index::clear() noexcept {
+        root_ = null_index;
+        free_list_ = null_index;
+        nodes_.clear();
+        leaves_.clear();
+    }
+
+    bool spatial_index::has(key_type key) const noexcept {
+        return leaves_.find(key) != leaves_.end();
+    }
+
+    bool spatial_index::find_bounds(key_type key, b3f& bounds) const noexcept {
+        const auto iter = leaves_.find(key);
+        if ( iter == leaves_.end() ) {
+            return false;
+        }
+        const tree_node& leaf = nodes_[iter->second];
+        bounds = math::make_minmax_aabb(leaf.tight_min, leaf.tight_max);
+        return true;
+    }
+
+    f32 spatial_index::margin() const noexcept {
+        return margin_;
+    }
+
+    std::size_t spatial_index::size() const noexcept {
+        return leaves_.size();
+    }
+
+    std::size_t spatial_index::height() const noexcept {
+        return root_ != null_index
+            ? math::numeric_cast<std::size_t>(nodes_[root_].height)
+            : 0u;
+    }
+
+    spatial_index::index_type spatial_index::allocate_node_() {
+        if ( free_list_ != null_index ) {
+            const index_type index = free_list_;
+            free_list_ = nodes_[index].parent;
+            nodes_[index] = tree_node();
+            return index;
+        }
+        nodes_.emplace_back();
+        return math::numeric_cast<index_type>(nodes_.size() - 1u);
+    }
+
+    void spatial_index::free_node_(index_type index) noexcept {
+        tree_node& n = nodes_[index];
+        n.parent = free_list_;
+        n.child1 = null_index;
+        n.child2 = null_index;
+        n.height = -1;
+        free_list_ = index;
+    }
+
+    void spatial_index::insert_leaf_(index_type leaf) {
+        if ( root_ == null_index ) {
+            root_ = leaf;
+            nodes_[leaf].parent = null_index;
+            return;
+        }
+
+        // find the best sibling by the surface area heuristic
+
+        const v3f leaf_min = nodes_[leaf].min;
+        const v3f leaf_max = nodes_[leaf].max;
+
+        index_type index = root_;
+        while ( !nodes_[index].is_leaf() ) {
+            const tree_node& n = nodes_[index];
+            const tree_node& c1 = nodes_[n.child1];
+            const tree_node& c2 = nodes_[n.child2];
+
+            const f32 cost = bounds_cost(n.min, n.max);
+            const f32 combined_cost = merged_bounds_cost(n.min, n.max, leaf_min, leaf_max);
+
+            const f32 sibling_cost = 2.f * combined_cost;
+            const f32 inheritance_cost = 2.f * (combined_cost - cost);
+
+            const auto descend_cost = [&leaf_min, &leaf_max, inheritance_cost](const tree_node& c) noexcept {
+                const f32 new_cost = merged_bounds_cost(c.min, c.max, leaf_min, leaf_max);
+                return c.is_leaf()
+                    ? new_cost + inheritance_cost
+                    : new_cost - bounds_cost(c.min, c.max) + inheritance_cost;
+            };
+
+            const f32 cost1 = descend_cost(c1);
+            const f32 cost2 = descend_cost(c2);
+
+            if ( sibling_cost < cost1 && sibling_cost < cost2 ) {
+                break;
+            }
+
+            index = cost1 < cost2
+                ? n.child1
+                : n.child2;
+        }
+
+        // create a new parent for the sibling and the leaf
+
+        const index_type sibling = index;
+        const index_type old_parent = nodes_[sibling].parent;
+        const index_type new_parent = allocate_node_();
+
+        nodes_[new_parent].parent = old_parent;
+        nodes_[new_parent].child1 = sibling;
+        nodes_[new_parent].child2 = leaf;
+        nodes_[new_parent].height = nodes_[sibling].height + 1;
+        nodes_[new_parent].min = math::minimized(leaf_min, nodes_[sibling].min);
+        nodes_[new_parent].max = math::maximized(leaf_max, nodes_[sibling].max);
+
+        if ( old_parent != null_index ) {
+            if ( nodes_[old_parent].child1 == sibling ) {
+                nodes_[old_parent].child1 = new_parent;
+            } else {
+                nodes_[old_parent].child2 = new_parent;
+            }
+        } else {
+            root_ = new_parent;
+        }
+
+        nodes_[sibling].parent = new_parent;
+        nodes_[leaf].parent = new_parent;
+
+        refit_(nodes_[leaf].parent);
+    }
+
+    void spatial_index::remove_leaf_(index_type leaf) noexcept {
+        if ( leaf == root_ ) {
+            root_ = null_index;
+            return;
+        }
+
+        const index_type parent = nodes_[leaf].parent;
+        const index_type grand_parent = nodes_[parent].parent;
+        const index_type sibling = nodes_[parent].child1 == leaf
+            ? nodes_[parent].child2
+            : nodes_[parent].child1;
+
+        if ( grand_parent != null_index ) {
+            if ( nodes_[grand_parent].child1 == parent ) {
+                nodes_[grand_parent].child1 = sibling;
+            } else {
+                nodes_[grand_parent].child2 = sibling;
+            }
+            nodes_[sibling].parent = grand_parent;
+            free_node_(parent);
+            refit_(grand_parent);
+        } else {
+            root_ = sibling;
+            nodes_[sibling].parent = null_index;
+            free_node_(parent);
+        }
+
+        nodes_[leaf].parent = null_index;
+    }
+
+    spatial_index::index_type spatial_index::balance_(index_type ia) noexcept {
+        tree_node& a = nodes_[ia];
+        if ( a.is_leaf() || a.height < 2 ) {
+            return ia;
+        }
+
+        const index_type ib = a.child1;
+        const index_type ic = a.child2;
+        tree_node& b = nodes_[ib];
+        tree_node& c = nodes_[ic];
+
+        const auto replace_in_parent = [this](index_type parent, index_type from, index_type to) noexcept {
+            if ( parent == null_index ) {
+                root_ = to;
+            } else if ( nodes_[parent].child1 == from ) {
+                nodes_[parent].child1 = to;
+            } else {
+                nodes_[parent].child2 = to;
+            }
+        };
+
+        const i32 balance = c.height - b.height;
+
+        // rotate c up
+        if ( balance > 1 ) {
+            const index_type i_f = c.child1;
+            const index_type i_g = c.child2;
+            tree_node& f = nodes_[i_f];
+            tree_node& g = nodes_[i_g];
+
+            c.child1 = ia;
+            c.parent = a.parent;
+            a.parent = ic;
+            replace_in_parent(c.parent, ia, ic);
+
+            if ( f.height > g.height ) {
+                c.child2 = i_f;
+                a.child2 = i_g;
+                g.parent = ia;
+                a.min = math::minimized(b.min, g.min);
+                a.max = math::maximized(b.max, g.max);
+                c.min = math::minimized(a.min, f.min);
+                c.max = math::maximized(a.max, f.max);
+                a.height = 1 + math::max(b.height, g.height);
+                c.height = 1 + math::max(a.height, f.height);
+            } else {
+                c.child2 = i_g;
+                a.child2 = i_f;
+                f.parent = ia;
+                a.min = math::minimized(b.min, f.min);
+                a.max = math::maximized(b.max, f.max);
+                c.min = math::minimized(a.min, g.min);
+                c.max = math::maximized(a.max, g.max);
+                a.height = 1 + math::max(b.height, f.height);
+                c.height = 1 + math::max(a.height, g.height);
+            }
+
+            return ic;
+        }
+
+        // rotate b up
+        if ( balance < -1 ) {
+            const index_type i_d = b.child1;
+            const index_type i_e = b.child2;
+            tree_node& d = nodes_[i_d];
+            tree_node& e = nodes_[i_e];
+
+            b.child1 = ia;
+            b.parent = a.parent;
+            a.parent = ib;
+            replace_in_parent(b.parent, ia, ib);
+
+            if ( d.height > e.height ) {
+                b.child2 = i_d;
+                a.child1 = i_e;
+                e.parent = ia;
+                a.min = math::minimized(c.min, e.min);
+                a.max = math::maximized(c.max, e.max);
+                b.min = math::minimized(a.min, d.min);
+                b.max = math::maximized(a.max, d.max);
+                a.height = 1 + math::max(c.height, e.height);
+                b.height = 1 + math::max(a.height, d.height);
+            } else {
+                b.child2 = i_e;
+                a.child1 = i_d;
+                d.parent = ia;
+                a.min = math::minimized(c.min, d.min);
+                a.max = math::maximized(c.max, d.max);
+                b.min = math::minimized(a.min, e.min);
+                b.max = math::maximized(a.max, e.max);
+                a.height = 1 + math::max(c.height, d.height);
+                b.height = 1 + math::max(a.height, e.height);
+            }
+
+            return ib;
+        }
+
+        return ia;
+    }
+
+    void spatial_index::refit_(index_type index) noexcept {
+        while ( index != null_index ) {
+            index = balance_(index);
+            tree_node& n = nodes_[index];
+            const tree_node& c1 = nodes_[n.child1];
+            const tree_node& c2 = nodes_[n.child2];
+            n.height = 1 + math::max(c1.height, c2.height);
+            n.min = math::minimized(c1.min, c2.min);
+            n.max = math::maximized(c1.max, c2.max);
+            index = n.parent;
+        }
+    }
+}
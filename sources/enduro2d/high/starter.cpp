@@ -9,6 +9,23 @@
 #include <enduro2d/high/world.hpp>
 #include <enduro2d/high/factory.hpp>
 #include <enduro2d/high/library.hpp>
+#include <enduro2d/high/image_cache.hpp>
+
+#include <enduro2d/high/assets/atlas_asset.hpp>
+#include <enduro2d/high/assets/binary_asset.hpp>
+#include <enduro2d/high/assets/flipbook_asset.hpp>
+#include <enduro2d/high/assets/image_asset.hpp>
+#include <enduro2d/high/assets/json_asset.hpp>
+#include <enduro2d/high/assets/material_asset.hpp>
+#include <enduro2d/high/assets/mesh_asset.hpp>
+#include <enduro2d/high/assets/model_asset.hpp>
+#include <enduro2d/high/assets/prefab_asset.hpp>
+#include <enduro2d/high/assets/shader_asset.hpp>
+#include <enduro2d/high/assets/shape_asset.hpp>
+#include <enduro2d/high/assets/sprite_asset.hpp>
+#include <enduro2d/high/assets/text_asset.hpp>
+#include <enduro2d/high/assets/texture_asset.hpp>
+#include <enduro2d/high/assets/xml_asset.hpp>
 
 #include <enduro2d/high/components/actor.hpp>
 #include <enduro2d/high/components/camera.hpp>
@@ -21,6 +38,13 @@
 
 #include <enduro2d/high/systems/flipbook_system.hpp>
 #include <enduro2d/high/systems/render_system.hpp>
+#include <enduro2d/high/systems/spatial_index_system.hpp>
+
+#include <3rdparty/imgui/imgui.h>
+
+#if defined(__GNUC__)
+#  include <cxxabi.h>
+#endif
 
 namespace
 {
@@ -33,15 +57,296 @@ namespace
             : modules::initialize<Module>(std::forward<Args>(args)...);
     }
 
+    //
+    // worker_executor
+    //
+    // runs the first task in the calling thread and the rest
+    // on the deferrer worker, returns when all of them are done
+    //
+
+    class worker_executor final {
+    public:
+        template < typename F >
+        void operator()(std::size_t count, const F& task) const {
+            deferrer& d = the<deferrer>();
+
+            vector<stdex::promise<void>> promises;
+            promises.reserve(count);
+            for ( std::size_t i = 1; i < count; ++i ) {
+                promises.push_back(d.do_in_worker_thread([&task, i](){
+                    task(i);
+                }));
+            }
+
+            std::exception_ptr main_exception;
+            try {
+                task(0u);
+            } catch (...) {
+                main_exception = std::current_exception();
+            }
+
+            // helps the worker only, main thread tasks must not
+            // run while the systems of the stage are running
+            const auto zero_us = time::to_chrono(make_microseconds(0));
+            for ( const stdex::promise<void>& p : promises ) {
+                while ( p.wait_for(zero_us) == stdex::promise_wait_status::timeout ) {
+                    if ( 0 == d.worker().active_wait_one().second ) {
+                        std::this_thread::yield();
+                    }
+                }
+            }
+
+            if ( main_exception ) {
+                std::rethrow_exception(main_exception);
+            }
+
+            for ( const stdex::promise<void>& p : promises ) {
+                p.get();
+            }
+        }
+    };
+
+    //
+    // system profiles
+    //
+
+    str system_display_name(const char* name) {
+    #if defined(__GNUC__)
+        int status = 0;
+        char* demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+        if ( demangled ) {
+            str result = status == 0 ? str(demangled) : str(name);
+            std::free(demangled);
+            return result;
+        }
+    #endif
+        return name;
+    }
+
+    str format_system_profiles(const vector<ecs::system_profile>& profiles) {
+        str result = "priority;system;invocations;entities;last_ms;min_ms;avg_ms;max_ms\n";
+        for ( const ecs::system_profile& p : profiles ) {
+            result += strings::rformat(
+                "%0;%1;%2;%3;%4;%5;%6;%7\n",
+                p.priority,
+                system_display_name(p.name),
+                p.invocations,
+                p.entities,
+                p.last_ms,
+                p.min_ms,
+                p.avg_ms,
+                p.max_ms);
+        }
+        return result;
+    }
+
+    //
+    // placeholders
+    //
+
+    // sprites and atlases share texture assets, so they stream their
+    // textures, materials copy the textures and stream as a whole
+    void register_default_placeholders(library& l) {
+        l.register_placeholder<mesh_asset>(mesh())
+            .register_placeholder<model_asset>(model())
+            .register_placeholder<sprite_asset>(sprite())
+            .register_placeholder<material_asset>(render::material());
+        if ( modules::is_initialized<render>() ) {
+            buffer white_pixel(4u);
+            std::fill(white_pixel.data(), white_pixel.data() + white_pixel.size(), u8(0xFF));
+            const texture_ptr white_texture = the<render>().create_texture(
+                image(v2u(1u, 1u), image_data_format::rgba8, std::move(white_pixel)));
+            if ( white_texture ) {
+                l.register_placeholder<texture_asset>(white_texture);
+            }
+        }
+    }
+
+    //
+    // load trace
+    //
+
+    void dump_load_trace(const url& dump) noexcept {
+        try {
+            for ( const tracer::summary& s : the<tracer>().summarize() ) {
+                the<debug>().trace("STARTER: Load trace: %0 %1: count %2, total %3us, max %4us",
+                    s.type,
+                    s.stage,
+                    s.count,
+                    s.total.value,
+                    s.max.value);
+            }
+            str trace;
+            output_stream_uptr stream = the<vfs>().write(dump, false);
+            if ( !the<tracer>().try_save_chrome_trace(trace)
+                || !stream
+                || !streams::try_write_tail(trace, stream) )
+            {
+                the<debug>().error("STARTER: Failed to dump load trace:\n"
+                    "--> Url: %0",
+                    dump);
+            }
+        } catch (...) {
+            // nothing
+        }
+    }
+
+    void show_world_systems(bool* open) {
+        const char* window_title = "World Systems";
+        if ( !ImGui::Begin(window_title, open) ) {
+            ImGui::End();
+            return;
+        }
+        try {
+            ecs::registry& registry = the<world>().registry();
+            {
+                bool profiling = registry.system_profiling();
+                if ( ImGui::Checkbox("profiling", &profiling) ) {
+                    registry.enable_system_profiling(profiling);
+                }
+                ImGui::SameLine();
+                if ( ImGui::Button("reset") ) {
+                    registry.reset_system_profiles();
+                }
+            }
+            ImGui::Separator();
+            ImGui::Columns(6, "systems");
+            {
+                ImGui::Text("system"); ImGui::NextColumn();
+                ImGui::Text("entities"); ImGui::NextColumn();
+                ImGui::Text("last ms"); ImGui::NextColumn();
+                ImGui::Text("min ms"); ImGui::NextColumn();
+                ImGui::Text("avg ms"); ImGui::NextColumn();
+                ImGui::Text("max ms"); ImGui::NextColumn();
+            }
+            ImGui::Separator();
+            for ( const ecs::system_profile& p : registry.system_profiles() ) {
+                ImGui::Text("%s", system_display_name(p.name).c_str()); ImGui::NextColumn();
+                ImGui::Text("%zu", p.entities); ImGui::NextColumn();
+                ImGui::Text("%.3f", p.last_ms); ImGui::NextColumn();
+                ImGui::Text("%.3f", p.min_ms); ImGui::NextColumn();
+                ImGui::Text("%.3f", p.avg_ms); ImGui::NextColumn();
+                ImGui::Text("%.3f", p.max_ms); ImGui::NextColumn();
+            }
+            ImGui::Columns(1);
+        } catch (...) {
+            ImGui::End();
+            throw;
+        }
+        ImGui::End();
+    }
+
+    void show_world_menu() {
+        static bool show_systems = false;
+
+        if ( ImGui::BeginMainMenuBar() ) {
+            if ( ImGui::BeginMenu("World") ) {
+                ImGui::MenuItem("Systems...", nullptr, &show_systems);
+                ImGui::EndMenu();
+            }
+            ImGui::EndMainMenuBar();
+        }
+
+        if ( show_systems ) {
+            show_world_systems(&show_systems);
+        }
+    }
+
+    //
+    // transform_interpolator
+    //
+    // keeps transforms of nodes moved by a fixed step from before
+    // the step and blends them with the current ones while
+    // rendering, nodes are kept by owner entities
+    //
+
+    class transform_interpolator final : private noncopyable {
+    public:
+        void begin_step() {
+            states_.clear();
+            node::begin_transform_step();
+        }
+
+        void end_step() noexcept {
+            try {
+                previous_.clear();
+                node::end_transform_step(previous_);
+                states_.reserve(previous_.size());
+                for ( const auto& p : previous_ ) {
+                    states_.push_back({p.first, p.second, p.second, nullptr});
+                }
+            } catch (...) {
+                // nodes of the step are not interpolated
+                states_.clear();
+            }
+        }
+
+        void apply(f32 factor) {
+            for ( state& s : states_ ) {
+                s.node = find_node_(s.id);
+                if ( !s.node ) {
+                    continue;
+                }
+                s.current = s.node->transform();
+                if ( s.current != s.previous ) {
+                    s.node->transform(math::lerp(s.previous, s.current, factor));
+                }
+            }
+        }
+
+        void restore() noexcept {
+            for ( state& s : states_ ) {
+                if ( s.node && s.current != s.previous ) {
+                    s.node->transform(s.current);
+                }
+                s.node.reset();
+            }
+        }
+    private:
+        struct state {
+            ecs::entity_id id{0u};
+            t3f previous;
+            t3f current;
+            node_iptr node;
+        };
+
+        static node_iptr find_node_(ecs::entity_id id) {
+            world& w = the<world>();
+            if ( !w.registry().valid_entity(id) ) {
+                return nullptr;
+            }
+            const gobject_iptr inst = w.resolve(id);
+            if ( !inst || !inst->get_component<actor>() ) {
+                return nullptr;
+            }
+            return inst->get_component<actor>()->node();
+        }
+    private:
+        vector<state> states_;
+        vector<std::pair<ecs::entity_id, t3f>> previous_;
+    };
+
     class engine_application final : public engine::application {
     public:
-        engine_application(starter::application_uptr application)
-        : application_(std::move(application)) {}
+        engine_application(
+            starter::application_uptr application,
+            const url& profile_dump,
+            const microseconds<u64>& asset_eviction_slice)
+        : application_(std::move(application))
+        , profile_dump_(profile_dump)
+        , asset_eviction_slice_(asset_eviction_slice) {}
 
         bool initialize() final {
+            the<world>().registry().register_owning_group<actor, renderer>();
+            the<world>().registry().register_owning_group<flipbook_player, flipbook_source>();
+            the<world>().registry().enable_system_profiling(
+                !profile_dump_.empty() || modules::is_initialized<dbgui>());
             ecs::registry_filler(the<world>().registry())
-                .system<flipbook_system>(world::priority_update)
-                .system<render_system>(world::priority_render);
+                .system<flipbook_system>(world::priority_update, ecs::system_access()
+                    .reads<flipbook_source>()
+                    .writes<flipbook_player, sprite_renderer>())
+                .system<render_system>(world::priority_render)
+                .system<spatial_index_system>(world::priority_post_render);
             return !application_ || application_->initialize();
         }
 
@@ -49,23 +354,96 @@ namespace
             if ( application_ ) {
                 application_->shutdown();
             }
+            if ( !profile_dump_.empty() ) {
+                dump_system_profiles_();
+            }
         }
 
         bool frame_tick() final {
-            the<world>().registry().process_systems_in_range(
-                world::priority_update_section_begin,
-                world::priority_update_section_end);
+            const bool interpolate = the<engine>().fixed_time_step();
+            if ( interpolate ) {
+                interpolator_.begin_step();
+            }
+            try {
+                the<world>().registry().advance_change_tick();
+                the<world>().registry().process_systems_in_range(
+                    world::priority_update_section_begin,
+                    world::priority_update_section_end,
+                    worker_executor());
+                the<world>().flush_commands();
+            } catch (...) {
+                if ( interpolate ) {
+                    interpolator_.end_step();
+                }
+                throw;
+            }
+            if ( interpolate ) {
+                interpolator_.end_step();
+            }
             return !the<window>().should_close()
                 || (application_ && !application_->on_should_close());
         }
 
         void frame_render() final {
+            if ( modules::is_initialized<dbgui>() && the<dbgui>().visible() ) {
+                show_world_menu();
+            }
+
+            const bool interpolate = the<engine>().fixed_time_step();
+            if ( interpolate ) {
+                interpolator_.apply(the<engine>().interpolation_factor());
+            }
+            try {
+                // render systems only read transforms
+                node::read_scope read_scope;
+                the<world>().registry().process_systems_in_range(
+                    world::priority_render_section_begin,
+                    world::priority_post_render - 1,
+                    worker_executor());
+            } catch (...) {
+                if ( interpolate ) {
+                    interpolator_.restore();
+                }
+                throw;
+            }
+            // post render systems see the simulation state
+            if ( interpolate ) {
+                interpolator_.restore();
+            }
+
             the<world>().registry().process_systems_in_range(
-                world::priority_render_section_begin,
-                world::priority_render_section_end);
+                world::priority_post_render,
+                world::priority_render_section_end,
+                worker_executor());
+            the<world>().flush_commands();
+            // no systems are running, so placeholders can take the streamed content
+            the<library>().fill_streamed_assets();
+            // keeps changes of this frame for systems of the next one
+            the<world>().registry().discard_changes_before(
+                the<world>().registry().change_tick());
+            // the world has released its assets by now
+            the<library>().cache().evict_unused_assets(asset_eviction_slice_);
+        }
+    private:
+        void dump_system_profiles_() const noexcept {
+            try {
+                const str profiles = format_system_profiles(
+                    the<world>().registry().system_profiles());
+                output_stream_uptr stream = the<vfs>().write(profile_dump_, false);
+                if ( !stream || !streams::try_write_tail(profiles, stream) ) {
+                    the<debug>().error("STARTER: Failed to dump system profiles:\n"
+                        "--> Url: %0",
+                        profile_dump_);
+                }
+            } catch (...) {
+                // nothing
+            }
         }
     private:
         starter::application_uptr application_;
+        url profile_dump_;
+        microseconds<u64> asset_eviction_slice_;
+        transform_interpolator interpolator_;
     };
 }
 
@@ -98,6 +476,41 @@ namespace e2d
         return *this;
     }
 
+    starter::parameters& starter::parameters::library_manifest(str_view value) {
+        library_manifest_ = value;
+        return *this;
+    }
+
+    starter::parameters& starter::parameters::image_cache_root(const url& value) {
+        image_cache_root_ = value;
+        return *this;
+    }
+
+    starter::parameters& starter::parameters::profile_dump(const url& value) {
+        profile_dump_ = value;
+        return *this;
+    }
+
+    starter::parameters& starter::parameters::load_trace_dump(const url& value) {
+        load_trace_dump_ = value;
+        return *this;
+    }
+
+    starter::parameters& starter::parameters::asset_memory_budget(std::size_t value) noexcept {
+        asset_memory_budget_ = value;
+        return *this;
+    }
+
+    starter::parameters& starter::parameters::image_cache_capacity(std::size_t value) noexcept {
+        image_cache_capacity_ = value;
+        return *this;
+    }
+
+    starter::parameters& starter::parameters::asset_eviction_slice(const microseconds<u64>& value) noexcept {
+        asset_eviction_slice_ = value;
+        return *this;
+    }
+
     starter::parameters& starter::parameters::engine_params(const engine::parameters& value) {
         engine_params_ = value;
         return *this;
@@ -107,6 +520,34 @@ namespace e2d
         return library_root_;
     }
 
+    str& starter::parameters::library_manifest() noexcept {
+        return library_manifest_;
+    }
+
+    url& starter::parameters::image_cache_root() noexcept {
+        return image_cache_root_;
+    }
+
+    url& starter::parameters::profile_dump() noexcept {
+        return profile_dump_;
+    }
+
+    url& starter::parameters::load_trace_dump() noexcept {
+        return load_trace_dump_;
+    }
+
+    std::size_t& starter::parameters::asset_memory_budget() noexcept {
+        return asset_memory_budget_;
+    }
+
+    std::size_t& starter::parameters::image_cache_capacity() noexcept {
+        return image_cache_capacity_;
+    }
+
+    microseconds<u64>& starter::parameters::asset_eviction_slice() noexcept {
+        return asset_eviction_slice_;
+    }
+
     engine::parameters& starter::parameters::engine_params() noexcept {
         return engine_params_;
     }
@@ -115,6 +556,34 @@ namespace e2d
         return library_root_;
     }
 
+    const str& starter::parameters::library_manifest() const noexcept {
+        return library_manifest_;
+    }
+
+    const url& starter::parameters::image_cache_root() const noexcept {
+        return image_cache_root_;
+    }
+
+    const url& starter::parameters::profile_dump() const noexcept {
+        return profile_dump_;
+    }
+
+    const url& starter::parameters::load_trace_dump() const noexcept {
+        return load_trace_dump_;
+    }
+
+    const std::size_t& starter::parameters::asset_memory_budget() const noexcept {
+        return asset_memory_budget_;
+    }
+
+    const std::size_t& starter::parameters::image_cache_capacity() const noexcept {
+        return image_cache_capacity_;
+    }
+
+    const microseconds<u64>& starter::parameters::asset_eviction_slice() const noexcept {
+        return asset_eviction_slice_;
+    }
+
     const engine::parameters& starter::parameters::engine_params() const noexcept {
         return engine_params_;
     }
@@ -123,7 +592,10 @@ namespace e2d
     // starter
     //
 
-    starter::starter(int argc, char *argv[], const parameters& params) {
+    starter::starter(int argc, char *argv[], const parameters& params)
+    : profile_dump_(params.profile_dump())
+    , load_trace_dump_(params.load_trace_dump())
+    , asset_eviction_slice_(params.asset_eviction_slice()) {
         safe_module_initialize<engine>(argc, argv, params.engine_params());
         safe_module_initialize<factory>()
             .register_component<actor>("actor")
@@ -134,13 +606,47 @@ namespace e2d
             .register_component<renderer>("renderer")
             .register_component<scene>("scene")
             .register_component<sprite_renderer>("sprite_renderer");
-        safe_module_initialize<library>(params.library_root(), the<deferrer>());
+        if ( !load_trace_dump_.empty() ) {
+            safe_module_initialize<tracer>();
+        }
+        if ( !params.image_cache_root().empty() ) {
+            safe_module_initialize<image_cache>(
+                params.image_cache_root(),
+                params.image_cache_capacity(),
+                the<deferrer>());
+        }
+        safe_module_initialize<library>(params.library_root(), the<deferrer>())
+            .register_asset_type<atlas_asset>()
+            .register_asset_type<binary_asset>()
+            .register_asset_type<flipbook_asset>()
+            .register_asset_type<image_asset>()
+            .register_asset_type<json_asset>()
+            .register_asset_type<material_asset>()
+            .register_asset_type<mesh_asset>()
+            .register_asset_type<model_asset>()
+            .register_asset_type<prefab_asset>()
+            .register_asset_type<shader_asset>()
+            .register_asset_type<shape_asset>()
+            .register_asset_type<sprite_asset>()
+            .register_asset_type<text_asset>()
+            .register_asset_type<texture_asset>()
+            .register_asset_type<xml_asset>()
+            .cache().memory_budget(params.asset_memory_budget());
+        register_default_placeholders(the<library>());
+        if ( !params.library_manifest().empty() ) {
+            the<library>().load_manifest(params.library_manifest());
+        }
         safe_module_initialize<world>();
     }
 
     starter::~starter() noexcept {
         modules::shutdown<world>();
         modules::shutdown<library>();
+        modules::shutdown<image_cache>();
+        if ( !load_trace_dump_.empty() && modules::is_initialized<tracer>() ) {
+            dump_load_trace(load_trace_dump_);
+            modules::shutdown<tracer>();
+        }
         modules::shutdown<factory>();
         modules::shutdown<engine>();
     }
@@ -148,6 +654,8 @@ namespace e2d
     bool starter::start(application_uptr app) {
         return the<engine>().start(
             std::make_unique<engine_application>(
-                std::move(app)));
+                std::move(app),
+                profile_dump_,
+                asset_eviction_slice_));
     }
 }
@@ -14,63 +14,37 @@ namespace
 {
     using namespace e2d;
 
-    void update_flipbook_timers(f32 dt, ecs::registry& owner) {
-        owner.for_joined_components<flipbook_player, flipbook_source>([dt](
-            const ecs::const_entity&,
-            flipbook_player& fp,
-            const flipbook_source& fs)
-        {
-            if ( fp.speed() <= 0.f || fp.stopped() ) {
-                return;
-            }
-            const flipbook_asset::ptr& flipbook_res = fs.flipbook();
-            if ( !flipbook_res ) {
-                return;
-            }
-            const flipbook& flipbook = flipbook_res->content();
-            const flipbook::sequence* sequence = flipbook.find_sequence(fp.sequence());
-            if ( !sequence || sequence->frames.empty() ) {
-                return;
-            }
-            fp.time(fp.time() + dt * fp.speed());
-            if ( sequence->fps > 0.f ) {
-                const f32 loop_time = sequence->frames.size() / sequence->fps;
-                if ( fp.time() >= loop_time ) {
-                    if ( fp.looped() ) {
-                        fp.time(math::mod(fp.time(), loop_time));
-                    } else {
-                        fp.stop(loop_time);
-                    }
+    constexpr std::size_t no_frame = std::size_t(-1);
+
+    void advance_flipbook_timer(
+        f32 dt,
+        flipbook_player& fp,
+        const flipbook::sequence& sequence)
+    {
+        if ( fp.speed() <= 0.f || fp.stopped() ) {
+            return;
+        }
+        fp.time(fp.time() + dt * fp.speed());
+        if ( sequence.fps > 0.f ) {
+            const f32 loop_time = sequence.frames.size() / sequence.fps;
+            if ( fp.time() >= loop_time ) {
+                if ( fp.looped() ) {
+                    fp.time(math::mod(fp.time(), loop_time));
+                } else {
+                    fp.stop(loop_time);
                 }
             }
-        });
+        }
     }
 
-    void update_flipbook_sprites(ecs::registry& owner) {
-        owner.for_joined_components<flipbook_player, flipbook_source, sprite_renderer>([](
-            const ecs::const_entity&,
-            const flipbook_player& fp,
-            const flipbook_source& fs,
-            sprite_renderer& sr)
-        {
-            const flipbook_asset::ptr& flipbook_res = fs.flipbook();
-            if ( !flipbook_res ) {
-                sr.sprite(nullptr);
-                return;
-            }
-            const flipbook& flipbook = flipbook_res->content();
-            const flipbook::sequence* sequence = flipbook.find_sequence(fp.sequence());
-            if ( !sequence || sequence->frames.empty() ) {
-                sr.sprite(nullptr);
-                return;
-            }
-            const std::size_t frame_index = math::clamp<std::size_t>(
-                math::numeric_cast<std::size_t>(fp.time() * sequence->fps),
-                0u,
-                sequence->frames.size() - 1u);
-            const flipbook::frame* frame = flipbook.find_frame(sequence->frames[frame_index]);
-            sr.sprite(frame ? frame->sprite : nullptr);
-        });
+    std::size_t flipbook_frame_index(
+        const flipbook_player& fp,
+        const flipbook::sequence& sequence) noexcept
+    {
+        return math::clamp<std::size_t>(
+            math::numeric_cast<std::size_t>(fp.time() * sequence.fps),
+            0u,
+            sequence.frames.size() - 1u);
     }
 }
 
@@ -86,9 +60,105 @@ namespace e2d
         ~internal_state() noexcept = default;
 
         void process(ecs::registry& owner) {
-            update_flipbook_timers(the<engine>().delta_time(), owner);
+            update_flipbook_players(the<engine>().delta_time(), owner);
             update_flipbook_sprites(owner);
         }
+    private:
+        // one pass over the player/source group, remembers players
+        // with a new frame and renderers showing another sprite
+        void update_flipbook_players(f32 dt, ecs::registry& owner) {
+            changed_players_.clear();
+            owner.for_joined_components<flipbook_player, flipbook_source>([this, dt](
+                const ecs::entity& e,
+                flipbook_player& fp,
+                const flipbook_source& fs)
+            {
+                const bool resolved = resolve_flipbook_cache(fp, fs);
+                flipbook_player::playback_cache& cache = fp.cache_;
+                if ( cache.sequence ) {
+                    advance_flipbook_timer(dt, fp, *cache.sequence);
+                }
+                const std::size_t frame = cache.sequence
+                    ? flipbook_frame_index(fp, *cache.sequence)
+                    : no_frame;
+                const bool new_frame = resolved || frame != cache.frame;
+                if ( new_frame ) {
+                    cache.frame = frame;
+                    cache.sprite = find_flipbook_sprite(fp, fs);
+                }
+                // the renderer may be assigned or reset after
+                // the frame was applied, so compare it every time
+                const sprite_renderer* sr = e.find_component<sprite_renderer>();
+                if ( new_frame || (sr && sr->sprite() != cache.sprite) ) {
+                    changed_players_.push_back({e.id(), new_frame});
+                }
+            });
+        }
+
+        // marks are no-ops unless an application
+        // enables change tracking of the components
+        void update_flipbook_sprites(ecs::registry& owner) {
+            for ( const changed_player& cp : changed_players_ ) {
+                ecs::entity e(owner, cp.id);
+                if ( cp.new_frame ) {
+                    owner.mark_component_changed<flipbook_player>(e);
+                }
+                sprite_renderer* sr = e.find_component<sprite_renderer>();
+                if ( !sr ) {
+                    continue;
+                }
+                const sprite_asset::ptr& sprite =
+                    e.get_component<flipbook_player>().cache_.sprite;
+                if ( sr->sprite() != sprite ) {
+                    sr->sprite(sprite);
+                    owner.mark_component_changed<sprite_renderer>(e);
+                }
+            }
+        }
+
+        // returns true if the cache was rebuilt
+        static bool resolve_flipbook_cache(
+            flipbook_player& fp,
+            const flipbook_source& fs)
+        {
+            flipbook_player::playback_cache& cache = fp.cache_;
+            const u64 flipbook_version = fs.flipbook()
+                ? fs.flipbook()->content_version()
+                : 0u;
+            if ( cache.valid && cache.flipbook_version == flipbook_version ) {
+                return false;
+            }
+            const flipbook::sequence* sequence = fs.flipbook()
+                ? fs.flipbook()->content().find_sequence(fp.sequence())
+                : nullptr;
+            cache.flipbook_version = flipbook_version;
+            cache.sequence = sequence && !sequence->frames.empty()
+                ? sequence
+                : nullptr;
+            cache.frame = no_frame;
+            cache.sprite = nullptr;
+            cache.valid = true;
+            return true;
+        }
+
+        static sprite_asset::ptr find_flipbook_sprite(
+            const flipbook_player& fp,
+            const flipbook_source& fs) noexcept
+        {
+            const flipbook_player::playback_cache& cache = fp.cache_;
+            if ( !cache.sequence || cache.frame == no_frame ) {
+                return nullptr;
+            }
+            const flipbook::frame* frame = fs.flipbook()->content().find_frame(
+                cache.sequence->frames[cache.frame]);
+            return frame ? frame->sprite : nullptr;
+        }
+    private:
+        struct changed_player {
+            ecs::entity_id id;
+            bool new_frame;
+        };
+        vector<changed_player> changed_players_;
     };
 
     //
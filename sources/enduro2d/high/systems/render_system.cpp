@@ -8,7 +8,12 @@
 
 #include <enduro2d/high/components/actor.hpp>
 #include <enduro2d/high/components/camera.hpp>
+#include <enduro2d/high/components/model_renderer.hpp>
+#include <enduro2d/high/components/renderer.hpp>
 #include <enduro2d/high/components/scene.hpp>
+#include <enduro2d/high/components/sprite_renderer.hpp>
+
+#include <enduro2d/high/sorted_components.hpp>
 
 #include "render_system_impl/render_system_base.hpp"
 #include "render_system_impl/render_system_batcher.hpp"
@@ -19,74 +24,87 @@ namespace
     using namespace e2d;
     using namespace e2d::render_system_impl;
 
-    template < typename F >
-    void for_each_by_nodes(const const_node_iptr& root, F&& f) {
-        static vector<const_node_iptr> temp_nodes;
-        try {
-            if ( root ) {
-                root->extract_all_nodes(std::back_inserter(temp_nodes));
-                for ( const const_node_iptr& node : temp_nodes ) {
-                    f(node);
-                }
-            }
-        } catch (...) {
-            temp_nodes.clear();
-            throw;
-        }
-        temp_nodes.clear();
+    //
+    // flat_scene_nodes
+    //
+    // nodes of all scenes in the drawing order, shared by all cameras
+    // of the frame, 'subtree_end' allows to skip an invisible subtree
+    //
+
+    struct flat_scene_node {
+        const_node_iptr node;
+        std::size_t subtree_end;
+    };
+
+    void flatten_scene_nodes(
+        const const_node_iptr& root,
+        vector<flat_scene_node>& nodes)
+    {
+        const std::size_t index = nodes.size();
+        nodes.push_back({root, 0u});
+        root->for_each_child([&nodes](const const_node_iptr& child){
+            flatten_scene_nodes(child, nodes);
+        });
+        nodes[index].subtree_end = nodes.size();
     }
 
-    template < typename T, typename Comp, typename F >
-    void for_each_by_sorted_components(ecs::registry& owner, Comp&& comp, F&& f) {
-        static vector<std::pair<ecs::const_entity,T>> temp_components;
-        try {
-            temp_components.reserve(owner.component_count<T>());
-            owner.for_each_component<T>([](const ecs::const_entity& e, const T& t){
-                temp_components.emplace_back(e, t);
-            });
-            std::sort(
-                temp_components.begin(),
-                temp_components.end(),
-                [&comp](const auto& l, const auto& r){
-                    return comp(l.second, r.second);
-                });
-            for ( auto& p : temp_components ) {
-                f(p.first, p.second);
+    void draw_visible_scene_nodes(
+        drawer::context& ctx,
+        const vector<flat_scene_node>& nodes)
+    {
+        for ( std::size_t i = 0, e = nodes.size(); i < e; ) {
+            const flat_scene_node& n = nodes[i];
+            // the whole subtree is skipped by one test
+            if ( n.node->has_world_bounds() && !ctx.visible(n.node->world_bounds()) ) {
+                i = n.subtree_end;
+                continue;
             }
-        } catch (...) {
-            temp_components.clear();
-            throw;
+            ctx.draw(n.node);
+            ++i;
         }
-        temp_components.clear();
     }
 
-    void for_all_scenes(drawer::context& ctx, ecs::registry& owner) {
-        const auto comp = [](const scene& l, const scene& r) noexcept {
-            return l.depth() < r.depth();
-        };
-        const auto func = [&ctx](const ecs::const_entity& scn_e, const scene&) {
-            const actor* scn_a = scn_e.find_component<actor>();
-            if ( scn_a && scn_a->node() ) {
-                for_each_by_nodes(scn_a->node(), [&ctx](const const_node_iptr& node){
-                    ctx.draw(node);
-                });
+    void update_renderer_bounds(ecs::registry& owner) {
+        owner.for_joined_components<actor, renderer>([](
+            const ecs::const_entity& e,
+            actor& a,
+            const renderer&)
+        {
+            const node_iptr n = a.node();
+            if ( !n ) {
+                return;
             }
-        };
-        for_each_by_sorted_components<scene>(owner, comp, func);
-    }
 
-    void for_all_cameras(drawer& drawer, ecs::registry& owner) {
-        const auto comp = [](const camera& l, const camera& r) noexcept {
-            return l.depth() < r.depth();
-        };
-        const auto func = [&drawer, &owner](const ecs::const_entity& cam_e, const camera& cam) {
-            const actor* const cam_a = cam_e.find_component<actor>();
-            const const_node_iptr cam_n = cam_a ? cam_a->node() : nullptr;
-            drawer.with(cam, cam_n, [&owner](drawer::context& ctx){
-                for_all_scenes(ctx, owner);
-            });
-        };
-        for_each_by_sorted_components<camera>(owner, comp, func);
+            bool has_bounds = false;
+            b3f bounds = b3f::zero();
+            const auto merge_bounds = [&has_bounds, &bounds](const b3f& b) noexcept {
+                bounds = has_bounds ? math::merged(bounds, b) : b;
+                has_bounds = true;
+            };
+
+            const model_renderer* mdl_r = e.find_component<model_renderer>();
+            if ( mdl_r && mdl_r->model() ) {
+                merge_bounds(mdl_r->model()->content().bounds());
+            }
+
+            const sprite_renderer* spr_r = e.find_component<sprite_renderer>();
+            if ( spr_r && spr_r->sprite() ) {
+                const sprite& spr = spr_r->sprite()->content();
+                merge_bounds(b3f(
+                    spr.texrect().position.x - spr.pivot().x,
+                    spr.texrect().position.y - spr.pivot().y,
+                    0.f,
+                    spr.texrect().size.x,
+                    spr.texrect().size.y,
+                    0.f));
+            }
+
+            if ( has_bounds ) {
+                n->local_bounds(bounds);
+            } else {
+                n->reset_local_bounds();
+            }
+        });
     }
 }
 
@@ -103,10 +121,42 @@ namespace e2d
         ~internal_state() noexcept = default;
 
         void process(ecs::registry& owner) {
-            for_all_cameras(drawer_, owner);
+            update_renderer_bounds(owner);
+            cameras_.update(owner);
+            scenes_.update(owner);
+            try {
+                flatten_scenes_(owner);
+                draw_cameras_(owner);
+            } catch (...) {
+                scene_nodes_.clear();
+                throw;
+            }
+            scene_nodes_.clear();
+        }
+    private:
+        void flatten_scenes_(const ecs::registry& owner) {
+            scenes_.for_each(owner, [this](const ecs::const_entity& scn_e, const scene&){
+                const actor* scn_a = scn_e.find_component<actor>();
+                if ( scn_a && scn_a->node() ) {
+                    flatten_scene_nodes(scn_a->node(), scene_nodes_);
+                }
+            });
+        }
+
+        void draw_cameras_(const ecs::registry& owner) {
+            cameras_.for_each(owner, [this](const ecs::const_entity& cam_e, const camera& cam){
+                const actor* const cam_a = cam_e.find_component<actor>();
+                const const_node_iptr cam_n = cam_a ? cam_a->node() : nullptr;
+                drawer_.with(cam, cam_n, [this](drawer::context& ctx){
+                    draw_visible_scene_nodes(ctx, scene_nodes_);
+                });
+            });
         }
     private:
         drawer drawer_;
+        sorted_components<camera> cameras_;
+        sorted_components<scene> scenes_;
+        vector<flat_scene_node> scene_nodes_;
     };
 
     //
@@ -45,11 +45,12 @@ namespace e2d::render_system_impl
             ? cam_w_inv.first
             : m4f::identity();
         const m4f& m_p = cam.projection();
+        view_proj_ = m_v * m_p;
 
         batcher_.flush()
             .property(matrix_v_property_hash, m_v)
             .property(matrix_p_property_hash, m_p)
-            .property(matrix_vp_property_hash, m_v * m_p)
+            .property(matrix_vp_property_hash, view_proj_)
             .property(game_time_property_hash, engine.time());
 
         render.execute(render::command_block<3>()
@@ -161,27 +162,30 @@ namespace e2d::render_system_impl
         const f32 px = tex_r.position.x - spr.pivot().x;
         const f32 py = tex_r.position.y - spr.pivot().y;
 
-        const v4f p1{px + 0.f, py + 0.f, 0.f, 1.f};
-        const v4f p2{px + sw,  py + 0.f, 0.f, 1.f};
-        const v4f p3{px + sw,  py + sh,  0.f, 1.f};
-        const v4f p4{px + 0.f, py + sh,  0.f, 1.f};
+        const v2f points[] = {
+            {px + 0.f, py + 0.f},
+            {px + sw,  py + 0.f},
+            {px + sw,  py + sh },
+            {px + 0.f, py + sh }};
 
         const f32 tx = tex_r.position.x / tex_s.x;
         const f32 ty = tex_r.position.y / tex_s.y;
         const f32 tw = tex_r.size.x / tex_s.x;
         const f32 th = tex_r.size.y / tex_s.y;
 
-        const m4f& sm = node->world_matrix();
+        v3f world_points[std::size(points)];
+        math::transform_points(points, std::size(points), node->world_matrix(), world_points);
+
         const color32& tc = spr_r.tint();
 
         const batcher_type::index_type indices[] = {
             0u, 1u, 2u, 2u, 3u, 0u};
 
         const batcher_type::vertex_type vertices[] = {
-            { v3f(p1 * sm), {tx + 0.f, ty + 0.f}, tc },
-            { v3f(p2 * sm), {tx + tw,  ty + 0.f}, tc },
-            { v3f(p3 * sm), {tx + tw,  ty + th }, tc },
-            { v3f(p4 * sm), {tx + 0.f, ty + th }, tc }};
+            { world_points[0], {tx + 0.f, ty + 0.f}, tc },
+            { world_points[1], {tx + tw,  ty + 0.f}, tc },
+            { world_points[2], {tx + tw,  ty + th }, tc },
+            { world_points[3], {tx + 0.f, ty + th }, tc }};
 
         const render::sampler_min_filter min_filter = spr_r.filtering()
             ? render::sampler_min_filter::linear
@@ -211,6 +215,10 @@ namespace e2d::render_system_impl
         property_cache_.clear();
     }
 
+    bool drawer::context::visible(const b3f& bounds) const noexcept {
+        return math::overlaps_frustum(bounds, view_proj_);
+    }
+
     void drawer::context::flush() {
         batcher_.flush();
     }
@@ -52,8 +52,13 @@ namespace e2d::render_system_impl
                 const renderer& node_r,
                 const sprite_renderer& spr_r);
 
+            // returns false when the world space bounds
+            // are entirely outside of the camera frustum
+            bool visible(const b3f& bounds) const noexcept;
+
             void flush();
         private:
+            m4f view_proj_;
             render& render_;
             batcher_type& batcher_;
             render::property_block property_cache_;
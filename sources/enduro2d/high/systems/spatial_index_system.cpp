@@ -0,0 +1,127 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include <enduro2d/high/systems/spatial_index_system.hpp>
+
+#include <enduro2d/high/node.hpp>
+#include <enduro2d/high/world.hpp>
+#include <enduro2d/high/spatial_index.hpp>
+#include <enduro2d/high/components/actor.hpp>
+
+namespace e2d
+{
+    //
+    // spatial_index_system::internal_state
+    //
+
+    class spatial_index_system::internal_state final : private noncopyable {
+    public:
+        internal_state() = default;
+        ~internal_state() noexcept = default;
+
+        void process(ecs::registry& owner) {
+            // runs after rendering, so queries of the next frame
+            // see the scene exactly as it was drawn
+            spatial_index& index = the<world>().spatial();
+            node::read_scope read_scope;
+
+            changed_.clear();
+            const bool complete = node::extract_changed_owners(changed_);
+
+            // actors removed bypassing the world leave their keys
+            if ( !complete || !initialized_ || index.size() > owner.component_count<actor>() ) {
+                rebuild_spatial_index_(index, owner);
+                initialized_ = true;
+            } else {
+                update_spatial_index_(index, owner);
+            }
+        }
+    private:
+        void rebuild_spatial_index_(spatial_index& index, const ecs::registry& owner) {
+            index.clear();
+            owner.for_each_component<actor>([&index](
+                const ecs::const_entity& e,
+                const actor& a)
+            {
+                const const_node_iptr& n = a.node();
+                if ( n && n->has_local_bounds() ) {
+                    index.update(e.id(), n->local_bounds_in_world());
+                }
+            });
+        }
+
+        // only subtrees of changed nodes are visited, each one once
+        void update_spatial_index_(spatial_index& index, const ecs::registry& owner) {
+            if ( changed_.empty() ) {
+                return;
+            }
+
+            changed_set_.clear();
+            changed_set_.insert(changed_.begin(), changed_.end());
+
+            for ( const ecs::entity_id id : changed_set_ ) {
+                const actor* a = owner.valid_entity(id)
+                    ? owner.find_component<actor>(ecs::const_entity(owner, id))
+                    : nullptr;
+                if ( !a || !a->node() ) {
+                    index.remove(id);
+                } else if ( !has_changed_ancestor_(*a->node()) ) {
+                    update_subtree_(index, owner, *a->node());
+                }
+            }
+        }
+
+        bool has_changed_ancestor_(const node& n) const {
+            for ( const_node_iptr p = n.parent(); p; p = p->parent() ) {
+                const const_gobject_iptr p_owner = p->owner();
+                if ( p_owner && changed_set_.count(p_owner->entity().id()) ) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        static void update_subtree_(
+            spatial_index& index,
+            const ecs::registry& owner,
+            const node& n)
+        {
+            const const_gobject_iptr n_owner = n.owner();
+            const ecs::entity_id id = n_owner
+                ? n_owner->entity().id()
+                : ecs::entity_id(0u);
+            const actor* a = n_owner && owner.valid_entity(id)
+                ? owner.find_component<actor>(ecs::const_entity(owner, id))
+                : nullptr;
+            if ( a && a->node().get() == &n ) {
+                if ( n.has_local_bounds() ) {
+                    index.update(id, n.local_bounds_in_world());
+                } else {
+                    index.remove(id);
+                }
+            }
+            n.for_each_child([&index, &owner](const const_node_iptr& child){
+                update_subtree_(index, owner, *child);
+            });
+        }
+    private:
+        bool initialized_{false};
+        vector<ecs::entity_id> changed_;
+        hash_set<ecs::entity_id> changed_set_;
+    };
+
+    //
+    // spatial_index_system
+    //
+
+    spatial_index_system::spatial_index_system()
+    : state_(new internal_state()) {}
+    spatial_index_system::~spatial_index_system() noexcept = default;
+
+    void spatial_index_system::process(ecs::registry& owner) {
+        state_->process(owner);
+    }
+}
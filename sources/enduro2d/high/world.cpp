@@ -9,11 +9,52 @@
 #include <enduro2d/high/node.hpp>
 #include <enduro2d/high/components/actor.hpp>
 
+namespace
+{
+    using namespace e2d;
+
+    constexpr std::size_t invalid_gobject_index = ~std::size_t(0);
+    constexpr std::size_t invalid_plan_index = ~std::size_t(0);
+
+    node_iptr create_instance_node(const gobject_iptr& inst) {
+        auto inst_n = node::create(inst);
+        auto inst_a = inst->get_component<actor>();
+        if ( inst_a && inst_a->node() ) {
+            inst_n->transform(inst_a->node()->transform());
+        }
+        inst_a.assign(inst_n);
+        return inst_n;
+    }
+
+    //
+    // prefab_plan
+    //
+    // prefab hierarchy flattened in pre-order,
+    // parents always precede their children
+    //
+
+    struct prefab_plan_item {
+        const prefab* source{nullptr};
+        std::size_t parent{invalid_plan_index};
+    };
+
+    using prefab_plan = vector<prefab_plan_item>;
+
+    void flatten_prefab(const prefab& source, std::size_t parent, prefab_plan& plan) {
+        plan.push_back({&source, parent});
+        const std::size_t index = plan.size() - 1u;
+        for ( const prefab& child : source.children() ) {
+            flatten_prefab(child, index, plan);
+        }
+    }
+}
+
 namespace e2d
 {
     world::~world() noexcept {
         while ( !gobjects_.empty() ) {
-            destroy_instance(gobjects_.begin()->second);
+            const gobject_iptr inst = gobjects_.back();
+            destroy_instance(inst);
         }
     }
 
@@ -25,17 +66,82 @@ namespace e2d
         return registry_;
     }
 
+    slab_allocator& world::allocator() noexcept {
+        return *allocator_;
+    }
+
+    const slab_allocator& world::allocator() const noexcept {
+        return *allocator_;
+    }
+
+    spatial_index& world::spatial() noexcept {
+        return spatial_;
+    }
+
+    const spatial_index& world::spatial() const noexcept {
+        return spatial_;
+    }
+
+    ecs::command_buffer& world::commands() {
+        std::lock_guard<std::mutex> guard(commands_mutex_);
+        const std::thread::id thread_id = std::this_thread::get_id();
+        const auto iter = std::find_if(
+            commands_.begin(), commands_.end(),
+            [&thread_id](const auto& p) noexcept {
+                return p.first == thread_id;
+            });
+        if ( iter != commands_.end() ) {
+            return *iter->second;
+        }
+        commands_.emplace_back(thread_id, std::make_unique<ecs::command_buffer>());
+        return *commands_.back().second;
+    }
+
+    void world::flush_commands() {
+        E2D_ASSERT(is_in_main_thread());
+
+        // buffers are taken over, so commands recorded from now on
+        // go to new ones and are played back by the next flush
+        vector<std::pair<
+            std::thread::id,
+            std::unique_ptr<ecs::command_buffer>>> buffers;
+        {
+            std::lock_guard<std::mutex> guard(commands_mutex_);
+            buffers.swap(commands_);
+        }
+
+        const ecs::entity_destroyer destroyer = [this](ecs::registry& owner, ecs::entity_id ent){
+            const std::size_t index = find_gobject_(ent);
+            if ( index != invalid_gobject_index ) {
+                const gobject_iptr inst = gobjects_[index];
+                destroy_instance(inst);
+            } else {
+                owner.destroy_entity(ent);
+            }
+        };
+
+        for ( const auto& p : buffers ) {
+            p.second->playback(registry_, destroyer);
+        }
+    }
+
+    void world::instantiate_deferred(const prefab& prefab) {
+        commands().invoke([this, prefab](ecs::registry&){
+            instantiate(prefab);
+        });
+    }
+
+    void world::destroy_instance_deferred(ecs::entity_id ent) {
+        commands().destroy_entity(ent);
+    }
+
     gobject_iptr world::instantiate() {
+        slab_allocator::scope allocator_scope(*allocator_);
         auto inst = make_intrusive<gobject>(registry_);
-        gobjects_.emplace(inst->entity().id(), inst);
+        insert_gobject_(inst);
 
         try {
-            auto inst_n = node::create(inst);
-            auto inst_a = inst->get_component<actor>();
-            if ( inst_a && inst_a->node() ) {
-                inst_n->transform(inst_a->node()->transform());
-            }
-            inst_a.assign(inst_n);
+            create_instance_node(inst);
         } catch (...) {
             destroy_instance(inst);
             throw;
@@ -45,16 +151,12 @@ namespace e2d
     }
 
     gobject_iptr world::instantiate(const prefab& prefab) {
+        slab_allocator::scope allocator_scope(*allocator_);
         auto inst = make_intrusive<gobject>(registry_, prefab.prototype());
-        gobjects_.emplace(inst->entity().id(), inst);
+        insert_gobject_(inst);
 
         try {
-            auto inst_n = node::create(inst);
-            auto inst_a = inst->get_component<actor>();
-            if ( inst_a && inst_a->node() ) {
-                inst_n->transform(inst_a->node()->transform());
-            }
-            inst_a.assign(inst_n);
+            create_instance_node(inst);
         } catch (...) {
             destroy_instance(inst);
             throw;
@@ -80,6 +182,14 @@ namespace e2d
         return inst;
     }
 
+    vector<gobject_iptr> world::instantiate_many(const prefab& prefab, std::size_t count) {
+        return instantiate_many_(prefab, count, nullptr);
+    }
+
+    vector<gobject_iptr> world::instantiate_many(const prefab& prefab, const vector<t3f>& transforms) {
+        return instantiate_many_(prefab, transforms.size(), transforms.data());
+    }
+
     void world::destroy_instance(const gobject_iptr& inst) noexcept {
         node_iptr inst_n = inst && inst->get_component<actor>()
             ? inst->get_component<actor>()->node()
@@ -91,23 +201,133 @@ namespace e2d
         }
         if ( inst ) {
             inst->entity().remove_all_components();
-            gobjects_.erase(inst->entity().id());
+            spatial_.remove(inst->entity().id());
+            erase_gobject_(inst->entity().id());
         }
     }
 
     gobject_iptr world::resolve(ecs::entity_id ent) const noexcept {
         E2D_ASSERT(registry_.valid_entity(ent));
-        const auto iter = gobjects_.find(ent);
-        return iter != gobjects_.end()
-            ? iter->second
+        const std::size_t index = find_gobject_(ent);
+        return index != invalid_gobject_index
+            ? gobjects_[index]
             : nullptr;
     }
 
     gobject_iptr world::resolve(const ecs::const_entity& ent) const noexcept {
-        E2D_ASSERT(registry_.valid_entity(ent));
-        const auto iter = gobjects_.find(ent.id());
-        return iter != gobjects_.end()
-            ? iter->second
-            : nullptr;
+        return resolve(ent.id());
+    }
+
+    std::size_t world::instance_count() const noexcept {
+        return gobjects_.size();
+    }
+
+    vector<gobject_iptr> world::instantiate_many_(
+        const prefab& prefab,
+        std::size_t count,
+        const t3f* transforms)
+    {
+        slab_allocator::scope allocator_scope(*allocator_);
+
+        prefab_plan plan;
+        flatten_prefab(prefab, invalid_plan_index, plan);
+        const std::size_t total = plan.size() * count;
+
+        registry_.reserve_entities(registry_.entity_count() + total);
+        registry_.reserve_components<actor>(registry_.component_count<actor>() + total);
+        {
+            ecs::component_reservation reservation;
+            for ( const prefab_plan_item& item : plan ) {
+                reservation.add(item.source->prototype(), count);
+            }
+            reservation.reserve(registry_);
+        }
+
+        gobject_ids_.reserve(gobject_ids_.size() + total);
+        gobjects_.reserve(gobjects_.size() + total);
+
+        vector<gobject_iptr> roots;
+        roots.reserve(count);
+
+        vector<node_iptr> nodes(plan.size());
+
+        try {
+            for ( std::size_t i = 0; i < count; ++i ) {
+                for ( std::size_t j = 0; j < plan.size(); ++j ) {
+                    const prefab_plan_item& item = plan[j];
+                    auto inst = make_intrusive<gobject>(registry_, item.source->prototype());
+                    insert_gobject_(inst);
+
+                    try {
+                        nodes[j] = create_instance_node(inst);
+                        if ( item.parent != invalid_plan_index ) {
+                            nodes[item.parent]->add_child(nodes[j]);
+                        } else if ( transforms ) {
+                            nodes[j]->transform(transforms[i]);
+                        }
+                    } catch (...) {
+                        destroy_instance(inst);
+                        throw;
+                    }
+
+                    if ( item.parent == invalid_plan_index ) {
+                        roots.push_back(std::move(inst));
+                    }
+                }
+            }
+        } catch (...) {
+            for ( const gobject_iptr& root : roots ) {
+                destroy_instance(root);
+            }
+            throw;
+        }
+
+        return roots;
+    }
+
+    std::size_t world::find_gobject_(ecs::entity_id ent) const noexcept {
+        const std::size_t slot = ecs::detail::entity_id_index(ent);
+        if ( slot >= gobject_slots_.size() || !gobject_slots_[slot] ) {
+            return invalid_gobject_index;
+        }
+        const std::size_t index = gobject_slots_[slot] - 1u;
+        return gobject_ids_[index] == ent
+            ? index
+            : invalid_gobject_index;
+    }
+
+    void world::insert_gobject_(const gobject_iptr& inst) {
+        const ecs::entity_id ent = inst->entity().id();
+        const std::size_t slot = ecs::detail::entity_id_index(ent);
+        E2D_ASSERT(find_gobject_(ent) == invalid_gobject_index);
+
+        if ( slot >= gobject_slots_.size() ) {
+            gobject_slots_.resize(slot + 1u, 0u);
+        }
+        gobject_ids_.reserve(gobject_ids_.size() + 1u);
+        gobjects_.reserve(gobjects_.size() + 1u);
+
+        gobject_ids_.push_back(ent);
+        gobjects_.push_back(inst);
+        gobject_slots_[slot] = math::numeric_cast<u32>(gobjects_.size());
+    }
+
+    void world::erase_gobject_(ecs::entity_id ent) noexcept {
+        const std::size_t index = find_gobject_(ent);
+        if ( index == invalid_gobject_index ) {
+            return;
+        }
+
+        const std::size_t last_index = gobjects_.size() - 1u;
+        if ( index != last_index ) {
+            const std::size_t last_slot = ecs::detail::entity_id_index(gobject_ids_[last_index]);
+            gobject_slots_[last_slot] = math::numeric_cast<u32>(index + 1u);
+            gobject_ids_[index] = gobject_ids_[last_index];
+            gobjects_[index] = std::move(gobjects_[last_index]);
+        }
+
+        gobject_slots_[ecs::detail::entity_id_index(ent)] = 0u;
+        gobject_ids_.pop_back();
+        gobjects_.pop_back();
     }
 }
@@ -53,6 +53,14 @@ namespace e2d::filesystem
         return impl::directory_exists(path);
     }
 
+    bool try_get_write_time(microseconds<u64>& dst, str_view path) noexcept {
+        try {
+            return impl::file_write_time(path, dst);
+        } catch (...) {
+            return false;
+        }
+    }
+
     bool create_file(str_view path) {
         return create_directory_recursive(path::parent_path(path))
             && make_write_file(path, true);
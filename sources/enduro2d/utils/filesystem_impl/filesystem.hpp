@@ -7,6 +7,7 @@
 #pragma once
 
 #include <enduro2d/utils/path.hpp>
+#include <enduro2d/utils/time.hpp>
 #include <enduro2d/utils/strings.hpp>
 #include <enduro2d/utils/filesystem.hpp>
 
@@ -18,6 +19,8 @@ namespace e2d::filesystem::impl
     bool file_exists(str_view path);
     bool directory_exists(str_view path);
 
+    bool file_write_time(str_view path, microseconds<u64>& dst);
+
     bool create_directory(str_view path);
 
     bool trace_directory(str_view path, const trace_func& func);
@@ -112,6 +112,17 @@ namespace e2d::filesystem::impl
             && S_ISDIR(st.st_mode);
     }
 
+    bool file_write_time(str_view path, microseconds<u64>& dst) {
+        struct stat st{};
+        if ( 0 != ::stat(make_utf8(path).c_str(), &st) || !S_ISREG(st.st_mode) ) {
+            return false;
+        }
+        dst = make_microseconds<u64>(
+            static_cast<u64>(st.st_mtimespec.tv_sec) * 1000000u +
+            static_cast<u64>(st.st_mtimespec.tv_nsec) / 1000u);
+        return true;
+    }
+
     bool create_directory(str_view path) {
         return 0 == ::mkdir(make_utf8(path).c_str(), default_directory_mode)
             || errno == EEXIST;
@@ -122,6 +122,25 @@ namespace e2d::filesystem::impl
             && (attributes & FILE_ATTRIBUTE_DIRECTORY);
     }
 
+    bool file_write_time(str_view path, microseconds<u64>& dst) {
+        const wstr wide_path = make_wide(path);
+        WIN32_FILE_ATTRIBUTE_DATA data{};
+        if ( !::GetFileAttributesExW(wide_path.c_str(), GetFileExInfoStandard, &data)
+            || (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) )
+        {
+            return false;
+        }
+        // 100-nanosecond intervals since 1601-01-01 to microseconds since 1970-01-01
+        const u64 file_time =
+            (static_cast<u64>(data.ftLastWriteTime.dwHighDateTime) << 32u) |
+            static_cast<u64>(data.ftLastWriteTime.dwLowDateTime);
+        const u64 epoch_difference = 116444736000000000ull;
+        dst = make_microseconds<u64>(file_time > epoch_difference
+            ? (file_time - epoch_difference) / 10u
+            : 0u);
+        return true;
+    }
+
     bool create_directory(str_view path) {
         const wstr wide_path = make_wide(path);
         return ::CreateDirectoryW(wide_path.c_str(), nullptr)
@@ -9,6 +9,63 @@
 #include <enduro2d/utils/image.hpp>
 #include <enduro2d/utils/buffer.hpp>
 
+namespace e2d::images::impl::dds
+{
+    const u32 magic = 0x20534444u; // "DDS "
+
+    const u32 flag_caps = 0x1u;
+    const u32 flag_height = 0x2u;
+    const u32 flag_width = 0x4u;
+    const u32 flag_pitch = 0x8u;
+    const u32 flag_pixel_format = 0x1000u;
+    const u32 flag_linear_size = 0x80000u;
+
+    const u32 pf_alpha_pixels = 0x1u;
+    const u32 pf_fourcc = 0x4u;
+    const u32 pf_rgb = 0x40u;
+    const u32 pf_luminance = 0x20000u;
+
+    const u32 caps_texture = 0x1000u;
+
+    constexpr u32 make_fourcc(char a, char b, char c, char d) noexcept {
+        return static_cast<u32>(static_cast<u8>(a))
+            | (static_cast<u32>(static_cast<u8>(b)) << 8u)
+            | (static_cast<u32>(static_cast<u8>(c)) << 16u)
+            | (static_cast<u32>(static_cast<u8>(d)) << 24u);
+    }
+
+    struct pixel_format {
+        u32 size{32u};
+        u32 flags{0u};
+        u32 fourcc{0u};
+        u32 rgb_bit_count{0u};
+        u32 r_mask{0u};
+        u32 g_mask{0u};
+        u32 b_mask{0u};
+        u32 a_mask{0u};
+    };
+
+    struct header {
+        u32 size{124u};
+        u32 flags{0u};
+        u32 height{0u};
+        u32 width{0u};
+        u32 pitch_or_linear_size{0u};
+        u32 depth{0u};
+        u32 mipmap_count{0u};
+        u32 reserved1[11]{};
+        pixel_format format;
+        u32 caps{0u};
+        u32 caps2{0u};
+        u32 caps3{0u};
+        u32 caps4{0u};
+        u32 reserved2{0u};
+    };
+
+    static_assert(sizeof(pixel_format) == 32u, "unexpected dds layout");
+    static_assert(sizeof(header) == 124u, "unexpected dds layout");
+}
+
 namespace e2d::images::impl
 {
     bool try_load_image_dds(image& dst, const buffer& src) noexcept;
@@ -6,11 +6,123 @@
 
 #include "image_impl.hpp"
 
+namespace
+{
+    using namespace e2d;
+    using namespace e2d::images::impl;
+
+    bool image_format_from_dds(image_data_format& dst, const dds::pixel_format& pf) noexcept {
+        if ( pf.flags & dds::pf_fourcc ) {
+            if ( pf.fourcc == dds::make_fourcc('D','X','T','1') ) {
+                dst = (pf.flags & dds::pf_alpha_pixels)
+                    ? image_data_format::rgba_dxt1
+                    : image_data_format::rgb_dxt1;
+                return true;
+            }
+            if ( pf.fourcc == dds::make_fourcc('D','X','T','3') ) {
+                dst = image_data_format::rgba_dxt3;
+                return true;
+            }
+            if ( pf.fourcc == dds::make_fourcc('D','X','T','5') ) {
+                dst = image_data_format::rgba_dxt5;
+                return true;
+            }
+            return false;
+        }
+
+        if ( pf.flags & dds::pf_luminance ) {
+            if ( pf.rgb_bit_count == 8u && pf.r_mask == 0xFFu ) {
+                dst = image_data_format::g8;
+                return true;
+            }
+            if ( pf.rgb_bit_count == 16u
+                && (pf.flags & dds::pf_alpha_pixels)
+                && pf.r_mask == 0xFFu
+                && pf.a_mask == 0xFF00u )
+            {
+                dst = image_data_format::ga8;
+                return true;
+            }
+            return false;
+        }
+
+        if ( pf.flags & dds::pf_rgb ) {
+            const bool rgb_masks =
+                pf.r_mask == 0xFFu &&
+                pf.g_mask == 0xFF00u &&
+                pf.b_mask == 0xFF0000u;
+            if ( rgb_masks && pf.rgb_bit_count == 24u ) {
+                dst = image_data_format::rgb8;
+                return true;
+            }
+            if ( rgb_masks
+                && pf.rgb_bit_count == 32u
+                && (pf.flags & dds::pf_alpha_pixels)
+                && pf.a_mask == 0xFF000000u )
+            {
+                dst = image_data_format::rgba8;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    std::size_t dds_image_data_size(const v2u& size, image_data_format format) noexcept {
+        const std::size_t blocks =
+            std::size_t((size.x + 3u) / 4u) *
+            std::size_t((size.y + 3u) / 4u);
+        const std::size_t pixels = std::size_t(size.x) * size.y;
+        switch ( format ) {
+            case image_data_format::g8: return pixels;
+            case image_data_format::ga8: return pixels * 2u;
+            case image_data_format::rgb8: return pixels * 3u;
+            case image_data_format::rgba8: return pixels * 4u;
+            case image_data_format::rgb_dxt1:
+            case image_data_format::rgba_dxt1: return blocks * 8u;
+            case image_data_format::rgba_dxt3:
+            case image_data_format::rgba_dxt5: return blocks * 16u;
+            default: return 0u;
+        }
+    }
+}
+
 namespace e2d::images::impl
 {
     bool try_load_image_dds(image& dst, const buffer& src) noexcept {
-        //TODO(BlackMat): implme
-        E2D_UNUSED(dst, src);
-        return false;
+        try {
+            u32 magic = 0u;
+            dds::header header;
+            if ( src.size() < sizeof(magic) + sizeof(header) ) {
+                return false;
+            }
+
+            std::memcpy(&magic, src.data(), sizeof(magic));
+            std::memcpy(&header, src.data() + sizeof(magic), sizeof(header));
+            if ( magic != dds::magic
+                || header.size != sizeof(header)
+                || header.format.size != sizeof(dds::pixel_format) )
+            {
+                return false;
+            }
+
+            image_data_format format = image_data_format::rgba8;
+            if ( !image_format_from_dds(format, header.format) ) {
+                return false;
+            }
+
+            // only the top mipmap level is loaded
+            const v2u size(header.width, header.height);
+            const std::size_t data_offset = sizeof(magic) + sizeof(header);
+            const std::size_t data_size = dds_image_data_size(size, format);
+            if ( !data_size || src.size() - data_offset < data_size ) {
+                return false;
+            }
+
+            dst.assign(size, format, buffer(src.data() + data_offset, data_size));
+            return true;
+        } catch (...) {
+            return false;
+        }
     }
 }
@@ -9,32 +9,99 @@
 namespace
 {
     using namespace e2d;
+    using namespace e2d::images::impl;
 
-    bool is_save_image_dds_supported(image_data_format data_format) noexcept {
-        switch ( data_format ) {
+    bool dds_pixel_format_from_image(dds::pixel_format& dst, image_data_format format) noexcept {
+        dds::pixel_format pf;
+        switch ( format ) {
             case image_data_format::g8:
+                pf.flags = dds::pf_luminance;
+                pf.rgb_bit_count = 8u;
+                pf.r_mask = 0xFFu;
+                break;
             case image_data_format::ga8:
+                pf.flags = dds::pf_luminance | dds::pf_alpha_pixels;
+                pf.rgb_bit_count = 16u;
+                pf.r_mask = 0xFFu;
+                pf.a_mask = 0xFF00u;
+                break;
             case image_data_format::rgb8:
+                pf.flags = dds::pf_rgb;
+                pf.rgb_bit_count = 24u;
+                pf.r_mask = 0xFFu;
+                pf.g_mask = 0xFF00u;
+                pf.b_mask = 0xFF0000u;
+                break;
             case image_data_format::rgba8:
+                pf.flags = dds::pf_rgb | dds::pf_alpha_pixels;
+                pf.rgb_bit_count = 32u;
+                pf.r_mask = 0xFFu;
+                pf.g_mask = 0xFF00u;
+                pf.b_mask = 0xFF0000u;
+                pf.a_mask = 0xFF000000u;
+                break;
             case image_data_format::rgb_dxt1:
+                pf.flags = dds::pf_fourcc;
+                pf.fourcc = dds::make_fourcc('D','X','T','1');
+                break;
             case image_data_format::rgba_dxt1:
+                pf.flags = dds::pf_fourcc | dds::pf_alpha_pixels;
+                pf.fourcc = dds::make_fourcc('D','X','T','1');
+                break;
             case image_data_format::rgba_dxt3:
+                pf.flags = dds::pf_fourcc;
+                pf.fourcc = dds::make_fourcc('D','X','T','3');
+                break;
             case image_data_format::rgba_dxt5:
-                return true;
+                pf.flags = dds::pf_fourcc;
+                pf.fourcc = dds::make_fourcc('D','X','T','5');
+                break;
             default:
                 return false;
         }
+        dst = pf;
+        return true;
     }
 }
 
 namespace e2d::images::impl
 {
     bool try_save_image_dds(const image& src, buffer& dst) noexcept {
-        E2D_UNUSED(src, dst);
-        if ( is_save_image_dds_supported(src.format()) ) {
-            //TODO(BlackMat): implme
-            E2D_ASSERT_MSG(false, "implme");
+        try {
+            dds::header header;
+            if ( !dds_pixel_format_from_image(header.format, src.format()) ) {
+                return false;
+            }
+
+            const bool compressed = !!(header.format.flags & dds::pf_fourcc);
+            header.flags =
+                dds::flag_caps |
+                dds::flag_height |
+                dds::flag_width |
+                dds::flag_pixel_format |
+                (compressed ? dds::flag_linear_size : dds::flag_pitch);
+            header.height = src.size().y;
+            header.width = src.size().x;
+            header.pitch_or_linear_size = compressed
+                ? math::numeric_cast<u32>(src.data().size())
+                : src.size().x * header.format.rgb_bit_count / 8u;
+            header.caps = dds::caps_texture;
+
+            const u32 magic = dds::magic;
+            buffer result(sizeof(magic) + sizeof(header) + src.data().size());
+            std::memcpy(result.data(), &magic, sizeof(magic));
+            std::memcpy(result.data() + sizeof(magic), &header, sizeof(header));
+            if ( !src.data().empty() ) {
+                std::memcpy(
+                    result.data() + sizeof(magic) + sizeof(header),
+                    src.data().data(),
+                    src.data().size());
+            }
+
+            dst = std::move(result);
+            return true;
+        } catch (...) {
+            return false;
         }
-        return false;
     }
 }
@@ -6,6 +6,7 @@
 
 #include <enduro2d/utils/json_utils.hpp>
 
+#include <enduro2d/utils/buffer.hpp>
 #include <enduro2d/utils/color.hpp>
 #include <enduro2d/utils/color32.hpp>
 #include <enduro2d/utils/strings.hpp>
@@ -638,6 +639,254 @@ namespace
     }
 }
 
+namespace
+{
+    using namespace e2d;
+
+    const u32 cooked_json_version = 1u;
+    const str_view cooked_json_signature = "e2d_json";
+
+    enum class cooked_json_kind : u32 {
+        null_value,
+        false_value,
+        true_value,
+        int64_value,
+        uint64_value,
+        double_value,
+        string_value,
+        array_value,
+        object_value
+    };
+
+    // objects are followed by name and value pairs,
+    // arrays by their items, both are counted in 'size'
+    struct cooked_json_value {
+        u32 kind{0u};
+        u32 size{0u};
+        u64 data{0u};
+    };
+    static_assert(sizeof(cooked_json_value) == 16u, "unexpected cooked json layout");
+
+    struct cooked_json_header {
+        char signature[8]{};
+        u32 version{0u};
+        u32 value_count{0u};
+        u32 string_size{0u};
+        u32 schema{0u};
+    };
+    static_assert(sizeof(cooked_json_header) == 24u, "unexpected cooked json layout");
+
+    class cooked_json_writer final {
+    public:
+        void write(const rapidjson::Value& root) {
+            switch ( root.GetType() ) {
+                case rapidjson::kNullType:
+                    add_value_(cooked_json_kind::null_value, 0u, 0u);
+                    break;
+                case rapidjson::kFalseType:
+                    add_value_(cooked_json_kind::false_value, 0u, 0u);
+                    break;
+                case rapidjson::kTrueType:
+                    add_value_(cooked_json_kind::true_value, 0u, 0u);
+                    break;
+                case rapidjson::kStringType:
+                    add_string_(root.GetString(), root.GetStringLength());
+                    break;
+                case rapidjson::kNumberType:
+                    if ( root.IsDouble() ) {
+                        const f64 d = root.GetDouble();
+                        u64 bits = 0u;
+                        std::memcpy(&bits, &d, sizeof(bits));
+                        add_value_(cooked_json_kind::double_value, 0u, bits);
+                    } else if ( root.IsUint64() ) {
+                        add_value_(cooked_json_kind::uint64_value, 0u, root.GetUint64());
+                    } else {
+                        add_value_(
+                            cooked_json_kind::int64_value,
+                            0u,
+                            static_cast<u64>(root.GetInt64()));
+                    }
+                    break;
+                case rapidjson::kArrayType:
+                    add_value_(cooked_json_kind::array_value, root.Size(), 0u);
+                    for ( rapidjson::SizeType i = 0; i < root.Size(); ++i ) {
+                        write(root[i]);
+                    }
+                    break;
+                case rapidjson::kObjectType:
+                    add_value_(cooked_json_kind::object_value, root.MemberCount(), 0u);
+                    for ( auto member = root.MemberBegin(); member != root.MemberEnd(); ++member ) {
+                        add_string_(member->name.GetString(), member->name.GetStringLength());
+                        write(member->value);
+                    }
+                    break;
+                default:
+                    throw json_utils_exception();
+            }
+        }
+
+        void flush(buffer& dst, u32 schema) const {
+            cooked_json_header header;
+            std::memcpy(
+                header.signature,
+                cooked_json_signature.data(),
+                cooked_json_signature.size());
+            header.version = cooked_json_version;
+            header.value_count = math::numeric_cast<u32>(values_.size());
+            header.string_size = math::numeric_cast<u32>(strings_.size());
+            header.schema = schema;
+
+            const std::size_t values_size = values_.size() * sizeof(cooked_json_value);
+            buffer result(sizeof(header) + values_size + strings_.size());
+            std::memcpy(result.data(), &header, sizeof(header));
+            if ( values_size ) {
+                std::memcpy(result.data() + sizeof(header), values_.data(), values_size);
+            }
+            if ( !strings_.empty() ) {
+                std::memcpy(
+                    result.data() + sizeof(header) + values_size,
+                    strings_.data(),
+                    strings_.size());
+            }
+            dst = std::move(result);
+        }
+    private:
+        void add_value_(cooked_json_kind kind, std::size_t size, u64 data) {
+            cooked_json_value value;
+            value.kind = static_cast<u32>(kind);
+            value.size = math::numeric_cast<u32>(size);
+            value.data = data;
+            values_.push_back(value);
+        }
+
+        void add_string_(const char* str, std::size_t length) {
+            add_value_(cooked_json_kind::string_value, length, strings_.size());
+            strings_.append(str, length);
+        }
+    private:
+        vector<cooked_json_value> values_;
+        str strings_;
+    };
+
+    class cooked_json_reader final {
+    public:
+        cooked_json_reader(
+            const u8* values,
+            std::size_t value_count,
+            const char* strings,
+            std::size_t string_size,
+            rapidjson::Document::AllocatorType& allocator) noexcept
+        : values_(values)
+        , value_count_(value_count)
+        , strings_(strings)
+        , string_size_(string_size)
+        , allocator_(allocator) {}
+
+        bool read(rapidjson::Value& dst) {
+            if ( !read_value_(dst) ) {
+                return false;
+            }
+            return next_value_ == value_count_;
+        }
+    private:
+        bool read_value_(rapidjson::Value& dst) {
+            cooked_json_value value;
+            if ( !next_(value) ) {
+                return false;
+            }
+            switch ( static_cast<cooked_json_kind>(value.kind) ) {
+                case cooked_json_kind::null_value:
+                    dst.SetNull();
+                    return true;
+                case cooked_json_kind::false_value:
+                    dst.SetBool(false);
+                    return true;
+                case cooked_json_kind::true_value:
+                    dst.SetBool(true);
+                    return true;
+                case cooked_json_kind::int64_value:
+                    dst.SetInt64(static_cast<i64>(value.data));
+                    return true;
+                case cooked_json_kind::uint64_value:
+                    dst.SetUint64(value.data);
+                    return true;
+                case cooked_json_kind::double_value: {
+                    f64 d = 0.0;
+                    std::memcpy(&d, &value.data, sizeof(d));
+                    dst.SetDouble(d);
+                    return true;
+                }
+                case cooked_json_kind::string_value:
+                    return read_string_(value, dst);
+                case cooked_json_kind::array_value:
+                    // every item takes one value at least, so the reserve
+                    // of a damaged size is bounded by the values left
+                    if ( value.size > value_count_ - next_value_ ) {
+                        return false;
+                    }
+                    dst.SetArray();
+                    dst.Reserve(value.size, allocator_);
+                    for ( u32 i = 0; i < value.size; ++i ) {
+                        rapidjson::Value item;
+                        if ( !read_value_(item) ) {
+                            return false;
+                        }
+                        dst.PushBack(item, allocator_);
+                    }
+                    return true;
+                case cooked_json_kind::object_value:
+                    if ( value.size > (value_count_ - next_value_) / 2u ) {
+                        return false;
+                    }
+                    dst.SetObject();
+                    for ( u32 i = 0; i < value.size; ++i ) {
+                        cooked_json_value name_value;
+                        rapidjson::Value name;
+                        rapidjson::Value member;
+                        if ( !next_(name_value)
+                            || name_value.kind != static_cast<u32>(cooked_json_kind::string_value)
+                            || !read_string_(name_value, name)
+                            || !read_value_(member) )
+                        {
+                            return false;
+                        }
+                        dst.AddMember(name, member, allocator_);
+                    }
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        bool read_string_(const cooked_json_value& value, rapidjson::Value& dst) {
+            if ( value.data > string_size_ || value.size > string_size_ - value.data ) {
+                return false;
+            }
+            dst.SetString(
+                strings_ + value.data,
+                math::numeric_cast<rapidjson::SizeType>(value.size),
+                allocator_);
+            return true;
+        }
+
+        bool next_(cooked_json_value& dst) noexcept {
+            if ( next_value_ >= value_count_ ) {
+                return false;
+            }
+            std::memcpy(&dst, values_ + next_value_ * sizeof(dst), sizeof(dst));
+            ++next_value_;
+            return true;
+        }
+    private:
+        const u8* values_{nullptr};
+        std::size_t value_count_{0u};
+        const char* strings_{nullptr};
+        std::size_t string_size_{0u};
+        rapidjson::Document::AllocatorType& allocator_;
+        std::size_t next_value_{0u};
+    };
+}
+
 namespace e2d::json_utils
 {
     void add_common_schema_definitions(rapidjson::Document& schema) {
@@ -922,3 +1171,72 @@ namespace e2d::json_utils
         }
     }
 }
+
+namespace e2d::json_utils
+{
+    bool try_load_cooked_json(
+        rapidjson::Document& dst,
+        const buffer& src) noexcept
+    {
+        u32 schema = 0u;
+        return try_load_cooked_json(dst, schema, src);
+    }
+
+    bool try_load_cooked_json(
+        rapidjson::Document& dst,
+        u32& schema,
+        const buffer& src) noexcept
+    {
+        try {
+            cooked_json_header header;
+            if ( src.size() < sizeof(header) ) {
+                return false;
+            }
+            std::memcpy(&header, src.data(), sizeof(header));
+
+            const str_view signature(header.signature, sizeof(header.signature));
+            if ( signature != cooked_json_signature || header.version != cooked_json_version ) {
+                return false;
+            }
+
+            const std::size_t values_size =
+                std::size_t(header.value_count) * sizeof(cooked_json_value);
+            if ( src.size() != sizeof(header) + values_size + header.string_size ) {
+                return false;
+            }
+
+            // values are copied one by one, so the buffer can be unaligned
+            rapidjson::Document doc;
+            cooked_json_reader reader(
+                src.data() + sizeof(header),
+                header.value_count,
+                reinterpret_cast<const char*>(src.data() + sizeof(header) + values_size),
+                header.string_size,
+                doc.GetAllocator());
+            if ( !reader.read(doc) ) {
+                return false;
+            }
+
+            dst.Swap(doc);
+            schema = header.schema;
+            return true;
+        } catch (...) {
+            return false;
+        }
+    }
+
+    bool try_save_cooked_json(
+        buffer& dst,
+        const rapidjson::Value& src,
+        u32 schema) noexcept
+    {
+        try {
+            cooked_json_writer writer;
+            writer.write(src);
+            writer.flush(dst, schema);
+            return true;
+        } catch (...) {
+            return false;
+        }
+    }
+}
@@ -51,6 +51,48 @@ namespace e2d::path
             : str_view_concat(lhs, "/", rhs);
     }
 
+    str normalize(str_view path) {
+        str root;
+        if ( path.size() >= 2 && path[1] == ':' ) {
+            root = str(path.substr(0, 2));
+            path.remove_prefix(2);
+        }
+        if ( !path.empty() && is_directory_separator(path.front()) ) {
+            root += '/';
+        }
+        const bool absolute = !root.empty();
+
+        vector<str_view> parts;
+        while ( !path.empty() ) {
+            const auto sep = std::find_if(path.cbegin(), path.cend(), &is_directory_separator);
+            const auto size = static_cast<std::size_t>(std::distance(path.cbegin(), sep));
+            const str_view part = path.substr(0, size);
+            path.remove_prefix(math::min(size + 1u, path.size()));
+            if ( part.empty() || part == dot ) {
+                continue;
+            }
+            if ( part == dot_dot ) {
+                if ( !parts.empty() && parts.back() != dot_dot ) {
+                    parts.pop_back();
+                    continue;
+                }
+                if ( absolute ) {
+                    continue;
+                }
+            }
+            parts.push_back(part);
+        }
+
+        str result = root;
+        for ( std::size_t i = 0; i < parts.size(); ++i ) {
+            if ( i > 0 ) {
+                result += '/';
+            }
+            result.append(parts[i].cbegin(), parts[i].cend());
+        }
+        return result;
+    }
+
     str remove_filename(str_view path) {
         const str name = filename(path);
         return name.empty()
@@ -0,0 +1,224 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include <enduro2d/utils/slab_allocator.hpp>
+
+namespace
+{
+    using namespace e2d;
+
+    thread_local slab_allocator* current_allocator = nullptr;
+}
+
+namespace e2d
+{
+    //
+    // slab_allocator::internal_state
+    //
+
+    class slab_allocator::internal_state final : private noncopyable {
+    public:
+        struct size_class;
+
+        struct alignas(std::max_align_t) block_header {
+            size_class* owner{nullptr};
+        };
+
+        struct free_block {
+            free_block* next{nullptr};
+        };
+
+        // each size class has its own lock, so only allocations
+        // of the same size from different threads contend
+        struct size_class {
+            internal_state* state{nullptr};
+            std::size_t block_size{0u};
+            std::mutex mutex;
+            free_block* free_list{nullptr};
+        };
+
+        static constexpr std::size_t size_class_count = max_block_size / granularity;
+    public:
+        internal_state(slab_allocator& owner, std::size_t slab_size)
+        : owner_(owner)
+        , slab_size_(slab_size)
+        {
+            heap_class_.state = this;
+            for ( std::size_t i = 0; i < size_class_count; ++i ) {
+                size_classes_[i].state = this;
+                size_classes_[i].block_size = sizeof(block_header) + (i + 1u) * granularity;
+            }
+        }
+
+        ~internal_state() noexcept {
+            E2D_ASSERT(!live_blocks_.load());
+            for ( void* slab : slabs_ ) {
+                ::operator delete(slab);
+            }
+        }
+
+        slab_allocator& owner() noexcept {
+            return owner_;
+        }
+
+        void* allocate(std::size_t size) {
+            if ( size > max_block_size ) {
+                void* memory = ::operator new(sizeof(block_header) + size);
+                heap_fallbacks_.fetch_add(1u, std::memory_order_relaxed);
+                return acquire_block_(memory, heap_class_);
+            }
+
+            const std::size_t index = size > 0u
+                ? (size - 1u) / granularity
+                : 0u;
+            size_class& sc = size_classes_[index];
+
+            free_block* block = nullptr;
+            {
+                std::lock_guard<std::mutex> guard(sc.mutex);
+                if ( !sc.free_list ) {
+                    refill_(sc);
+                }
+                block = sc.free_list;
+                sc.free_list = block->next;
+            }
+            return acquire_block_(block, sc);
+        }
+
+        // returns true when the last live block is released
+        bool deallocate(block_header* header) noexcept {
+            size_class& sc = *header->owner;
+            header->~block_header();
+
+            if ( &sc == &heap_class_ ) {
+                ::operator delete(header);
+            } else {
+                free_block* block = new(header) free_block();
+                std::lock_guard<std::mutex> guard(sc.mutex);
+                block->next = sc.free_list;
+                sc.free_list = block;
+            }
+
+            deallocations_.fetch_add(1u, std::memory_order_relaxed);
+            const std::size_t live_blocks = live_blocks_.fetch_sub(1u, std::memory_order_acq_rel);
+            E2D_ASSERT(live_blocks > 0u);
+            return 1u == live_blocks;
+        }
+
+        statistics stats() const noexcept {
+            statistics result;
+            result.allocations = allocations_.load(std::memory_order_relaxed);
+            result.deallocations = deallocations_.load(std::memory_order_relaxed);
+            result.live_blocks = live_blocks_.load(std::memory_order_relaxed);
+            result.heap_fallbacks = heap_fallbacks_.load(std::memory_order_relaxed);
+            std::lock_guard<std::mutex> guard(slabs_mutex_);
+            result.slab_count = slabs_.size();
+            result.reserved_bytes = reserved_bytes_;
+            return result;
+        }
+    private:
+        void* acquire_block_(void* memory, size_class& sc) noexcept {
+            block_header* header = new(memory) block_header();
+            header->owner = &sc;
+            allocations_.fetch_add(1u, std::memory_order_relaxed);
+            if ( 0u == live_blocks_.fetch_add(1u, std::memory_order_acq_rel) ) {
+                // live blocks keep the allocator alive
+                intrusive_ptr_add_ref(&owner_);
+            }
+            return header + 1;
+        }
+
+        // called with the size class lock held
+        void refill_(size_class& sc) {
+            const std::size_t block_count = math::max(
+                slab_size_ / sc.block_size,
+                std::size_t(1u));
+            const std::size_t slab_bytes = block_count * sc.block_size;
+
+            u8* slab = nullptr;
+            {
+                std::lock_guard<std::mutex> guard(slabs_mutex_);
+                slabs_.reserve(slabs_.size() + 1u);
+                slab = static_cast<u8*>(::operator new(slab_bytes));
+                slabs_.push_back(slab);
+                reserved_bytes_ += slab_bytes;
+            }
+
+            // linked in address order, so consecutive
+            // allocations are neighbours in memory
+            for ( std::size_t i = block_count; i > 0u; --i ) {
+                free_block* block = new(slab + (i - 1u) * sc.block_size) free_block();
+                block->next = sc.free_list;
+                sc.free_list = block;
+            }
+        }
+    private:
+        slab_allocator& owner_;
+        std::size_t slab_size_{0u};
+        std::atomic<std::size_t> allocations_{0u};
+        std::atomic<std::size_t> deallocations_{0u};
+        std::atomic<std::size_t> live_blocks_{0u};
+        std::atomic<std::size_t> heap_fallbacks_{0u};
+        mutable std::mutex slabs_mutex_;
+        vector<void*> slabs_;
+        std::size_t reserved_bytes_{0u};
+        size_class heap_class_;
+        std::array<size_class, size_class_count> size_classes_;
+    };
+
+    //
+    // slab_allocator
+    //
+
+    slab_allocator::slab_allocator(std::size_t slab_size)
+    : state_(new internal_state(*this, slab_size)) {}
+
+    slab_allocator::~slab_allocator() noexcept = default;
+
+    void* slab_allocator::allocate(std::size_t size) {
+        return state_->allocate(size);
+    }
+
+    void slab_allocator::deallocate(void* ptr) noexcept {
+        if ( !ptr ) {
+            return;
+        }
+        using block_header = internal_state::block_header;
+        block_header* header = static_cast<block_header*>(ptr) - 1;
+        internal_state* state = header->owner->state;
+        if ( state->deallocate(header) ) {
+            intrusive_ptr_release(&state->owner());
+        }
+    }
+
+    slab_allocator::statistics slab_allocator::stats() const noexcept {
+        return state_->stats();
+    }
+
+    slab_allocator& slab_allocator::shared() {
+        static slab_allocator_iptr allocator = make_intrusive<slab_allocator>();
+        return *allocator;
+    }
+
+    slab_allocator& slab_allocator::current() {
+        return current_allocator
+            ? *current_allocator
+            : shared();
+    }
+
+    //
+    // slab_allocator::scope
+    //
+
+    slab_allocator::scope::scope(slab_allocator& allocator) noexcept
+    : prev_(current_allocator) {
+        current_allocator = &allocator;
+    }
+
+    slab_allocator::scope::~scope() noexcept {
+        current_allocator = prev_;
+    }
+}
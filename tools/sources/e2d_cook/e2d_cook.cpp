@@ -0,0 +1,502 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include <enduro2d/enduro2d.hpp>
+using namespace e2d;
+
+//
+// e2d_cook
+//
+// converts the sources of a library root into their runtime forms:
+//   *.json             -> *.json.e2d_json (validated and binary)
+//   *.png, *.jpg, *.tga -> *.png.dds, ...   (decoded pixels)
+//
+// the database file in the library root keeps the content hash,
+// size, asset type and direct dependencies of every source, so
+// unchanged sources are neither cooked nor parsed again
+//
+// writes the asset manifest of the library root with the types,
+// sizes, hashes and transitive dependencies of all known sources,
+// addresses in json documents are taken as dependencies
+//
+
+namespace
+{
+    const char* cook_database_name = "e2d_cook.db";
+    const char* manifest_name = "e2d_manifest.json";
+
+    struct cook_options {
+        str root;
+        bool force = false;
+        std::size_t jobs = 0u;
+    };
+
+    enum class cook_result : u8 {
+        cooked,
+        skipped,
+        failed
+    };
+
+    struct cook_record {
+        u64 content_hash = 0u;
+        u64 size = 0u;
+        str type;
+        vector<str> dependencies;
+    };
+
+    struct cook_task {
+        str source;
+        cook_record record;
+        cook_result result = cook_result::failed;
+    };
+
+    using cook_database = hash_map<str, cook_record>;
+
+    str lower_extension(str_view path) {
+        str ext = path::extension(path);
+        std::transform(ext.begin(), ext.end(), ext.begin(), [](char c){
+            return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        });
+        return ext;
+    }
+
+    bool is_json_source(str_view path) {
+        return lower_extension(path) == ".json";
+    }
+
+    bool is_image_source(str_view path) {
+        const str ext = lower_extension(path);
+        return ext == ".png"
+            || ext == ".jpg"
+            || ext == ".jpeg"
+            || ext == ".tga";
+    }
+
+    bool is_cooked_source(str_view path) {
+        return is_json_source(path)
+            || is_image_source(path);
+    }
+
+    bool is_manifest_source(str_view path) {
+        const str ext = lower_extension(path);
+        return is_cooked_source(path)
+            || ext == ".e2d_mesh"
+            || ext == ".e2d_shape"
+            || ext == ".xml"
+            || ext == ".vert"
+            || ext == ".frag"
+            || ext == ".txt";
+    }
+
+    // the type of a source known by its extension, json sources
+    // get their type from the schema they match
+    const char* source_type(str_view path) {
+        const str ext = lower_extension(path);
+        if ( is_image_source(path) ) {
+            return texture_asset::type_name();
+        } else if ( ext == ".e2d_mesh" ) {
+            return mesh_asset::type_name();
+        } else if ( ext == ".e2d_shape" ) {
+            return shape_asset::type_name();
+        } else if ( ext == ".xml" ) {
+            return xml_asset::type_name();
+        }
+        return text_asset::type_name();
+    }
+
+    str cooked_address(str_view address) {
+        return is_json_source(address)
+            ? json_asset::cooked_address(address)
+            : image_asset::cooked_address(address);
+    }
+
+    //
+    // database
+    //
+    // one tab separated line per source:
+    //   hash size type source dependency...
+    //
+
+    vector<str_view> split_database_line(str_view line) {
+        vector<str_view> fields;
+        while ( true ) {
+            const std::size_t separator = line.find('\t');
+            fields.push_back(line.substr(0, separator));
+            if ( separator == str_view::npos ) {
+                break;
+            }
+            line.remove_prefix(separator + 1u);
+        }
+        return fields;
+    }
+
+    bool load_database(cook_database& dst, str_view path) {
+        cook_database database;
+        if ( filesystem::file_exists(path) ) {
+            str content;
+            if ( !filesystem::try_read_all(content, path) ) {
+                return false;
+            }
+            std::size_t line_begin = 0u;
+            while ( line_begin < content.size() ) {
+                std::size_t line_end = content.find('\n', line_begin);
+                if ( line_end == str::npos ) {
+                    line_end = content.size();
+                }
+                const str line = content.substr(line_begin, line_end - line_begin);
+                const vector<str_view> fields = split_database_line(line);
+                // lines of older databases have no type and size,
+                // their sources are cooked again
+                if ( fields.size() >= 4u && !fields[2].empty() && !fields[3].empty() ) {
+                    cook_record record;
+                    record.content_hash = std::strtoull(str(fields[0]).c_str(), nullptr, 16);
+                    record.size = std::strtoull(str(fields[1]).c_str(), nullptr, 10);
+                    record.type = str(fields[2]);
+                    for ( std::size_t i = 4u; i < fields.size(); ++i ) {
+                        record.dependencies.emplace_back(fields[i]);
+                    }
+                    database[str(fields[3])] = std::move(record);
+                }
+                line_begin = line_end + 1u;
+            }
+        }
+        dst = std::move(database);
+        return true;
+    }
+
+    bool save_database(const vector<cook_task>& tasks, str_view path) {
+        str content;
+        char hash_str[64] = {0};
+        for ( const cook_task& task : tasks ) {
+            if ( task.result == cook_result::failed ) {
+                continue;
+            }
+            std::snprintf(
+                hash_str, sizeof(hash_str),
+                "%016llx\t%llu\t",
+                static_cast<unsigned long long>(task.record.content_hash),
+                static_cast<unsigned long long>(task.record.size));
+            content += hash_str;
+            content += task.record.type;
+            content += '\t';
+            content += task.source;
+            for ( const str& dependency : task.record.dependencies ) {
+                content += '\t';
+                content += dependency;
+            }
+            content += '\n';
+        }
+        return filesystem::try_write_all(content, path, false);
+    }
+
+    //
+    // cookers
+    //
+
+    template < typename Asset >
+    void find_matching_schema(
+        const rapidjson::Document& doc,
+        const char*& type,
+        std::size_t& matches)
+    {
+        rapidjson::SchemaValidator validator(Asset::schema());
+        if ( doc.Accept(validator) ) {
+            type = Asset::type_name();
+            ++matches;
+        }
+    }
+
+    // the type of the asset a document describes if it matches
+    // exactly one asset schema, nullptr for ambiguous documents
+    const char* json_asset_type(const rapidjson::Document& doc) {
+        const char* type = nullptr;
+        std::size_t matches = 0u;
+        find_matching_schema<atlas_asset>(doc, type, matches);
+        find_matching_schema<flipbook_asset>(doc, type, matches);
+        find_matching_schema<material_asset>(doc, type, matches);
+        find_matching_schema<model_asset>(doc, type, matches);
+        find_matching_schema<prefab_asset>(doc, type, matches);
+        find_matching_schema<shader_asset>(doc, type, matches);
+        find_matching_schema<sprite_asset>(doc, type, matches);
+        return matches == 1u ? type : nullptr;
+    }
+
+    // strings which address other sources relative to the document,
+    // unknown ones are filtered out by the manifest
+    void collect_json_dependencies(
+        const rapidjson::Value& root,
+        str_view parent_path,
+        vector<str>& dst)
+    {
+        if ( root.IsString() ) {
+            const str dependency = path::normalize(path::combine(
+                parent_path,
+                address::parent(str_view(root.GetString(), root.GetStringLength()))));
+            if ( is_manifest_source(dependency)
+                && std::find(dst.begin(), dst.end(), dependency) == dst.end() )
+            {
+                dst.push_back(dependency);
+            }
+        } else if ( root.IsArray() ) {
+            for ( rapidjson::SizeType i = 0; i < root.Size(); ++i ) {
+                collect_json_dependencies(root[i], parent_path, dst);
+            }
+        } else if ( root.IsObject() ) {
+            for ( auto iter = root.MemberBegin(); iter != root.MemberEnd(); ++iter ) {
+                collect_json_dependencies(iter->value, parent_path, dst);
+            }
+        }
+    }
+
+    // documents are tagged only when they match exactly one asset schema,
+    // ambiguous documents are still validated at runtime
+    bool cook_json(buffer& dst, cook_record& record, str_view address, const buffer& src) {
+        rapidjson::Document doc;
+        doc.Parse(reinterpret_cast<const char*>(src.data()), src.size());
+        if ( doc.HasParseError() ) {
+            return false;
+        }
+        const char* type = json_asset_type(doc);
+        record.type = type ? type : json_asset::type_name();
+        record.dependencies.clear();
+        collect_json_dependencies(doc, path::parent_path(address), record.dependencies);
+        return json_utils::try_save_cooked_json(
+            dst, doc, type ? json_asset::schema_tag(type) : 0u);
+    }
+
+    bool cook_image(buffer& dst, const buffer& src) {
+        image content;
+        return images::try_load_image(content, src)
+            && images::try_save_image(content, image_file_format::dds, dst);
+    }
+
+    bool is_cooked_actual(str_view source_path, str_view cooked_path) {
+        microseconds<u64> source_time;
+        microseconds<u64> cooked_time;
+        return filesystem::try_get_write_time(source_time, source_path)
+            && filesystem::try_get_write_time(cooked_time, cooked_path)
+            && cooked_time >= source_time;
+    }
+
+    void cook_source(
+        cook_task& task,
+        const cook_options& options,
+        const cook_database& database)
+    {
+        const str source_path = path::combine(options.root, task.source);
+
+        buffer source;
+        if ( !filesystem::try_read_all(source, source_path) ) {
+            std::printf("[failed] %s: can't read the source\n", task.source.c_str());
+            task.result = cook_result::failed;
+            return;
+        }
+        task.record.content_hash = utils::fnv1a_hash(source.data(), source.data() + source.size());
+        task.record.size = source.size();
+
+        if ( !is_cooked_source(task.source) ) {
+            task.record.type = source_type(task.source);
+            task.result = cook_result::skipped;
+            return;
+        }
+
+        const str cooked_path = path::combine(options.root, cooked_address(task.source));
+
+        const auto iter = database.find(task.source);
+        if ( !options.force
+            && iter != database.end()
+            && iter->second.content_hash == task.record.content_hash
+            && iter->second.size == task.record.size
+            && is_cooked_actual(source_path, cooked_path) )
+        {
+            task.record = iter->second;
+            task.result = cook_result::skipped;
+            return;
+        }
+
+        buffer cooked;
+        bool success = false;
+        if ( is_json_source(task.source) ) {
+            success = cook_json(cooked, task.record, task.source, source);
+        } else {
+            task.record.type = source_type(task.source);
+            success = cook_image(cooked, source);
+        }
+
+        if ( !success || !filesystem::try_write_all(cooked, cooked_path, false) ) {
+            std::printf("[failed] %s\n", task.source.c_str());
+            task.result = cook_result::failed;
+            return;
+        }
+
+        std::printf("[cooked] %s\n", task.source.c_str());
+        task.result = cook_result::cooked;
+    }
+
+    //
+    // manifest
+    //
+
+    using manifest_sources = hash_map<str, const cook_record*>;
+
+    // dependencies of dependencies go after them, cycles are cut
+    void collect_transitive_dependencies(
+        const str& address,
+        const manifest_sources& sources,
+        hash_set<str>& visited,
+        vector<str>& dst)
+    {
+        const auto iter = sources.find(address);
+        if ( iter == sources.end() ) {
+            return;
+        }
+        for ( const str& dependency : iter->second->dependencies ) {
+            if ( sources.count(dependency) && visited.insert(dependency).second ) {
+                dst.push_back(dependency);
+                collect_transitive_dependencies(dependency, sources, visited, dst);
+            }
+        }
+    }
+
+    bool save_manifest(const vector<cook_task>& tasks, str_view path) {
+        manifest_sources sources;
+        for ( const cook_task& task : tasks ) {
+            if ( task.result != cook_result::failed ) {
+                sources.emplace(task.source, &task.record);
+            }
+        }
+
+        asset_manifest manifest;
+        for ( const auto& source : sources ) {
+            asset_manifest::entry entry;
+            entry.address = source.first;
+            entry.type = source.second->type;
+            entry.size = source.second->size;
+            entry.content_hash = source.second->content_hash;
+            hash_set<str> visited{source.first};
+            collect_transitive_dependencies(source.first, sources, visited, entry.dependencies);
+            manifest.add_entry(std::move(entry));
+        }
+
+        buffer content;
+        return asset_manifests::try_save_manifest(content, manifest)
+            && filesystem::try_write_all(content, path, false);
+    }
+
+    //
+    // main
+    //
+
+    bool parse_options(cook_options& dst, int argc, char *argv[]) {
+        cook_options options;
+        for ( int i = 1; i < argc; ++i ) {
+            const str_view arg = argv[i];
+            if ( arg == "--force" ) {
+                options.force = true;
+            } else if ( arg == "--jobs" && i + 1 < argc ) {
+                options.jobs = std::strtoul(argv[++i], nullptr, 10);
+            } else if ( options.root.empty() && !arg.empty() && arg.front() != '-' ) {
+                options.root = str(arg);
+            } else {
+                return false;
+            }
+        }
+        if ( options.root.empty() ) {
+            return false;
+        }
+        if ( !options.jobs ) {
+            options.jobs = math::max(1u, std::thread::hardware_concurrency());
+        }
+        dst = std::move(options);
+        return true;
+    }
+
+    int cook_library(const cook_options& options) {
+        if ( !filesystem::directory_exists(options.root) ) {
+            std::printf("library root not found: %s\n", options.root.c_str());
+            return 1;
+        }
+
+        const str database_path = path::combine(options.root, cook_database_name);
+        cook_database database;
+        if ( !load_database(database, database_path) ) {
+            std::printf("failed to read the database: %s\n", database_path.c_str());
+            return 1;
+        }
+
+        vector<cook_task> tasks;
+        const bool traced = filesystem::trace_directory_recursive(
+            options.root,
+            [&tasks](str_view relative, bool directory){
+                if ( directory || relative == manifest_name ) {
+                    return true;
+                }
+                if ( is_manifest_source(relative) ) {
+                    tasks.emplace_back().source = path::normalize(relative);
+                }
+                return true;
+            });
+        if ( !traced ) {
+            std::printf("failed to read the library root: %s\n", options.root.c_str());
+            return 1;
+        }
+
+        {
+            stdex::jobber jobber(options.jobs);
+            for ( cook_task& task : tasks ) {
+                jobber.async([&task, &options, &database](){
+                    try {
+                        cook_source(task, options, database);
+                    } catch (...) {
+                        std::printf("[failed] %s\n", task.source.c_str());
+                        task.result = cook_result::failed;
+                    }
+                });
+            }
+            jobber.wait_all();
+        }
+
+        std::size_t cooked = 0u;
+        std::size_t skipped = 0u;
+        std::size_t failed = 0u;
+        for ( const cook_task& task : tasks ) {
+            switch ( task.result ) {
+                case cook_result::cooked: ++cooked; break;
+                case cook_result::skipped: ++skipped; break;
+                case cook_result::failed: ++failed; break;
+            }
+        }
+
+        if ( !save_database(tasks, database_path) ) {
+            std::printf("failed to write the database: %s\n", database_path.c_str());
+            return 1;
+        }
+
+        const str manifest_path = path::combine(options.root, manifest_name);
+        if ( !save_manifest(tasks, manifest_path) ) {
+            std::printf("failed to write the manifest: %s\n", manifest_path.c_str());
+            return 1;
+        }
+
+        std::printf("cooked: %zu, skipped: %zu, failed: %zu\n", cooked, skipped, failed);
+        return failed ? 1 : 0;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    cook_options options;
+    if ( !parse_options(options, argc, argv) ) {
+        std::printf("usage: e2d_cook [--force] [--jobs N] <library root>\n");
+        return 1;
+    }
+
+    modules::initialize<debug>()
+        .register_sink_ex<debug_console_sink>(debug::level::warning);
+
+    const int result = cook_library(options);
+    modules::shutdown<debug>();
+    return result;
+}
@@ -0,0 +1,131 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include "_core.hpp"
+using namespace e2d;
+
+TEST_CASE("deferrer"){
+    {
+        deferrer d;
+        d.main_thread_budget(make_microseconds<u64>(0u), 100u);
+        REQUIRE(d.main_thread_byte_budget() == 100u);
+
+        vector<int> order;
+        auto p0 = d.do_in_main_thread_budgeted(
+            stdex::scheduler_priority::normal, 60u, [&order](){ order.push_back(0); });
+        auto p1 = d.do_in_main_thread_budgeted(
+            stdex::scheduler_priority::highest, 60u, [&order](){ order.push_back(1); return 42; });
+        auto p2 = d.do_in_main_thread_budgeted(
+            stdex::scheduler_priority::lowest, 60u, [&order](){ order.push_back(2); });
+        auto p3 = d.do_in_main_thread([&order](){ order.push_back(3); });
+        REQUIRE(d.budgeted_task_count() == 3u);
+
+        // all plain tasks and budgeted ones while the budget lasts
+        REQUIRE(d.process_main_thread_tasks() == 3u);
+        REQUIRE(order == vector<int>{3, 1, 0});
+        REQUIRE(p1.get() == 42);
+        REQUIRE(d.budgeted_task_count() == 1u);
+
+        REQUIRE(d.process_main_thread_tasks() == 1u);
+        REQUIRE(order == vector<int>{3, 1, 0, 2});
+        REQUIRE(d.budgeted_task_count() == 0u);
+        REQUIRE(d.process_main_thread_tasks() == 0u);
+    }
+    {
+        deferrer d;
+        d.main_thread_budget(make_microseconds<u64>(0u), 10u);
+
+        // a task over the budget still runs to make progress
+        auto p = d.do_in_main_thread_budgeted(
+            stdex::scheduler_priority::normal, 1000u, [](){ return 1; });
+        REQUIRE(d.process_main_thread_tasks() == 1u);
+        REQUIRE(p.get() == 1);
+    }
+    {
+        deferrer d;
+        d.main_thread_budget(make_microseconds<u64>(0u), 1u);
+
+        // blocking waits ignore the budget
+        auto p0 = d.do_in_main_thread_budgeted(
+            stdex::scheduler_priority::normal, 1u, [](){ return 1; });
+        auto p1 = d.do_in_main_thread_budgeted(
+            stdex::scheduler_priority::lowest, 1u, [](){ return 2; });
+        d.active_safe_wait_promise(p1);
+        REQUIRE(p0.get() == 1);
+        REQUIRE(p1.get() == 2);
+    }
+}
+
+TEST_CASE("deferrer_context"){
+    deferrer d;
+    {
+        REQUIRE(deferrer::current_context().priority == stdex::jobber_priority::normal);
+        REQUIRE_FALSE(deferrer::current_context().token.cancelled());
+
+        cancellation_token token;
+        deferrer::context_scope scope({stdex::jobber_priority::highest, token});
+        REQUIRE(deferrer::current_context().priority == stdex::jobber_priority::highest);
+
+        // the context is inherited by tasks and their continuations
+        auto p = d.do_in_worker_thread([](){
+            return deferrer::current_context().priority;
+        }).then([&d](stdex::jobber_priority priority){
+            return d.do_in_worker_thread([priority](){
+                return priority == deferrer::current_context().priority;
+            });
+        });
+        d.active_safe_wait_promise(p);
+        REQUIRE(p.get());
+
+        // tasks of a cancelled context are dropped
+        token.cancel();
+        bool executed = false;
+        auto p2 = d.do_in_worker_thread([&executed](){ executed = true; });
+        d.active_safe_wait_promise(p2);
+        REQUIRE_THROWS_AS(p2.get(), deferrer_cancelled_exception);
+        REQUIRE_FALSE(executed);
+    }
+    REQUIRE(deferrer::current_context().priority == stdex::jobber_priority::normal);
+    {
+        cancellation_token token;
+        cancellation_token copy = token;
+        REQUIRE_FALSE(copy.cancelled());
+        token.cancel();
+        REQUIRE(copy.cancelled());
+
+        cancellation_token none = cancellation_token::none();
+        none.cancel();
+        REQUIRE_FALSE(none.cancelled());
+    }
+    {
+        // shared tokens are cancelled with all of the joined ones
+        cancellation_token token1;
+        cancellation_token token2;
+        cancellation_token shared = cancellation_token::all_of(token1);
+        REQUIRE(shared.join(token2));
+        token1.cancel();
+        REQUIRE_FALSE(shared.cancelled());
+        token2.cancel();
+        REQUIRE(shared.cancelled());
+        REQUIRE_FALSE(shared.join(cancellation_token()));
+
+        // and never with a joined token that is never cancelled
+        cancellation_token token3;
+        cancellation_token pinned = cancellation_token::all_of(token3);
+        REQUIRE(pinned.join(cancellation_token::none()));
+        token3.cancel();
+        REQUIRE_FALSE(pinned.cancelled());
+    }
+    {
+        deferrer::task_context context;
+        context.raised_priority = std::make_shared<std::atomic<stdex::jobber_priority>>(
+            stdex::jobber_priority::normal);
+        context.raise_priority(stdex::jobber_priority::above_normal);
+        context.raise_priority(stdex::jobber_priority::lowest);
+        REQUIRE(context.priority == stdex::jobber_priority::normal);
+        REQUIRE(context.current_priority() == stdex::jobber_priority::above_normal);
+    }
+}
@@ -0,0 +1,84 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include "_core.hpp"
+using namespace e2d;
+
+TEST_CASE("tracer"){
+    {
+        REQUIRE_FALSE(modules::is_initialized<tracer>());
+        const tracer::scope scope("asset", "load", "ignored");
+        REQUIRE(deferrer::current_context().trace_span == 0u);
+    }
+    modules::initialize<tracer>();
+    deferrer d;
+    {
+        tracer::span root = tracer::begin_span("asset", "load", "root");
+        REQUIRE(root.id != 0u);
+        {
+            deferrer::task_context context = deferrer::current_context();
+            context.trace_span = root.id;
+            deferrer::context_scope context_scope(std::move(context));
+
+            // spans of worker tasks are nested in the scheduling span
+            auto p = d.do_in_worker_thread([](){
+                const tracer::scope scope("asset", "decode", "child");
+                return tracer::current_thread_id();
+            });
+            d.active_safe_wait_promise(p);
+            REQUIRE(p.get() != tracer::current_thread_id());
+        }
+        tracer::end_span(std::move(root));
+
+        const vector<tracer::span> spans = the<tracer>().spans();
+        REQUIRE(spans.size() == 2u);
+        REQUIRE(spans[0].stage == "decode");
+        REQUIRE(spans[1].stage == "load");
+        REQUIRE(spans[0].parent_id == spans[1].id);
+        REQUIRE(spans[1].parent_id == 0u);
+        REQUIRE(spans[0].thread_id != spans[1].thread_id);
+        REQUIRE(spans[0].begin >= spans[1].begin);
+        REQUIRE(spans[0].end <= spans[1].end);
+    }
+    {
+        str trace;
+        REQUIRE(the<tracer>().try_save_chrome_trace(trace));
+
+        rapidjson::Document doc;
+        REQUIRE_FALSE(doc.Parse(trace.c_str()).HasParseError());
+        REQUIRE(doc.HasMember("traceEvents"));
+        REQUIRE(doc["traceEvents"].IsArray());
+
+        std::size_t complete_events = 0u;
+        std::size_t flow_events = 0u;
+        for ( rapidjson::SizeType i = 0; i < doc["traceEvents"].Size(); ++i ) {
+            const str_view ph = doc["traceEvents"][i]["ph"].GetString();
+            complete_events += ph == "X" ? 1u : 0u;
+            flow_events += (ph == "s" || ph == "f") ? 1u : 0u;
+        }
+        REQUIRE(complete_events == 2u);
+        REQUIRE(flow_events == 2u);
+    }
+    {
+        the<tracer>().add_span({0u, 0u, 0u, "asset", "load", "a",
+            make_microseconds<u64>(0u), make_microseconds<u64>(10u)});
+        the<tracer>().add_span({0u, 0u, 0u, "asset", "load", "b",
+            make_microseconds<u64>(0u), make_microseconds<u64>(30u)});
+
+        const vector<tracer::summary> summaries = the<tracer>().summarize();
+        REQUIRE(summaries.size() == 2u);
+        REQUIRE(summaries[0].stage == "load");
+        REQUIRE(summaries[0].count == 3u);
+        REQUIRE(summaries[0].total >= make_microseconds<u64>(40u));
+        REQUIRE(summaries[0].max >= make_microseconds<u64>(30u));
+        REQUIRE(summaries[1].stage == "decode");
+        REQUIRE(summaries[1].count == 1u);
+
+        the<tracer>().clear();
+        REQUIRE(the<tracer>().spans().empty());
+    }
+    modules::shutdown<tracer>();
+}
@@ -23,6 +23,12 @@ TEST_CASE("vfs"){
             REQUIRE_FALSE(v.exists({"file2", file_path}));
             REQUIRE_FALSE(v.exists({"file", nofile_path}));
         }
+        {
+            microseconds<u64> write_time;
+            REQUIRE(v.write_time({"file", file_path}, write_time));
+            REQUIRE(write_time.value > 0u);
+            REQUIRE_FALSE(v.write_time({"file", nofile_path}, write_time));
+        }
         {
             buffer b;
             auto r = v.read({"file", file_path});
@@ -0,0 +1,142 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include "_high.hpp"
+using namespace e2d;
+
+namespace
+{
+    class safe_starter_initializer final : private noncopyable {
+    public:
+        safe_starter_initializer() {
+            modules::initialize<starter>(0, nullptr,
+                starter::parameters(
+                    engine::parameters("flipbook_system_untests", "enduro2d")
+                        .without_graphics(true)));
+        }
+
+        ~safe_starter_initializer() noexcept {
+            modules::shutdown<starter>();
+        }
+    };
+
+    flipbook_asset::ptr make_flipbook(const vector<sprite_asset::ptr>& sprites) {
+        vector<flipbook::frame> frames;
+        vector<std::size_t> indices;
+        for ( const sprite_asset::ptr& s : sprites ) {
+            indices.push_back(frames.size());
+            frames.push_back({s});
+        }
+        flipbook content;
+        content.set_frames(std::move(frames));
+        content.set_sequences({{1.f, make_hash("walk"), indices}});
+        return flipbook_asset::create(std::move(content));
+    }
+
+    template < typename T >
+    std::size_t count_changes(ecs::registry& r) {
+        std::size_t changes = 0u;
+        r.for_each_changed_component<T>(
+            r.change_tick(),
+            [&changes](const ecs::entity&, const T&){
+                ++changes;
+            });
+        return changes;
+    }
+}
+
+TEST_CASE("flipbook_system") {
+    safe_starter_initializer initializer;
+    ecs::registry r;
+    r.enable_change_tracking<flipbook_player>();
+    r.enable_change_tracking<sprite_renderer>();
+    ecs::registry_filler(r)
+        .system<flipbook_system>(world::priority_update);
+
+    const sprite_asset::ptr s0 = sprite_asset::create(sprite());
+    const sprite_asset::ptr s1 = sprite_asset::create(sprite());
+    const flipbook_asset::ptr fb = make_flipbook({s0, s1});
+
+    ecs::entity e = r.create_entity();
+    e.assign_component<flipbook_source>(fb);
+    e.assign_component<sprite_renderer>();
+    e.assign_component<flipbook_player>(flipbook_player()
+        .sequence(make_hash("walk"))
+        .speed(0.f));
+
+    {
+        r.advance_change_tick();
+        r.process_all_systems();
+        REQUIRE(e.get_component<sprite_renderer>().sprite() == s0);
+        REQUIRE(count_changes<flipbook_player>(r) == 1u);
+        REQUIRE(count_changes<sprite_renderer>(r) == 1u);
+    }
+    {
+        r.advance_change_tick();
+        r.process_all_systems();
+        REQUIRE(e.get_component<sprite_renderer>().sprite() == s0);
+        REQUIRE(count_changes<flipbook_player>(r) == 0u);
+        REQUIRE(count_changes<sprite_renderer>(r) == 0u);
+    }
+    {
+        e.get_component<flipbook_player>().time(1.5f);
+        r.advance_change_tick();
+        r.process_all_systems();
+        REQUIRE(e.get_component<sprite_renderer>().sprite() == s1);
+        REQUIRE(count_changes<flipbook_player>(r) == 1u);
+        REQUIRE(count_changes<sprite_renderer>(r) == 1u);
+    }
+    {
+        e.get_component<flipbook_player>().sequence(make_hash("run"));
+        r.advance_change_tick();
+        r.process_all_systems();
+        REQUIRE_FALSE(e.get_component<sprite_renderer>().sprite());
+        REQUIRE(count_changes<flipbook_player>(r) == 1u);
+    }
+    {
+        e.get_component<flipbook_player>().sequence(make_hash("walk")).time(0.f);
+        e.get_component<flipbook_source>().flipbook(make_flipbook({s1, s0}));
+        r.advance_change_tick();
+        r.process_all_systems();
+        REQUIRE(e.get_component<sprite_renderer>().sprite() == s1);
+    }
+    {
+        // refilled flipbook content is resolved again
+        const flipbook_asset::ptr refilled = e.get_component<flipbook_source>().flipbook();
+        refilled->fill_from(*make_flipbook({s0, s1}));
+        r.advance_change_tick();
+        r.process_all_systems();
+        REQUIRE(e.get_component<sprite_renderer>().sprite() == s0);
+    }
+    {
+        // a reset sprite of a stopped player is restored
+        e.get_component<sprite_renderer>().sprite(nullptr);
+        r.advance_change_tick();
+        r.process_all_systems();
+        REQUIRE(e.get_component<sprite_renderer>().sprite() == s0);
+        REQUIRE(count_changes<flipbook_player>(r) == 0u);
+        REQUIRE(count_changes<sprite_renderer>(r) == 1u);
+    }
+    {
+        // a renderer assigned to a stopped player later is filled
+        e.remove_component<sprite_renderer>();
+        r.process_all_systems();
+        e.assign_component<sprite_renderer>();
+        r.process_all_systems();
+        REQUIRE(e.get_component<sprite_renderer>().sprite() == s0);
+    }
+    {
+        // a cloned player does not reuse the source cache
+        ecs::entity c = r.create_entity();
+        c.assign_component<flipbook_source>(e.get_component<flipbook_source>());
+        c.assign_component<sprite_renderer>();
+        c.assign_component<flipbook_player>(e.get_component<flipbook_player>());
+        c.get_component<flipbook_player>().time(1.5f);
+        r.process_all_systems();
+        REQUIRE(c.get_component<sprite_renderer>().sprite() == s1);
+        REQUIRE(e.get_component<sprite_renderer>().sprite() == s0);
+    }
+}
@@ -0,0 +1,137 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include "_high.hpp"
+using namespace e2d;
+
+namespace
+{
+    class safe_starter_initializer final : private noncopyable {
+    public:
+        safe_starter_initializer() {
+            modules::initialize<starter>(0, nullptr,
+                starter::parameters(
+                    engine::parameters("image_cache_untests", "enduro2d")
+                        .without_graphics(true)));
+        }
+
+        ~safe_starter_initializer() noexcept {
+            modules::shutdown<starter>();
+        }
+    };
+
+    image make_image(u8 fill) {
+        buffer data(64u);
+        std::fill(data.data(), data.data() + data.size(), fill);
+        return image(v2u(4u, 4u), image_data_format::rgba8, std::move(data));
+    }
+
+    void store_image(image_cache& cache, u64 content_hash, const image& src) {
+        auto p = cache.store_async(content_hash, src);
+        the<deferrer>().active_safe_wait_promise(p);
+        REQUIRE_NOTHROW(p.get());
+    }
+}
+
+TEST_CASE("image_cache"){
+    safe_starter_initializer initializer;
+    const url root = url("appdata://enduro2d/image_cache_untests");
+    {
+        image_cache cache(root, 1024u * 1024u, the<deferrer>());
+        cache.trim(0u);
+        REQUIRE(cache.entry_count() == 0u);
+
+        const buffer source("source bytes", 12);
+        const u64 content_hash = image_cache::content_hash(source);
+        REQUIRE(content_hash == image_cache::content_hash(buffer("source bytes", 12)));
+        REQUIRE(content_hash != image_cache::content_hash(buffer("source bytez", 12)));
+
+        image content;
+        REQUIRE_FALSE(cache.try_load(content, content_hash));
+
+        store_image(cache, content_hash, make_image(42u));
+        REQUIRE(cache.entry_count() == 1u);
+        REQUIRE(cache.size() > 64u);
+
+        REQUIRE(cache.try_load(content, content_hash));
+        REQUIRE(content == make_image(42u));
+    }
+    {
+        // warm start, the index is kept between instances
+        image_cache cache(root, 1024u * 1024u, the<deferrer>());
+        REQUIRE(cache.entry_count() == 1u);
+
+        image content;
+        REQUIRE(cache.try_load(content, image_cache::content_hash(buffer("source bytes", 12))));
+        REQUIRE(content == make_image(42u));
+
+        REQUIRE(cache.trim(0u) == 1u);
+        REQUIRE(cache.entry_count() == 0u);
+        REQUIRE(cache.size() == 0u);
+        REQUIRE_FALSE(cache.try_load(content, image_cache::content_hash(buffer("source bytes", 12))));
+    }
+    {
+        image_cache cache(root, 0u, the<deferrer>());
+        store_image(cache, 1u, make_image(1u));
+        REQUIRE(cache.entry_count() == 0u);
+    }
+    std::size_t entry_size = 0u;
+    {
+        image_cache cache(root, 1024u * 1024u, the<deferrer>());
+        store_image(cache, 1u, make_image(1u));
+        entry_size = cache.size();
+    }
+    {
+        // the least recently used entry goes first
+        image_cache small_cache(root, entry_size * 2u, the<deferrer>());
+        REQUIRE(small_cache.entry_count() == 1u);
+        store_image(small_cache, 2u, make_image(2u));
+
+        image content;
+        REQUIRE(small_cache.try_load(content, 1u));
+        store_image(small_cache, 3u, make_image(3u));
+        REQUIRE(small_cache.entry_count() == 2u);
+        REQUIRE(small_cache.size() <= small_cache.capacity());
+
+        REQUIRE_FALSE(small_cache.try_load(content, 2u));
+        REQUIRE(small_cache.try_load(content, 1u));
+        REQUIRE(content == make_image(1u));
+        REQUIRE(small_cache.try_load(content, 3u));
+        REQUIRE(content == make_image(3u));
+
+        REQUIRE(small_cache.trim(0u) == 2u);
+    }
+    {
+        // image assets are decoded once and taken from the cache after
+        library& l = the<library>();
+        const str address = "image_cache_untests.png";
+        const str source_path = the<vfs>().resolve_scheme_aliases(l.root() / address).path();
+
+        buffer source;
+        REQUIRE(images::try_save_image(make_image(7u), image_file_format::png, source));
+        REQUIRE(filesystem::try_write_all(source, source_path, false));
+
+        modules::initialize<image_cache>(root, 1024u * 1024u, the<deferrer>());
+        for ( std::size_t i = 0; i < 2u; ++i ) {
+            auto image_res = l.load_asset<image_asset>(address);
+            REQUIRE(image_res);
+            REQUIRE(image_res->content() == make_image(7u));
+            l.unload_unused_assets();
+
+            // waits for the store
+            modules::shutdown<image_cache>();
+            image_cache& warm_cache = modules::initialize<image_cache>(
+                root, 1024u * 1024u, the<deferrer>());
+            REQUIRE(warm_cache.entry_count() == 1u);
+            image content;
+            REQUIRE(warm_cache.try_load(content, image_cache::content_hash(source)));
+        }
+        REQUIRE(the<image_cache>().trim(0u) == 1u);
+        modules::shutdown<image_cache>();
+        REQUIRE(filesystem::remove_file(source_path));
+    }
+    the<vfs>().remove(root / "index");
+}
@@ -43,6 +43,50 @@ namespace
             });
         }
     };
+
+    std::atomic<std::size_t> main_thread_fake_asset_loads{0u};
+    std::atomic<stdex::jobber_priority> main_thread_fake_asset_priority{stdex::jobber_priority::normal};
+
+    class main_thread_fake_asset final : public content_asset<main_thread_fake_asset, int> {
+    public:
+        static const char* type_name() noexcept { return "main_thread_fake_asset"; }
+        static load_async_result load_async(const library& library, str_view address) {
+            E2D_UNUSED(library, address);
+            return the<deferrer>().do_in_main_thread([](){
+                ++main_thread_fake_asset_loads;
+                main_thread_fake_asset_priority = deferrer::current_context().current_priority();
+                return main_thread_fake_asset::create(42);
+            });
+        }
+    };
+
+    std::atomic<bool> slow_fake_asset_ready{false};
+
+    class slow_fake_asset final : public content_asset<slow_fake_asset, int> {
+    public:
+        static const char* type_name() noexcept { return "slow_fake_asset"; }
+        static load_async_result load_async(const library& library, str_view address) {
+            E2D_UNUSED(library, address);
+            return the<deferrer>().do_in_worker_thread([](){
+                while ( !slow_fake_asset_ready ) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+                return slow_fake_asset::create(42);
+            });
+        }
+    };
+
+    std::atomic<std::size_t> failing_fake_asset_loads{0u};
+
+    class failing_fake_asset final : public content_asset<failing_fake_asset, int> {
+    public:
+        static const char* type_name() noexcept { return "failing_fake_asset"; }
+        static load_async_result load_async(const library& library, str_view address) {
+            E2D_UNUSED(library, address);
+            ++failing_fake_asset_loads;
+            return stdex::make_rejected_promise<load_result>(asset_loading_exception());
+        }
+    };
 }
 
 TEST_CASE("library"){
@@ -389,3 +433,430 @@ TEST_CASE("asset_dependencies") {
         }
     }
 }
+
+TEST_CASE("library_concurrent_loads"){
+    safe_starter_initializer initializer;
+    library& l = the<library>();
+    {
+        constexpr std::size_t address_count = 64u;
+        constexpr std::size_t thread_count = 4u;
+
+        vector<vector<big_fake_asset::load_async_result>> promises(thread_count);
+        vector<std::thread> threads;
+        for ( std::size_t t = 0; t < thread_count; ++t ) {
+            threads.emplace_back([&l, &promises, t](){
+                for ( std::size_t i = 0; i < address_count; ++i ) {
+                    promises[t].push_back(l.load_asset_async<big_fake_asset>(
+                        strings::rformat("big_fake_asset_%0", i)));
+                }
+            });
+        }
+        for ( std::thread& thread : threads ) {
+            thread.join();
+        }
+
+        for ( std::size_t t = 0; t < thread_count; ++t ) {
+            for ( std::size_t i = 0; i < address_count; ++i ) {
+                the<deferrer>().active_safe_wait_promise(promises[t][i]);
+                REQUIRE(promises[t][i].get() == promises[0][i].get());
+                REQUIRE(promises[t][i].get()->content() == 42);
+            }
+        }
+
+        REQUIRE(l.loading_asset_count() == 0u);
+        REQUIRE(l.cache().asset_count<big_fake_asset>() == address_count);
+        REQUIRE(l.cache().find<big_fake_asset>(make_hash("big_fake_asset_0")));
+        REQUIRE_FALSE(l.cache().find<fake_asset>(make_hash("big_fake_asset_0")));
+
+        promises.clear();
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        REQUIRE(address_count == l.unload_unused_assets());
+        REQUIRE(l.cache().asset_count() == 0u);
+    }
+}
+
+TEST_CASE("asset_cache_eviction"){
+    const auto slice = make_microseconds<u64>(1000000u);
+    const auto make_binary = [](std::size_t size){
+        return binary_asset::create(buffer(size));
+    };
+    {
+        asset_cache c;
+        c.store<binary_asset>(make_hash("a"), make_binary(100u));
+        c.store<binary_asset>(make_hash("b"), make_binary(100u));
+        c.store<binary_asset>(make_hash("c"), make_binary(100u));
+        REQUIRE(c.memory_usage() == 300u);
+        REQUIRE(c.stats().cpu_bytes == 300u);
+        REQUIRE(c.stats().gpu_bytes == 0u);
+
+        REQUIRE(c.find<binary_asset>(make_hash("a")));
+        REQUIRE_FALSE(c.find<binary_asset>(make_hash("d")));
+        REQUIRE_FALSE(c.find<text_asset>(make_hash("a")));
+        REQUIRE(c.peek<binary_asset>(make_hash("b")));
+        REQUIRE(c.stats().hits == 1u);
+        REQUIRE(c.stats().misses == 2u);
+
+        REQUIRE(c.evict_unused_assets(slice) == 0u);
+
+        c.memory_budget(250u);
+        REQUIRE(c.evict_unused_assets(slice) == 1u);
+        REQUIRE(c.memory_usage() == 200u);
+        REQUIRE(c.peek<binary_asset>(make_hash("a")));
+        REQUIRE_FALSE(c.peek<binary_asset>(make_hash("b")));
+        REQUIRE(c.peek<binary_asset>(make_hash("c")));
+        REQUIRE(c.stats().evictions == 1u);
+
+        c.priority<binary_asset>(make_hash("a"), asset_priority::pinned);
+        REQUIRE(c.priority<binary_asset>(make_hash("a")) == asset_priority::pinned);
+        c.memory_budget(50u);
+        REQUIRE(c.evict_unused_assets(slice) == 1u);
+        REQUIRE(c.memory_usage() == 100u);
+        REQUIRE(c.peek<binary_asset>(make_hash("a")));
+        REQUIRE(c.evict_unused_assets(slice) == 0u);
+        REQUIRE(c.unload_unused_assets() == 0u);
+        REQUIRE(c.asset_count() == 1u);
+    }
+    {
+        asset_cache c;
+        c.priority<binary_asset>(make_hash("low"), asset_priority::low);
+        c.store<binary_asset>(make_hash("used"), make_binary(100u));
+        c.store<binary_asset>(make_hash("old"), make_binary(100u));
+        c.store<binary_asset>(make_hash("low"), make_binary(100u));
+        REQUIRE(c.find<binary_asset>(make_hash("low")));
+
+        const binary_asset::ptr used = c.find<binary_asset>(make_hash("used"));
+        REQUIRE(used);
+
+        c.memory_budget(150u);
+        REQUIRE(c.evict_unused_assets(slice) == 2u);
+        REQUIRE(c.peek<binary_asset>(make_hash("used")) == used);
+        REQUIRE_FALSE(c.peek<binary_asset>(make_hash("old")));
+        REQUIRE_FALSE(c.peek<binary_asset>(make_hash("low")));
+        REQUIRE(c.memory_usage() == 100u);
+    }
+    {
+        REQUIRE(text_asset::create(str("hello"))->memory_usage().cpu_bytes == 5u);
+        image img(v2u(4u, 2u), image_data_format::rgba8, buffer(32u));
+        REQUIRE(image_asset::create(std::move(img))->memory_usage().cpu_bytes == 32u);
+    }
+}
+
+TEST_CASE("library_manifest"){
+    {
+        const str manifest_json = R"json({
+            "assets" : [{
+                "address" : "root.json",
+                "type" : "fake_asset",
+                "size" : 128,
+                "hash" : 18446744073709551557,
+                "dependencies" : [ "dep1.json", "dep2.json:/nested" ]
+            }, {
+                "address" : "dep1.json",
+                "type" : "big_fake_asset"
+            }, {
+                "address" : "dep2.json",
+                "type" : "big_fake_asset"
+            }]
+        })json";
+
+        asset_manifest m;
+        REQUIRE(asset_manifests::try_load_manifest(m, buffer(manifest_json.data(), manifest_json.size())));
+        REQUIRE(m.entry_count() == 3u);
+
+        const asset_manifest::entry* root = m.find_entry(make_hash("root.json"));
+        REQUIRE(root);
+        REQUIRE(root->type == "fake_asset");
+        REQUIRE(root->size == 128u);
+        REQUIRE(root->content_hash == 18446744073709551557ull);
+        REQUIRE(root->dependencies == vector<str>{"dep1.json", "dep2.json"});
+        REQUIRE_FALSE(m.find_entry(make_hash("none.json")));
+
+        buffer saved_manifest;
+        REQUIRE(asset_manifests::try_save_manifest(saved_manifest, m));
+        asset_manifest m2;
+        REQUIRE(asset_manifests::try_load_manifest(m2, saved_manifest));
+        REQUIRE(m2.entry_count() == 3u);
+        REQUIRE(m2.find_entry(make_hash("root.json")));
+        REQUIRE(m2.find_entry(make_hash("root.json"))->type == "fake_asset");
+        REQUIRE(m2.find_entry(make_hash("root.json"))->dependencies == root->dependencies);
+        REQUIRE(m2.find_entry(make_hash("root.json"))->size == root->size);
+        REQUIRE(m2.find_entry(make_hash("root.json"))->content_hash == root->content_hash);
+        REQUIRE(m2.find_entry(make_hash("dep1.json"))->size == 0u);
+        REQUIRE(m2.find_entry(make_hash("dep2.json")));
+        REQUIRE(m2.find_entry(make_hash("dep2.json"))->dependencies.empty());
+
+        const str invalid_json = R"json({ "assets" : [{ "address" : "root.json" }] })json";
+        REQUIRE_FALSE(asset_manifests::try_load_manifest(m, buffer(invalid_json.data(), invalid_json.size())));
+        REQUIRE(m.entry_count() == 3u);
+
+        safe_starter_initializer initializer;
+        library& l = the<library>();
+        l.register_asset_type<fake_asset>();
+        l.register_asset_type<big_fake_asset>();
+        l.manifest(std::move(m));
+        {
+            auto p = l.load_asset_async<fake_asset>("root.json");
+            REQUIRE(l.loading_asset_count()
+                + l.cache().asset_count<big_fake_asset>() == 2u);
+
+            auto dep1 = l.load_asset<big_fake_asset>("dep1.json");
+            auto dep2 = l.load_asset<big_fake_asset>("dep2.json");
+            REQUIRE(dep1);
+            REQUIRE(dep2);
+            REQUIRE(l.cache().asset_count<big_fake_asset>() == 2u);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        REQUIRE(l.unload_unused_assets() == 3u);
+        {
+            // addresses are normalized for the manifest lookup
+            auto p = l.load_asset_async<fake_asset>("sprites/.././root.json");
+            REQUIRE(l.loading_asset_count()
+                + l.cache().asset_count<big_fake_asset>() == 2u);
+            REQUIRE(l.load_asset<big_fake_asset>("dep1.json"));
+            REQUIRE(l.load_asset<big_fake_asset>("dep2.json"));
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        REQUIRE(l.unload_unused_assets() == 3u);
+    }
+}
+
+TEST_CASE("library_cooked_json"){
+    safe_starter_initializer initializer;
+    library& l = the<library>();
+    {
+        const str source_address = "cooked_json_untests.json";
+        const str cooked_address = json_asset::cooked_address(source_address);
+        const str source_path = the<vfs>().resolve_scheme_aliases(l.root() / source_address).path();
+        const str cooked_path = the<vfs>().resolve_scheme_aliases(l.root() / cooked_address).path();
+        REQUIRE(filesystem::remove_file(source_path));
+        REQUIRE(filesystem::remove_file(cooked_path));
+
+        rapidjson::Document doc;
+        REQUIRE_FALSE(doc.Parse(R"json({ "name" : "cooked", "value" : 42 })json").HasParseError());
+        buffer cooked;
+        REQUIRE(json_utils::try_save_cooked_json(cooked, doc));
+        REQUIRE(filesystem::try_write_all(cooked, cooked_path, false));
+        {
+            auto json = l.load_asset<json_asset>(source_address);
+            REQUIRE(json);
+            REQUIRE(json->cooked());
+            REQUIRE(*json->content() == doc);
+            REQUIRE_FALSE(json->validated_for(sprite_asset::type_name()));
+        }
+        l.unload_unused_assets();
+
+        REQUIRE(json_utils::try_save_cooked_json(
+            cooked, doc, json_asset::schema_tag(sprite_asset::type_name())));
+        REQUIRE(filesystem::try_write_all(cooked, cooked_path, false));
+        {
+            auto json = l.load_asset<json_asset>(source_address);
+            REQUIRE(json);
+            REQUIRE(json->validated_for(sprite_asset::type_name()));
+            REQUIRE_FALSE(json->validated_for(prefab_asset::type_name()));
+        }
+        l.unload_unused_assets();
+
+        // the source is newer than the cooked form
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        REQUIRE(filesystem::try_write_all(str(R"json({ "name" : "source" })json"), source_path, false));
+        {
+            auto json = l.load_asset<json_asset>(source_address);
+            REQUIRE(json);
+            REQUIRE_FALSE(json->cooked());
+            REQUIRE(str((*json->content())["name"].GetString()) == "source");
+        }
+        l.unload_unused_assets();
+
+        REQUIRE(filesystem::remove_file(source_path));
+        REQUIRE(filesystem::remove_file(cooked_path));
+    }
+}
+
+TEST_CASE("library_load_cancellation"){
+    safe_starter_initializer initializer;
+    library& l = the<library>();
+    {
+        cancellation_token token;
+        token.cancel();
+        auto p = l.load_asset_async<text_asset>(
+            "text_asset.txt", stdex::jobber_priority::highest, token);
+        the<deferrer>().active_safe_wait_promise(p);
+        REQUIRE_THROWS_AS(p.get(), deferrer_cancelled_exception);
+        REQUIRE(l.loading_asset_count() == 0u);
+        REQUIRE_FALSE(l.cache().find<text_asset>(make_hash("text_asset.txt")));
+    }
+    {
+        cancellation_token token;
+        auto p = l.load_asset_async<json_asset>(
+            "prefab.json", stdex::jobber_priority::highest, token);
+        the<deferrer>().active_safe_wait_promise(p);
+        REQUIRE(p.get());
+        REQUIRE(l.cache().find<text_asset>(make_hash("prefab.json")));
+    }
+    {
+        // cancelling after the start drops the pending work,
+        // main thread tasks don't run until the wait
+        main_thread_fake_asset_loads = 0u;
+        cancellation_token token;
+        auto p = l.load_asset_async<main_thread_fake_asset>(
+            "cancelled", stdex::jobber_priority::lowest, token);
+        REQUIRE(l.loading_asset_count() == 1u);
+        token.cancel();
+        the<deferrer>().active_safe_wait_promise(p);
+        REQUIRE_THROWS_AS(p.get(), deferrer_cancelled_exception);
+        REQUIRE(main_thread_fake_asset_loads == 0u);
+        REQUIRE(l.loading_asset_count() == 0u);
+    }
+    {
+        // a joined load goes on while any of its requesters wants it
+        // and runs with the highest of their priorities
+        main_thread_fake_asset_loads = 0u;
+        cancellation_token token1;
+        cancellation_token token2;
+        auto p1 = l.load_asset_async<main_thread_fake_asset>(
+            "joined", stdex::jobber_priority::lowest, token1);
+        auto p2 = l.load_asset_async<main_thread_fake_asset>(
+            "joined", stdex::jobber_priority::highest, token2);
+        REQUIRE(l.loading_asset_count() == 1u);
+        token1.cancel();
+        the<deferrer>().active_safe_wait_promise(p1);
+        the<deferrer>().active_safe_wait_promise(p2);
+        REQUIRE(p1.get());
+        REQUIRE(p1.get() == p2.get());
+        REQUIRE(main_thread_fake_asset_loads == 1u);
+        REQUIRE(main_thread_fake_asset_priority == stdex::jobber_priority::highest);
+    }
+    {
+        // and it's dropped when all of them cancel it
+        main_thread_fake_asset_loads = 0u;
+        cancellation_token token1;
+        cancellation_token token2;
+        auto p1 = l.load_asset_async<main_thread_fake_asset>(
+            "all_cancelled", stdex::jobber_priority::normal, token1);
+        auto p2 = l.load_asset_async<main_thread_fake_asset>(
+            "all_cancelled", stdex::jobber_priority::normal, token2);
+        token1.cancel();
+        token2.cancel();
+        the<deferrer>().active_safe_wait_promise(p2);
+        REQUIRE_THROWS_AS(p1.get(), deferrer_cancelled_exception);
+        REQUIRE_THROWS_AS(p2.get(), deferrer_cancelled_exception);
+        REQUIRE(main_thread_fake_asset_loads == 0u);
+        REQUIRE(l.loading_asset_count() == 0u);
+
+        // a new request starts the load again
+        auto p3 = l.load_asset_async<main_thread_fake_asset>("all_cancelled");
+        the<deferrer>().active_safe_wait_promise(p3);
+        REQUIRE(p3.get());
+        REQUIRE(main_thread_fake_asset_loads == 1u);
+    }
+}
+
+TEST_CASE("library_streaming"){
+    safe_starter_initializer initializer;
+    library& l = the<library>();
+    l.register_placeholder<slow_fake_asset>(-1);
+    REQUIRE(l.has_placeholder<slow_fake_asset>());
+    REQUIRE_FALSE(l.has_placeholder<fake_asset>());
+    {
+        slow_fake_asset_ready = false;
+        REQUIRE_FALSE(l.stream_main_asset<fake_asset>("fake"));
+
+        // placeholders are returned at once and shared while streaming
+        auto streamed = l.stream_main_asset<slow_fake_asset>("slow");
+        REQUIRE(streamed);
+        REQUIRE(streamed->content() == -1);
+        REQUIRE(streamed == l.stream_main_asset<slow_fake_asset>("slow"));
+
+        // streaming dependencies don't wait for loading
+        asset_dependencies dependencies;
+        dependencies.add_dependency<slow_fake_asset>("slow_dependency");
+        deferrer::task_context context = deferrer::current_context();
+        context.streaming = true;
+        auto group_p = [&dependencies, &l, &context](){
+            deferrer::context_scope scope(context);
+            return dependencies.load_async(l);
+        }();
+        REQUIRE(group_p.wait_for(std::chrono::seconds(0)) == stdex::promise_wait_status::no_timeout);
+        auto dependency = group_p.get().find_asset<slow_fake_asset>("slow_dependency");
+        REQUIRE(dependency);
+        REQUIRE(dependency->content() == -1);
+
+        // the real content is filled in at a frame point only
+        slow_fake_asset_ready = true;
+        auto loaded_p = l.load_main_asset_async<slow_fake_asset>("slow");
+        the<deferrer>().active_safe_wait_promise(loaded_p);
+        auto loaded_dependency_p = l.load_main_asset_async<slow_fake_asset>("slow_dependency");
+        the<deferrer>().active_safe_wait_promise(loaded_dependency_p);
+        the<deferrer>().process_main_thread_tasks();
+        REQUIRE(streamed->content() == -1);
+        REQUIRE(l.stream_main_asset<slow_fake_asset>("slow") == streamed);
+
+        REQUIRE(l.fill_streamed_assets() == 2u);
+        REQUIRE(l.fill_streamed_assets() == 0u);
+        REQUIRE(streamed->content() == 42);
+        REQUIRE(dependency->content() == 42);
+
+        // the placeholder is cached instead of the loaded copy
+        loaded_p = l.load_main_asset_async<slow_fake_asset>("slow");
+        the<deferrer>().active_safe_wait_promise(loaded_p);
+        REQUIRE(loaded_p.get() == streamed);
+        REQUIRE(l.stream_main_asset<slow_fake_asset>("slow") == streamed);
+    }
+    {
+        // streamed dependencies of loaders
+        auto loaded_p = l.load_dependency_async<slow_fake_asset>("slow_loader_dependency");
+        the<deferrer>().active_safe_wait_promise(loaded_p);
+        REQUIRE(loaded_p.get()->content() == 42);
+
+        deferrer::task_context context = deferrer::current_context();
+        context.streaming = true;
+        deferrer::context_scope scope(context);
+        auto streamed_p = l.load_dependency_async<slow_fake_asset>("slow_streamed_dependency");
+        REQUIRE(streamed_p.wait_for(std::chrono::seconds(0)) == stdex::promise_wait_status::no_timeout);
+        REQUIRE(streamed_p.get()->content() == -1);
+
+        auto real_p = l.load_main_asset_async<slow_fake_asset>("slow_streamed_dependency");
+        the<deferrer>().active_safe_wait_promise(real_p);
+        the<deferrer>().process_main_thread_tasks();
+        REQUIRE(l.fill_streamed_assets() == 1u);
+        REQUIRE(streamed_p.get()->content() == 42);
+    }
+    {
+        // failed streaming loads are not repeated
+        l.register_placeholder<failing_fake_asset>(-1);
+        failing_fake_asset_loads = 0u;
+        auto streamed = l.stream_main_asset<failing_fake_asset>("failing");
+        REQUIRE(streamed);
+        the<deferrer>().process_main_thread_tasks();
+        REQUIRE(l.stream_main_asset<failing_fake_asset>("failing") == streamed);
+        REQUIRE(l.fill_streamed_assets() == 0u);
+        REQUIRE(streamed->content() == -1);
+        REQUIRE(failing_fake_asset_loads == 1u);
+    }
+    {
+        // default placeholders
+        REQUIRE(l.has_placeholder<sprite_asset>());
+        REQUIRE(l.has_placeholder<material_asset>());
+    }
+    {
+        // prefabs are ready with placeholders of their dependencies
+        REQUIRE(l.has_placeholder<model_asset>());
+        const str prefab_address = "streaming_prefab_untests.json";
+        const str prefab_path = the<vfs>().resolve_scheme_aliases(l.root() / prefab_address).path();
+        REQUIRE(filesystem::try_write_all(
+            str(R"json({ "components" : { "model_renderer" : { "model" : "model.json" } } })json"),
+            prefab_path,
+            false));
+
+        auto prefab_p = l.stream_asset_async<prefab_asset>(prefab_address);
+        the<deferrer>().active_safe_wait_promise(prefab_p);
+        auto prefab_res = prefab_p.get_or_default(nullptr);
+        REQUIRE(prefab_res);
+
+        gobject_iptr inst = the<world>().instantiate(prefab_res->content());
+        REQUIRE(inst->get_component<model_renderer>()->model());
+        the<world>().destroy_instance(inst);
+
+        REQUIRE(filesystem::remove_file(prefab_path));
+    }
+}
@@ -734,6 +734,182 @@ TEST_CASE("node") {
                 math::make_translation_matrix4(60.f,0.f,0.f));
         }
     }
+    SECTION("world_matrix/deep") {
+        auto root = node::create();
+        vector<node_iptr> chain{root};
+        for ( std::size_t i = 0; i < 1000; ++i ) {
+            auto n = node::create(chain.back());
+            n->translation({1.f,0.f,0.f});
+            chain.push_back(n);
+        }
+        REQUIRE(chain.back()->world_matrix() ==
+            math::make_translation_matrix4(1000.f,0.f,0.f));
+
+        for ( std::size_t i = 0; i < 1000; ++i ) {
+            root->translation({f32(i),0.f,0.f});
+        }
+        REQUIRE(chain[500]->world_matrix() ==
+            math::make_translation_matrix4(1499.f,0.f,0.f));
+        REQUIRE(chain.back()->world_matrix() ==
+            math::make_translation_matrix4(1999.f,0.f,0.f));
+
+        chain[500]->translation({2.f,0.f,0.f});
+        REQUIRE(chain.back()->world_matrix() ==
+            math::make_translation_matrix4(2000.f,0.f,0.f));
+        REQUIRE(chain[499]->world_matrix() ==
+            math::make_translation_matrix4(1498.f,0.f,0.f));
+
+        chain[500]->remove_from_parent();
+        REQUIRE(chain.back()->world_matrix() ==
+            math::make_translation_matrix4(502.f,0.f,0.f));
+
+        root->add_child(chain[500]);
+        REQUIRE(chain.back()->world_matrix() ==
+            math::make_translation_matrix4(1501.f,0.f,0.f));
+    }
+    SECTION("world_matrix/read_scope") {
+        auto root = node::create();
+        vector<node_iptr> chain{root};
+        for ( std::size_t i = 0; i < 100; ++i ) {
+            auto n = node::create(chain.back());
+            n->translation({1.f,0.f,0.f});
+            chain.push_back(n);
+        }
+        {
+            node::read_scope scope;
+            REQUIRE(chain.back()->world_matrix() ==
+                math::make_translation_matrix4(100.f,0.f,0.f));
+            REQUIRE(chain[50]->world_matrix() ==
+                math::make_translation_matrix4(50.f,0.f,0.f));
+
+            // changes in the scope are still seen
+            root->translation({10.f,0.f,0.f});
+            REQUIRE(chain.back()->world_matrix() ==
+                math::make_translation_matrix4(110.f,0.f,0.f));
+            {
+                node::read_scope inner;
+                REQUIRE(chain[50]->world_matrix() ==
+                    math::make_translation_matrix4(60.f,0.f,0.f));
+                chain[50]->remove_from_parent();
+                REQUIRE(chain.back()->world_matrix() ==
+                    math::make_translation_matrix4(51.f,0.f,0.f));
+            }
+            REQUIRE(chain.back()->world_matrix() ==
+                math::make_translation_matrix4(51.f,0.f,0.f));
+            root->add_child(chain[50]);
+        }
+        root->translation({0.f,0.f,0.f});
+        REQUIRE(chain.back()->world_matrix() ==
+            math::make_translation_matrix4(51.f,0.f,0.f));
+    }
+    SECTION("local_bounds") {
+        auto n = node::create();
+        REQUIRE_FALSE(n->has_local_bounds());
+        REQUIRE_FALSE(n->has_world_bounds());
+
+        n->local_bounds(b3f(1.f,2.f,3.f));
+        REQUIRE(n->has_local_bounds());
+        REQUIRE(n->local_bounds() == b3f(1.f,2.f,3.f));
+        REQUIRE(n->has_world_bounds());
+        REQUIRE(n->world_bounds() == b3f(1.f,2.f,3.f));
+
+        REQUIRE(n->reset_local_bounds());
+        REQUIRE_FALSE(n->reset_local_bounds());
+        REQUIRE_FALSE(n->has_local_bounds());
+        REQUIRE_FALSE(n->has_world_bounds());
+    }
+    SECTION("world_bounds") {
+        {
+            auto p = node::create();
+            p->translation({10.f,0.f,0.f});
+
+            auto n = node::create(p);
+            n->translation({20.f,0.f,0.f});
+            n->scale({2.f,2.f,2.f});
+            n->local_bounds(b3f(1.f,1.f,1.f));
+
+            REQUIRE_FALSE(p->has_local_bounds());
+            REQUIRE(p->has_world_bounds());
+            REQUIRE(p->world_bounds() == b3f(30.f,0.f,0.f,2.f,2.f,2.f));
+            REQUIRE(n->world_bounds() == b3f(30.f,0.f,0.f,2.f,2.f,2.f));
+
+            p->translation({0.f,0.f,0.f});
+            REQUIRE(p->world_bounds() == b3f(20.f,0.f,0.f,2.f,2.f,2.f));
+
+            p->local_bounds(b3f(-1.f,-1.f,-1.f,1.f,1.f,1.f));
+            REQUIRE(p->world_bounds() == b3f(-1.f,-1.f,-1.f,23.f,3.f,3.f));
+
+            n->local_bounds(b3f(1.f,1.f,1.f,1.f,1.f,1.f));
+            REQUIRE(p->world_bounds() == b3f(-1.f,-1.f,-1.f,25.f,5.f,5.f));
+
+            n->remove_from_parent();
+            REQUIRE(p->world_bounds() == b3f(-1.f,-1.f,-1.f,1.f,1.f,1.f));
+            REQUIRE(n->world_bounds() == b3f(22.f,2.f,2.f,2.f,2.f,2.f));
+        }
+        {
+            auto p1 = node::create();
+            auto p2 = node::create(p1);
+            auto n = node::create();
+            n->local_bounds(b3f(1.f,1.f,1.f));
+            REQUIRE_FALSE(p1->has_world_bounds());
+
+            p2->add_child(n);
+            REQUIRE(p1->has_world_bounds());
+            REQUIRE(p1->world_bounds() == b3f(1.f,1.f,1.f));
+
+            p2->translation({5.f,0.f,0.f});
+            REQUIRE(p1->world_bounds() == b3f(5.f,0.f,0.f,1.f,1.f,1.f));
+
+            n->reset_local_bounds();
+            REQUIRE_FALSE(p1->has_world_bounds());
+        }
+    }
+    SECTION("transform_step") {
+        ecs::registry r;
+        auto moved = node::create(make_intrusive<gobject>(r));
+        auto still = node::create(make_intrusive<gobject>(r));
+        auto ownerless = node::create();
+        moved->translation({1.f,0.f,0.f});
+
+        node::begin_transform_step();
+        moved->translation({2.f,0.f,0.f});
+        moved->translation({3.f,0.f,0.f});
+        ownerless->translation({1.f,0.f,0.f});
+        auto created = node::create(make_intrusive<gobject>(r));
+        created->translation({1.f,0.f,0.f});
+
+        vector<std::pair<ecs::entity_id, t3f>> previous;
+        REQUIRE(node::end_transform_step(previous));
+        moved->translation({4.f,0.f,0.f});
+
+        REQUIRE(previous.size() == 1u);
+        REQUIRE(previous[0].first == moved->owner()->entity().id());
+        REQUIRE(previous[0].second.translation == v3f(1.f,0.f,0.f));
+
+        previous.clear();
+        REQUIRE(node::end_transform_step(previous));
+        REQUIRE(previous.empty());
+    }
+    SECTION("local_bounds_in_world_version") {
+        auto p = node::create();
+        auto n = node::create(p);
+        n->local_bounds(b3f(1.f,1.f,1.f));
+
+        const u32 v1 = n->local_bounds_in_world_version();
+        REQUIRE(v1 == n->local_bounds_in_world_version());
+
+        p->translation({5.f,0.f,0.f});
+        const u32 v2 = n->local_bounds_in_world_version();
+        REQUIRE(v2 != v1);
+        REQUIRE(n->local_bounds_in_world() == b3f(5.f,0.f,0.f,1.f,1.f,1.f));
+
+        n->local_bounds(b3f(2.f,2.f,2.f));
+        const u32 v3 = n->local_bounds_in_world_version();
+        REQUIRE(v3 != v2);
+
+        n->local_bounds(b3f(2.f,2.f,2.f));
+        REQUIRE(v3 == n->local_bounds_in_world_version());
+    }
     SECTION("lifetime") {
         {
             fake_node::reset_counters();
@@ -0,0 +1,65 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include "_high.hpp"
+using namespace e2d;
+
+namespace
+{
+    vector<ecs::entity_id> sorted_ids(
+        const ecs::registry& owner,
+        const sorted_components<camera>& cameras)
+    {
+        vector<ecs::entity_id> result;
+        cameras.for_each(owner, [&result](const ecs::const_entity& e, const camera&){
+            result.push_back(e.id());
+        });
+        return result;
+    }
+}
+
+TEST_CASE("sorted_components") {
+    ecs::registry owner;
+    sorted_components<camera> cameras;
+
+    ecs::entity e1 = owner.create_entity();
+    ecs::entity e2 = owner.create_entity();
+    ecs::entity e3 = owner.create_entity();
+    e1.assign_component<camera>(camera().depth(3));
+    e2.assign_component<camera>(camera().depth(1));
+    e3.assign_component<camera>(camera().depth(2));
+
+    cameras.update(owner);
+    REQUIRE(sorted_ids(owner, cameras) == vector<ecs::entity_id>{e2.id(), e3.id(), e1.id()});
+
+    SECTION("depth reorder") {
+        e1.get_component<camera>().depth(0);
+        cameras.update(owner);
+        REQUIRE(sorted_ids(owner, cameras) == vector<ecs::entity_id>{e1.id(), e2.id(), e3.id()});
+    }
+    SECTION("add/remove") {
+        ecs::entity e4 = owner.create_entity();
+        e4.assign_component<camera>(camera().depth(-1));
+        cameras.update(owner);
+        REQUIRE(sorted_ids(owner, cameras) == vector<ecs::entity_id>{e4.id(), e2.id(), e3.id(), e1.id()});
+
+        e2.remove_component<camera>();
+        cameras.update(owner);
+        REQUIRE(sorted_ids(owner, cameras) == vector<ecs::entity_id>{e4.id(), e3.id(), e1.id()});
+    }
+    SECTION("destroy and create with the same count") {
+        const ecs::entity_id old_id = e3.id();
+        e3.destroy();
+        ecs::entity e4 = owner.create_entity();
+        e4.assign_component<camera>(camera().depth(2));
+        REQUIRE(owner.component_count<camera>() == 3u);
+        REQUIRE_FALSE(owner.valid_entity(old_id));
+
+        cameras.update(owner);
+        REQUIRE(cameras.size() == 3u);
+        REQUIRE(sorted_ids(owner, cameras) == vector<ecs::entity_id>{e2.id(), e4.id(), e1.id()});
+    }
+}
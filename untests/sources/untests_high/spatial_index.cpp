@@ -0,0 +1,282 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include "_high.hpp"
+using namespace e2d;
+
+#include <random>
+
+namespace
+{
+    vector<b3f> make_random_bounds(std::size_t count, f32 world_size) {
+        std::mt19937 gen(42u);
+        std::uniform_real_distribution<f32> pos_dist(0.f, world_size);
+        std::uniform_real_distribution<f32> size_dist(1.f, 20.f);
+        vector<b3f> result;
+        result.reserve(count);
+        for ( std::size_t i = 0; i < count; ++i ) {
+            result.emplace_back(
+                pos_dist(gen), pos_dist(gen), 0.f,
+                size_dist(gen), size_dist(gen), 0.f);
+        }
+        return result;
+    }
+
+    bool brute_overlaps(const b3f& b, const b2f& r) noexcept {
+        return r.position.x <= b.position.x + b.size.x
+            && r.position.x + r.size.x >= b.position.x
+            && r.position.y <= b.position.y + b.size.y
+            && r.position.y + r.size.y >= b.position.y;
+    }
+
+    class safe_starter_initializer final : private noncopyable {
+    public:
+        safe_starter_initializer() {
+            modules::initialize<starter>(0, nullptr,
+                starter::parameters(
+                    engine::parameters("spatial_index_untests", "enduro2d")
+                        .without_graphics(true)));
+        }
+
+        ~safe_starter_initializer() noexcept {
+            modules::shutdown<starter>();
+        }
+    };
+
+    template < typename Container >
+    vector<spatial_index::key_type> sorted(Container&& c) {
+        vector<spatial_index::key_type> result(c.begin(), c.end());
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+}
+
+TEST_CASE("spatial_index") {
+    SECTION("empty") {
+        spatial_index index;
+        vector<spatial_index::key_type> keys;
+        REQUIRE(index.size() == 0u);
+        REQUIRE(index.height() == 0u);
+        REQUIRE(index.query_point(v3f::zero(), std::back_inserter(keys)) == 0u);
+        REQUIRE(index.query_rect(b2f(100.f, 100.f), std::back_inserter(keys)) == 0u);
+        REQUIRE_FALSE(index.remove(1u));
+        REQUIRE(keys.empty());
+    }
+    SECTION("update/remove") {
+        spatial_index index(1.f);
+        REQUIRE(index.update(1u, b3f(0.f, 0.f, 0.f, 10.f, 10.f, 0.f)));
+        REQUIRE(index.update(2u, b3f(20.f, 0.f, 0.f, 10.f, 10.f, 0.f)));
+        REQUIRE(index.size() == 2u);
+        REQUIRE(index.has(1u));
+        REQUIRE(index.has(2u));
+        REQUIRE_FALSE(index.has(3u));
+
+        b3f bounds;
+        REQUIRE(index.find_bounds(2u, bounds));
+        REQUIRE(bounds == b3f(20.f, 0.f, 0.f, 10.f, 10.f, 0.f));
+
+        // inside the margin
+        REQUIRE_FALSE(index.update(1u, b3f(0.5f, 0.f, 0.f, 10.f, 10.f, 0.f)));
+        REQUIRE(index.find_bounds(1u, bounds));
+        REQUIRE(bounds == b3f(0.5f, 0.f, 0.f, 10.f, 10.f, 0.f));
+
+        // outside the margin
+        REQUIRE(index.update(1u, b3f(50.f, 0.f, 0.f, 10.f, 10.f, 0.f)));
+
+        vector<spatial_index::key_type> keys;
+        REQUIRE(index.query_point(v3f(5.f, 5.f, 0.f), std::back_inserter(keys)) == 0u);
+        REQUIRE(index.query_point(v3f(55.f, 5.f, 0.f), std::back_inserter(keys)) == 1u);
+        REQUIRE(keys == vector<spatial_index::key_type>{1u});
+
+        REQUIRE(index.remove(1u));
+        REQUIRE_FALSE(index.remove(1u));
+        REQUIRE(index.size() == 1u);
+        keys.clear();
+        REQUIRE(index.query_point(v3f(55.f, 5.f, 0.f), std::back_inserter(keys)) == 0u);
+
+        index.clear();
+        REQUIRE(index.size() == 0u);
+        REQUIRE_FALSE(index.has(2u));
+    }
+    SECTION("queries") {
+        spatial_index index;
+        index.update(1u, b3f(0.f, 0.f, 0.f, 10.f, 10.f, 0.f));
+        index.update(2u, b3f(20.f, 0.f, 0.f, 10.f, 10.f, 0.f));
+        index.update(3u, b3f(0.f, 20.f, 0.f, 10.f, 10.f, 0.f));
+
+        vector<spatial_index::key_type> keys;
+        REQUIRE(index.query_rect(b2f(5.f, 5.f, 20.f, 1.f), std::back_inserter(keys)) == 2u);
+        REQUIRE(sorted(keys) == vector<spatial_index::key_type>{1u, 2u});
+
+        keys.clear();
+        REQUIRE(index.query_bounds(b3f(-1.f, -1.f, -1.f, 100.f, 100.f, 2.f), std::back_inserter(keys)) == 3u);
+
+        keys.clear();
+        REQUIRE(index.query_ray(
+            v3f(-10.f, 5.f, 0.f),
+            v3f(1.f, 0.f, 0.f),
+            100.f,
+            std::back_inserter(keys)) == 2u);
+        REQUIRE(sorted(keys) == vector<spatial_index::key_type>{1u, 2u});
+
+        keys.clear();
+        REQUIRE(index.query_ray(
+            v3f(-10.f, 5.f, 0.f),
+            v3f(1.f, 0.f, 0.f),
+            15.f,
+            std::back_inserter(keys)) == 1u);
+        REQUIRE(keys == vector<spatial_index::key_type>{1u});
+
+        keys.clear();
+        const m4f view_proj = math::make_orthogonal_lh_matrix4(
+            v2f(30.f, 30.f), -1.f, 1.f);
+        REQUIRE(index.query_frustum(view_proj, std::back_inserter(keys)) == 1u);
+        REQUIRE(keys == vector<spatial_index::key_type>{1u});
+    }
+    SECTION("brute_force") {
+        const vector<b3f> bounds = make_random_bounds(2000u, 1000.f);
+
+        spatial_index index;
+        for ( std::size_t i = 0; i < bounds.size(); ++i ) {
+            index.update(math::numeric_cast<spatial_index::key_type>(i), bounds[i]);
+        }
+        REQUIRE(index.size() == bounds.size());
+        REQUIRE(index.height() < 32u);
+
+        std::mt19937 gen(7u);
+        std::uniform_real_distribution<f32> dist(0.f, 1000.f);
+        for ( std::size_t i = 0; i < 100; ++i ) {
+            const b2f rect(dist(gen), dist(gen), 50.f, 50.f);
+
+            vector<spatial_index::key_type> tree_keys;
+            index.query_rect(rect, std::back_inserter(tree_keys));
+
+            vector<spatial_index::key_type> brute_keys;
+            for ( std::size_t j = 0; j < bounds.size(); ++j ) {
+                if ( brute_overlaps(bounds[j], rect) ) {
+                    brute_keys.push_back(math::numeric_cast<spatial_index::key_type>(j));
+                }
+            }
+
+            REQUIRE(sorted(tree_keys) == brute_keys);
+        }
+
+        for ( std::size_t i = 0; i < bounds.size(); i += 2 ) {
+            REQUIRE(index.remove(math::numeric_cast<spatial_index::key_type>(i)));
+        }
+        REQUIRE(index.size() == bounds.size() / 2u);
+
+        vector<spatial_index::key_type> keys;
+        index.query_rect(b2f(-100.f, -100.f, 2000.f, 2000.f), std::back_inserter(keys));
+        REQUIRE(keys.size() == bounds.size() / 2u);
+        for ( spatial_index::key_type k : keys ) {
+            REQUIRE(k % 2u == 1u);
+        }
+    }
+    SECTION("performance") {
+        std::printf("-= spatial_index::performance tests =-\n");
+    #if defined(E2D_BUILD_MODE) && E2D_BUILD_MODE == E2D_BUILD_MODE_DEBUG
+        const std::size_t task_n = 1'000;
+    #else
+        const std::size_t task_n = 10'000;
+    #endif
+        const vector<b3f> bounds = make_random_bounds(10'000u, 5000.f);
+
+        spatial_index index;
+        for ( std::size_t i = 0; i < bounds.size(); ++i ) {
+            index.update(math::numeric_cast<spatial_index::key_type>(i), bounds[i]);
+        }
+
+        vector<b2f> rects;
+        rects.reserve(task_n);
+        std::mt19937 gen(11u);
+        std::uniform_real_distribution<f32> dist(0.f, 5000.f);
+        for ( std::size_t i = 0; i < task_n; ++i ) {
+            rects.emplace_back(dist(gen), dist(gen), 100.f, 100.f);
+        }
+
+        std::size_t tree_result = 0;
+        {
+            e2d_untests::verbose_profiler_ms p("query_rect");
+            vector<spatial_index::key_type> keys;
+            for ( const b2f& rect : rects ) {
+                keys.clear();
+                tree_result += index.query_rect(rect, std::back_inserter(keys));
+            }
+            p.done(tree_result);
+        }
+        std::size_t brute_result = 0;
+        {
+            e2d_untests::verbose_profiler_ms p("linear scan");
+            for ( const b2f& rect : rects ) {
+                for ( const b3f& b : bounds ) {
+                    if ( brute_overlaps(b, rect) ) {
+                        ++brute_result;
+                    }
+                }
+            }
+            p.done(brute_result);
+        }
+        REQUIRE(tree_result == brute_result);
+    }
+}
+
+TEST_CASE("spatial_index_system") {
+    safe_starter_initializer initializer;
+    world& w = the<world>();
+    spatial_index& index = w.spatial();
+    spatial_index_system system;
+
+    auto parent = w.instantiate();
+    auto child = w.instantiate();
+    const node_iptr parent_n = parent->get_component<actor>()->node();
+    const node_iptr child_n = child->get_component<actor>()->node();
+    parent_n->add_child(child_n);
+    child_n->local_bounds(b3f(1.f, 1.f, 0.f));
+    const ecs::entity_id parent_id = parent->entity().id();
+    const ecs::entity_id child_id = child->entity().id();
+
+    system.process(w.registry());
+    REQUIRE(index.size() == 1u);
+
+    b3f bounds;
+    REQUIRE(index.find_bounds(child_id, bounds));
+    REQUIRE(bounds == b3f(1.f, 1.f, 0.f));
+    REQUIRE_FALSE(index.has(parent_id));
+
+    {
+        // moved ancestors move the subtree
+        parent_n->translation(v3f(10.f, 0.f, 0.f));
+        system.process(w.registry());
+        REQUIRE(index.find_bounds(child_id, bounds));
+        REQUIRE(bounds == b3f(10.f, 0.f, 0.f, 1.f, 1.f, 0.f));
+    }
+    {
+        // nodes with new bounds are indexed
+        parent_n->local_bounds(b3f(2.f, 2.f, 0.f));
+        system.process(w.registry());
+        REQUIRE(index.find_bounds(parent_id, bounds));
+        REQUIRE(bounds == b3f(10.f, 0.f, 0.f, 2.f, 2.f, 0.f));
+    }
+    {
+        // nodes without bounds are removed
+        child_n->reset_local_bounds();
+        system.process(w.registry());
+        REQUIRE(index.size() == 1u);
+        REQUIRE_FALSE(index.has(child_id));
+    }
+    {
+        // keys of actors removed bypassing the world
+        // are dropped once they outnumber the actors
+        parent->entity().remove_component<actor>();
+        child->entity().remove_component<actor>();
+        system.process(w.registry());
+        REQUIRE(index.size() == 0u);
+    }
+
+    w.destroy_instance(child);
+    w.destroy_instance(parent);
+}
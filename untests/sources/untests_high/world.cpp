@@ -9,6 +9,37 @@ using namespace e2d;
 
 namespace
 {
+    struct position { f32 x{0.f}; };
+    struct velocity { f32 x{0.f}; };
+    struct health { i32 hp{0}; };
+
+    class log_system final : public ecs::system {
+    public:
+        log_system(vector<str>& log, std::mutex& mutex, str name)
+        : log_(log)
+        , mutex_(mutex)
+        , name_(std::move(name)) {}
+
+        void process(ecs::registry&) override {
+            std::lock_guard<std::mutex> guard(mutex_);
+            log_.push_back(name_);
+        }
+    private:
+        vector<str>& log_;
+        std::mutex& mutex_;
+        str name_;
+    };
+
+    class move_system final : public ecs::system {
+    public:
+        void process(ecs::registry& owner) override {
+            owner.for_joined_components<position, velocity>(
+                [](const ecs::entity&, position& p, const velocity& v){
+                    p.x += v.x;
+                });
+        }
+    };
+
     class safe_starter_initializer final : private noncopyable {
     public:
         safe_starter_initializer() {
@@ -35,4 +66,405 @@ TEST_CASE("world") {
         w.registry().destroy_entity(e);
         REQUIRE_FALSE(cw.registry().valid_entity(e));
     }
+    SECTION("allocator") {
+        const auto stats = cw.allocator().stats();
+        {
+            auto inst = w.instantiate();
+            REQUIRE(cw.allocator().stats().live_blocks == stats.live_blocks + 2u);
+            w.destroy_instance(inst);
+        }
+        REQUIRE(cw.allocator().stats().live_blocks == stats.live_blocks);
+        REQUIRE(cw.allocator().stats().allocations == stats.allocations + 2u);
+    }
+    SECTION("instances") {
+        const std::size_t count = cw.instance_count();
+
+        vector<gobject_iptr> insts;
+        for ( std::size_t i = 0; i < 10; ++i ) {
+            insts.push_back(w.instantiate());
+        }
+        REQUIRE(cw.instance_count() == count + 10u);
+        for ( const gobject_iptr& inst : insts ) {
+            REQUIRE(cw.resolve(inst->entity()) == inst);
+        }
+
+        std::size_t visited = 0u;
+        cw.for_each_instance([&visited](const gobject_iptr& inst){
+            REQUIRE(inst);
+            ++visited;
+        });
+        REQUIRE(visited == cw.instance_count());
+
+        const ecs::entity_id removed_id = insts[3]->entity().id();
+        w.destroy_instance(insts[3]);
+        insts.erase(insts.begin() + 3);
+        REQUIRE(cw.instance_count() == count + 9u);
+        for ( const gobject_iptr& inst : insts ) {
+            REQUIRE(cw.resolve(inst->entity()) == inst);
+        }
+
+        {
+            // a reused entity index must not resolve to a stale instance
+            auto e = w.registry().create_entity();
+            if ( ecs::detail::entity_id_index(e.id())
+                == ecs::detail::entity_id_index(removed_id) )
+            {
+                REQUIRE(e.id() != removed_id);
+            }
+            REQUIRE_FALSE(cw.resolve(e));
+            e.destroy();
+        }
+
+        for ( const gobject_iptr& inst : insts ) {
+            w.destroy_instance(inst);
+        }
+        REQUIRE(cw.instance_count() == count);
+    }
+    SECTION("instantiate_many") {
+        const std::size_t count = cw.instance_count();
+
+        prefab child_prefab;
+        child_prefab.set_children({prefab()});
+        prefab root_prefab;
+        root_prefab.prototype().component<health>(health{42});
+        root_prefab.set_children({child_prefab, prefab()});
+
+        {
+            auto insts = w.instantiate_many(root_prefab, 0u);
+            REQUIRE(insts.empty());
+            REQUIRE(cw.instance_count() == count);
+        }
+        {
+            const vector<t3f> transforms{
+                make_trs3(v3f(1.f,0.f,0.f), q4f::identity(), v3f::unit()),
+                make_trs3(v3f(2.f,0.f,0.f), q4f::identity(), v3f::unit()),
+                make_trs3(v3f(3.f,0.f,0.f), q4f::identity(), v3f::unit())};
+            auto insts = w.instantiate_many(root_prefab, transforms);
+            REQUIRE(insts.size() == 3u);
+            REQUIRE(cw.instance_count() == count + 12u);
+            for ( std::size_t i = 0; i < insts.size(); ++i ) {
+                REQUIRE(cw.resolve(insts[i]->entity()) == insts[i]);
+                REQUIRE(insts[i]->get_component<health>()->hp == 42);
+                const node_iptr n = insts[i]->get_component<actor>()->node();
+                REQUIRE(n->owner() == insts[i]);
+                REQUIRE(n->transform() == transforms[i]);
+                REQUIRE(n->child_count() == 2u);
+                REQUIRE(n->child_count_recursive() == 3u);
+            }
+            for ( const gobject_iptr& inst : insts ) {
+                w.destroy_instance(inst);
+            }
+            REQUIRE(cw.instance_count() == count);
+        }
+        {
+            auto insts = w.instantiate_many(child_prefab, 100u);
+            REQUIRE(insts.size() == 100u);
+            REQUIRE(cw.instance_count() == count + 200u);
+            for ( const gobject_iptr& inst : insts ) {
+                w.destroy_instance(inst);
+            }
+            REQUIRE(cw.instance_count() == count);
+        }
+    }
+    SECTION("commands") {
+        {
+            ecs::registry r;
+            auto e1 = r.create_entity();
+            auto e2 = r.create_entity();
+
+            ecs::command_buffer cb;
+            REQUIRE(cb.empty());
+            cb.assign_component<position>(e1.id(), position{1.f})
+                .assign_component<velocity>(e1.id(), velocity{2.f})
+                .assign_component<position>(e2.id(), position{3.f})
+                .destroy_entity(e2.id())
+                .assign_component<velocity>(e2.id(), velocity{4.f})
+                .create_entity(ecs::prototype().component<health>(health{5}));
+            REQUIRE(cb.size() == 6u);
+            REQUIRE_FALSE(e1.exists_component<position>());
+            REQUIRE(r.entity_count() == 2u);
+
+            cb.playback(r);
+            REQUIRE(cb.empty());
+            REQUIRE(e1.get_component<position>().x == 1.f);
+            REQUIRE(e1.get_component<velocity>().x == 2.f);
+            REQUIRE_FALSE(r.valid_entity(e2));
+            REQUIRE(r.entity_count() == 2u);
+            REQUIRE(r.component_count<health>() == 1u);
+
+            cb.remove_component<position>(e1.id())
+                .invoke([](ecs::registry& owner){
+                    owner.for_each_component<health>([](const ecs::entity&, health& h){
+                        h.hp += 1;
+                    });
+                });
+            cb.playback(r);
+            REQUIRE_FALSE(e1.exists_component<position>());
+            r.for_each_component<health>([](const ecs::const_entity&, const health& h){
+                REQUIRE(h.hp == 6);
+            });
+
+            cb.remove_all_components(e1.id()).clear();
+            cb.playback(r);
+            REQUIRE(e1.exists_component<velocity>());
+        }
+        {
+            auto inst = w.instantiate();
+            const ecs::entity_id id = inst->entity().id();
+            std::thread([&w, id](){
+                w.commands().assign_component<health>(id, health{7});
+            }).join();
+            w.commands().assign_component<position>(id, position{8.f});
+            REQUIRE_FALSE(inst->entity().exists_component<health>());
+            w.flush_commands();
+            REQUIRE(inst->entity().get_component<health>().hp == 7);
+            REQUIRE(inst->entity().get_component<position>().x == 8.f);
+            w.destroy_instance(inst);
+        }
+        {
+            // instance entities are destroyed through the world
+            const std::size_t count = w.instance_count();
+            auto inst = w.instantiate();
+            auto child = w.instantiate();
+            inst->get_component<actor>()->node()->add_child(child->get_component<actor>()->node());
+            const ecs::entity_id id = inst->entity().id();
+            const ecs::entity_id child_id = child->entity().id();
+            inst.reset();
+            child.reset();
+
+            w.commands().destroy_entity(id);
+            std::thread([&w, id](){
+                w.destroy_instance_deferred(id);
+            }).join();
+            REQUIRE(w.instance_count() == count + 2u);
+
+            w.flush_commands();
+            REQUIRE(w.instance_count() == count);
+            REQUIRE_FALSE(w.registry().valid_entity(id));
+            REQUIRE_FALSE(w.registry().valid_entity(child_id));
+        }
+        {
+            const std::size_t count = w.instance_count();
+            w.instantiate_deferred(prefab()
+                .set_prototype(ecs::prototype().component<health>(health{9}))
+                .set_children({prefab()}));
+            REQUIRE(w.instance_count() == count);
+
+            w.flush_commands();
+            REQUIRE(w.instance_count() == count + 2u);
+
+            vector<gobject_iptr> instances;
+            w.for_each_instance([&instances](const gobject_iptr& inst){
+                if ( inst->get_component<health>() ) {
+                    instances.push_back(inst);
+                }
+            });
+            REQUIRE(instances.size() == 1u);
+            REQUIRE(instances.front()->get_component<health>()->hp == 9);
+            w.destroy_instance(instances.front());
+            REQUIRE(w.instance_count() == count);
+        }
+    }
+    SECTION("owning_groups") {
+        ecs::registry r;
+        vector<ecs::entity> es;
+        for ( std::size_t i = 0; i < 100; ++i ) {
+            auto e = r.create_entity();
+            if ( i % 2 ) {
+                e.assign_component<position>(position{f32(i)});
+            }
+            if ( i % 3 ) {
+                e.assign_component<velocity>(velocity{f32(i)});
+            }
+            if ( i % 5 ) {
+                e.assign_component<health>(health{i32(i)});
+            }
+            es.push_back(e);
+        }
+
+        const auto joined_sum = [&r](){
+            f32 sum = 0.f;
+            std::size_t count = 0u;
+            r.for_joined_components<position, velocity>([&sum, &count](
+                const ecs::entity&, position& p, const velocity& v)
+            {
+                REQUIRE(p.x == v.x);
+                sum += p.x;
+                ++count;
+            });
+            return std::make_pair(sum, count);
+        };
+
+        const auto joined_sum3 = [&r](){
+            std::size_t count = 0u;
+            std::as_const(r).for_joined_components<velocity, health, position>([&count](
+                const ecs::const_entity&, const velocity& v, const health& h, const position& p)
+            {
+                REQUIRE(p.x == v.x);
+                REQUIRE(i32(v.x) == h.hp);
+                ++count;
+            });
+            return count;
+        };
+
+        const auto expected = joined_sum();
+        const auto expected3 = joined_sum3();
+        REQUIRE(r.owning_group_size<position, velocity>() == 0u);
+
+        r.register_owning_group<position, velocity>();
+        REQUIRE(r.owning_group_size<position, velocity>() == expected.second);
+        REQUIRE(r.owning_group_size<velocity, position>() == expected.second);
+        REQUIRE(r.owning_group_size<position, health>() == 0u);
+        REQUIRE(joined_sum() == expected);
+        REQUIRE(joined_sum3() == expected3);
+
+        REQUIRE_THROWS_AS(
+            (r.register_owning_group<velocity, health>()),
+            std::logic_error);
+
+        es[1].remove_component<velocity>();
+        es[2].assign_component<position>(position{2.f});
+        es[3].assign_component<velocity>(velocity{3.f});
+        es[5].destroy();
+        auto clone = r.create_entity(es[7]);
+        REQUIRE(clone.get_component<position>().x == 7.f);
+
+        std::size_t expected_size = 0u;
+        r.for_each_component<position>([&r, &expected_size](const ecs::entity& e, const position&){
+            if ( e.exists_component<velocity>() ) {
+                ++expected_size;
+            }
+        });
+        REQUIRE(r.owning_group_size<position, velocity>() == expected_size);
+        REQUIRE(joined_sum().second == expected_size);
+    }
+    SECTION("change_tracking") {
+        ecs::registry r;
+        r.enable_change_tracking<position>();
+
+        const auto changed = [&r](ecs::tick_t since){
+            vector<ecs::entity_id> ids;
+            r.for_each_changed_component<position>(since, [&ids](const ecs::entity& e, position&){
+                ids.push_back(e.id());
+            });
+            std::sort(ids.begin(), ids.end());
+            return ids;
+        };
+
+        auto e1 = r.create_entity();
+        auto e2 = r.create_entity();
+        auto e3 = r.create_entity();
+        e3.assign_component<velocity>();
+
+        const ecs::tick_t t1 = r.change_tick();
+        e1.assign_component<position>(position{1.f});
+        e2.assign_component<position>(position{2.f});
+        REQUIRE(changed(t1) == vector<ecs::entity_id>{e1.id(), e2.id()});
+        REQUIRE_FALSE(r.mark_component_changed<position>(e3));
+        REQUIRE_FALSE(r.mark_component_changed<velocity>(e3));
+
+        const ecs::tick_t t2 = r.advance_change_tick();
+        REQUIRE(t2 > t1);
+        REQUIRE(changed(t2).empty());
+        REQUIRE(r.mark_component_changed<position>(e2));
+        REQUIRE(r.mark_component_changed<position>(e2));
+        REQUIRE(changed(t2) == vector<ecs::entity_id>{e2.id()});
+        REQUIRE(changed(t1) == vector<ecs::entity_id>{e1.id(), e2.id()});
+
+        const ecs::tick_t t3 = r.advance_change_tick();
+        auto e4 = r.create_entity(e1);
+        REQUIRE(changed(t3) == vector<ecs::entity_id>{e4.id()});
+
+        e2.remove_component<position>();
+        REQUIRE(changed(t2) == vector<ecs::entity_id>{e4.id()});
+
+        r.discard_changes_before(t3);
+        REQUIRE(changed(t1) == vector<ecs::entity_id>{e4.id()});
+        r.discard_changes_before(r.advance_change_tick());
+        REQUIRE(changed(t1).empty());
+
+        e1.destroy();
+        REQUIRE(changed(t1).empty());
+    }
+    SECTION("systems") {
+        vector<str> log;
+        std::mutex mutex;
+        ecs::registry r;
+        ecs::registry_filler(r)
+            .system<log_system>(10, ecs::system_access()
+                .reads<velocity>()
+                .writes<position>(), log, mutex, "move")
+            .system<log_system>(20, ecs::system_access()
+                .writes<health>(), log, mutex, "damage")
+            .system<log_system>(30, ecs::system_access()
+                .reads<position>(), log, mutex, "draw")
+            .system<log_system>(40, log, mutex, "exclusive")
+            .system<log_system>(50, ecs::system_access()
+                .reads<health>(), log, mutex, "ui");
+
+        vector<std::size_t> stages;
+        const auto executor = [&stages](std::size_t count, const auto& task){
+            stages.push_back(count);
+            for ( std::size_t i = 0; i < count; ++i ) {
+                task(i);
+            }
+        };
+
+        r.process_systems_in_range(0, 100, executor);
+        REQUIRE(stages == vector<std::size_t>{2u});
+        REQUIRE(log == vector<str>{"move", "damage", "draw", "exclusive", "ui"});
+
+        log.clear();
+        r.process_systems_in_range(20, 40, executor);
+        REQUIRE(stages == vector<std::size_t>{2u, 2u});
+        REQUIRE(log == vector<str>{"damage", "draw", "exclusive"});
+
+        log.clear();
+        r.process_systems_in_range(0, 100);
+        REQUIRE(log == vector<str>{"move", "damage", "draw", "exclusive", "ui"});
+
+        REQUIRE(ecs::system_access().exclusive());
+        REQUIRE(ecs::system_access().conflicts_with(ecs::system_access().reads<position>()));
+        REQUIRE_FALSE(ecs::system_access().reads<position>()
+            .conflicts_with(ecs::system_access().reads<position>()));
+        REQUIRE(ecs::system_access().reads<position>()
+            .conflicts_with(ecs::system_access().writes<position>()));
+        REQUIRE_FALSE(ecs::system_access().writes<velocity>()
+            .conflicts_with(ecs::system_access().writes<position>()));
+    }
+    SECTION("system_profiling") {
+        ecs::registry r;
+        ecs::registry_filler(r)
+            .system<move_system>(10);
+        for ( std::size_t i = 0; i < 3; ++i ) {
+            ecs::entity e = r.create_entity();
+            e.assign_component<position>();
+            e.assign_component<velocity>(velocity{1.f});
+        }
+        r.create_entity().assign_component<position>();
+
+        r.process_all_systems();
+        REQUIRE(r.system_profiles().size() == 1u);
+        REQUIRE(r.system_profiles()[0].invocations == 0u);
+
+        r.enable_system_profiling(true);
+        REQUIRE(r.system_profiling());
+        r.process_all_systems();
+        r.process_systems_in_range(0, 100);
+        {
+            const vector<ecs::system_profile> profiles = r.system_profiles();
+            REQUIRE(profiles.size() == 1u);
+            REQUIRE(profiles[0].priority == 10);
+            REQUIRE(profiles[0].invocations == 2u);
+            REQUIRE(profiles[0].entities == 4u);
+            REQUIRE(profiles[0].min_ms >= 0.0);
+            REQUIRE(profiles[0].min_ms <= profiles[0].avg_ms);
+            REQUIRE(profiles[0].avg_ms <= profiles[0].max_ms);
+            REQUIRE(str(profiles[0].name).find("move_system") != str::npos);
+        }
+
+        r.reset_system_profiles();
+        REQUIRE(r.system_profiles()[0].invocations == 0u);
+        REQUIRE(r.system_profiles()[0].max_ms == 0.0);
+    }
 }
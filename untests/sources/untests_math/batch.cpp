@@ -0,0 +1,112 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include "_math.hpp"
+using namespace e2d;
+
+TEST_CASE("batch") {
+    {
+        const m4f m =
+            math::make_scale_matrix4(2.f, 3.f, 4.f) *
+            math::make_translation_matrix4(10.f, 20.f, 30.f);
+
+        const v3f points3[] = {{0.f,0.f,0.f}, {1.f,1.f,1.f}, {-1.f,2.f,-3.f}};
+        v3f result3[std::size(points3)];
+        math::transform_points(points3, std::size(points3), m, result3);
+        for ( std::size_t i = 0; i < std::size(points3); ++i ) {
+            REQUIRE(result3[i] == v3f(v4f(points3[i], 1.f) * m));
+        }
+
+        const v2f points2[] = {{0.f,0.f}, {1.f,1.f}, {-1.f,2.f}};
+        v3f result23[std::size(points2)];
+        v2f result22[std::size(points2)];
+        math::transform_points(points2, std::size(points2), m, result23);
+        math::transform_points(points2, std::size(points2), m, result22);
+        for ( std::size_t i = 0; i < std::size(points2); ++i ) {
+            const v4f e = v4f(points2[i].x, points2[i].y, 0.f, 1.f) * m;
+            REQUIRE(result23[i] == v3f(e));
+            REQUIRE(result22[i] == v2f(e));
+        }
+
+        v3f inplace[] = {{1.f,1.f,1.f}};
+        math::transform_points(inplace, std::size(inplace), m, inplace);
+        REQUIRE(inplace[0] == v3f(12.f, 23.f, 34.f));
+
+        const v3i points_i[] = {{1,2,3}};
+        v3i result_i[1];
+        math::transform_points(points_i, 1, math::make_translation_matrix4(1, 1, 1), result_i);
+        REQUIRE(result_i[0] == v3i(2,3,4));
+    }
+    {
+        REQUIRE(math::make_minmax_aabb(static_cast<const v3f*>(nullptr), 0u) == b3f::zero());
+        REQUIRE(math::make_minmax_rect(static_cast<const v2f*>(nullptr), 0u) == b2f::zero());
+
+        const v3f points3[] = {{1.f,2.f,3.f}, {-1.f,5.f,0.f}, {4.f,-2.f,1.f}};
+        REQUIRE(math::make_minmax_aabb(points3, std::size(points3))
+            == b3f(-1.f,-2.f,0.f,5.f,7.f,3.f));
+
+        const v2f points2[] = {{1.f,2.f}, {-1.f,5.f}, {4.f,-2.f}};
+        REQUIRE(math::make_minmax_rect(points2, std::size(points2))
+            == b2f(-1.f,-2.f,5.f,7.f));
+    }
+    {
+        REQUIRE(math::transformed(b3f(1.f,2.f,3.f), m4f::identity()) == b3f(1.f,2.f,3.f));
+        REQUIRE(math::transformed(
+            b3f(1.f,2.f,3.f),
+            math::make_translation_matrix4(1.f,1.f,1.f)) == b3f(1.f,1.f,1.f,1.f,2.f,3.f));
+        REQUIRE(math::transformed(
+            b3f(1.f,2.f,3.f),
+            math::make_scale_matrix4(-1.f,1.f,1.f)) == b3f(-1.f,0.f,0.f,1.f,2.f,3.f));
+        REQUIRE(math::approximately(
+            math::transformed(b3f(-1.f,-1.f,-1.f,2.f,2.f,2.f), math::make_rotation_matrix4(make_deg(45.f), 0.f,0.f,1.f)),
+            b3f(-math::sqrt(2.f),-math::sqrt(2.f),-1.f,2.f * math::sqrt(2.f),2.f * math::sqrt(2.f),2.f)));
+    }
+    {
+        REQUIRE(math::merged(static_cast<const b2f*>(nullptr), 0u) == b2f::zero());
+        REQUIRE(math::merged(static_cast<const b3f*>(nullptr), 0u) == b3f::zero());
+
+        const b2f rects[] = {{0.f,0.f,1.f,1.f}, {2.f,-1.f,1.f,1.f}, {-3.f,0.f,1.f,5.f}};
+        REQUIRE(math::merged(rects, std::size(rects)) == b2f(-3.f,-1.f,6.f,6.f));
+
+        const b3f boxes[] = {{0.f,0.f,0.f,1.f,1.f,1.f}, {2.f,-1.f,3.f,1.f,1.f,1.f}};
+        REQUIRE(math::merged(boxes, std::size(boxes)) == b3f(0.f,-1.f,0.f,3.f,2.f,4.f));
+    }
+    {
+        const b2f rects[] = {{0.f,0.f,1.f,1.f}, {2.f,-1.f,1.f,1.f}, {-3.f,0.f,1.f,5.f}};
+        u8 result[std::size(rects)];
+        REQUIRE(math::overlaps(rects, std::size(rects), b2f(-2.5f,0.5f,3.f,1.f), result) == 2u);
+        REQUIRE(result[0] == 1u);
+        REQUIRE(result[1] == 0u);
+        REQUIRE(result[2] == 1u);
+        for ( std::size_t i = 0; i < std::size(rects); ++i ) {
+            REQUIRE(!!result[i] == math::overlaps(rects[i], b2f(-2.5f,0.5f,3.f,1.f)));
+        }
+
+        const b3f boxes[] = {{0.f,0.f,0.f,1.f,1.f,1.f}, {2.f,-1.f,3.f,1.f,1.f,1.f}};
+        u8 result3[std::size(boxes)];
+        REQUIRE(math::overlaps(boxes, std::size(boxes), b3f(0.5f,0.5f,0.5f,1.f,1.f,1.f), result3) == 1u);
+        REQUIRE(result3[0] == 1u);
+        REQUIRE(result3[1] == 0u);
+    }
+    {
+        const m4f vp = math::make_orthogonal_lh_matrix4(10.f, 10.f, 0.f, 10.f);
+        REQUIRE(math::overlaps_frustum(b3f(-1.f,-1.f,1.f,2.f,2.f,2.f), vp));
+        REQUIRE(math::overlaps_frustum(b3f(4.f,4.f,1.f,2.f,2.f,2.f), vp));
+        REQUIRE_FALSE(math::overlaps_frustum(b3f(6.f,0.f,1.f,2.f,2.f,2.f), vp));
+        REQUIRE_FALSE(math::overlaps_frustum(b3f(0.f,-9.f,1.f,2.f,2.f,2.f), vp));
+        REQUIRE_FALSE(math::overlaps_frustum(b3f(0.f,0.f,11.f,2.f,2.f,2.f), vp));
+
+        const b3f boxes[] = {
+            {-1.f,-1.f,1.f,2.f,2.f,2.f},
+            {6.f,0.f,1.f,2.f,2.f,2.f},
+            {4.f,4.f,1.f,2.f,2.f,2.f}};
+        u8 result[std::size(boxes)];
+        REQUIRE(math::overlaps_frustum(boxes, std::size(boxes), vp, result) == 2u);
+        REQUIRE(result[0] == 1u);
+        REQUIRE(result[1] == 0u);
+        REQUIRE(result[2] == 1u);
+    }
+}
@@ -112,4 +112,26 @@ TEST_CASE("trs3") {
         REQUIRE(math::contains_nan(math::make_scale_trs3(v3f{1.f, inf, 0.f})));
         REQUIRE_FALSE(math::contains_nan(math::make_scale_trs3(v3f{1.f, 0.f, 0.f})));
     }
+    {
+        const t3f l = math::make_translation_trs3(v3f(0.f,2.f,4.f));
+        const t3f r = make_trs3(
+            v3f(2.f,4.f,8.f),
+            math::make_quat_from_axis_angle(make_deg(90.f), v3f::unit_z()),
+            v3f(3.f,3.f,3.f));
+        REQUIRE(math::approximately(math::lerp(l, r, 0.f), l));
+        REQUIRE(math::approximately(math::lerp(l, r, 1.f), r));
+
+        const t3f m = math::lerp(l, r, 0.5f);
+        REQUIRE(math::approximately(m.translation, v3f(1.f,3.f,6.f)));
+        REQUIRE(math::approximately(m.scale, v3f(2.f,2.f,2.f)));
+        REQUIRE(math::approximately(math::length(m.rotation), 1.f));
+        REQUIRE(math::approximately(
+            m.rotation,
+            math::make_quat_from_axis_angle(make_deg(45.f), v3f::unit_z())));
+
+        const t3f n = math::make_rotation_trs3(r.rotation * -1.f);
+        REQUIRE(math::approximately(
+            math::lerp(l, n, 0.5f).rotation,
+            math::make_quat_from_axis_angle(make_deg(45.f), v3f::unit_z())));
+    }
 }
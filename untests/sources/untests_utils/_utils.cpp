@@ -59,6 +59,23 @@ TEST_CASE("utils") {
             42u, str1, str1 + std::strlen(str1)
         ) == utils::sdbm_hash(42u, str3));
     }
+    {
+        str_view empty_view;
+        REQUIRE(utils::fnv1a_hash(empty_view.cbegin(), empty_view.cend()) == 14695981039346656037ull);
+        REQUIRE(utils::fnv1a_hash(1u, empty_view.cbegin(), empty_view.cend()) == 1u);
+
+        const str_view str1{"hello"};
+        const u8 bytes1[] = {'h', 'e', 'l', 'l', 'o'};
+        REQUIRE(utils::fnv1a_hash(str1.cbegin(), str1.cend()) == 0xa430d84680aabd0bull);
+        REQUIRE(utils::fnv1a_hash(
+            str1.cbegin(), str1.cend()
+        ) == utils::fnv1a_hash(std::begin(bytes1), std::end(bytes1)));
+
+        const str_view str2{"hellp"};
+        REQUIRE(utils::fnv1a_hash(
+            str1.cbegin(), str1.cend()
+        ) != utils::fnv1a_hash(str2.cbegin(), str2.cend()));
+    }
     {
         utils::type_family_id id1 = utils::type_family<str16>::id();
         utils::type_family_id id2 = utils::type_family<str32>::id();
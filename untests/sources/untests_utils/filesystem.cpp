@@ -78,6 +78,12 @@ TEST_CASE("filesystem") {
 
             buffer data("hello", 5);
             REQUIRE(filesystem::try_write_all(data, child_dir_name, false));
+            {
+                microseconds<u64> write_time;
+                REQUIRE(filesystem::try_get_write_time(write_time, child_dir_name));
+                REQUIRE(write_time.value > 0u);
+                REQUIRE_FALSE(filesystem::try_get_write_time(write_time, "test_filesystem_none_file"));
+            }
             {
                 buffer d1;
                 REQUIRE(filesystem::try_read_all(d1, child_dir_name));
@@ -129,4 +129,32 @@ TEST_CASE("images") {
         REQUIRE(math::approximately(img.pixel32(1,0), color32::green(), 0));
         REQUIRE(math::approximately(img.pixel32(2,0), color32::blue(),  0));
     }
+    {
+        const u8 img_data[] = {
+            255,0,0,255, 0,255,0,128,
+            0,0,255,64, 10,20,30,40};
+        const image src(v2u(2,2), image_data_format::rgba8, {img_data, sizeof(img_data)});
+
+        buffer buf;
+        REQUIRE(images::try_save_image(src, image_file_format::dds, buf));
+
+        image img;
+        REQUIRE(images::try_load_image(img, buf));
+        REQUIRE(img == src);
+
+        const u8 rgb_data[] = {1,2,3, 4,5,6, 7,8,9};
+        const image src_rgb(v2u(3,1), image_data_format::rgb8, {rgb_data, sizeof(rgb_data)});
+        REQUIRE(images::try_save_image(src_rgb, image_file_format::dds, buf));
+        REQUIRE(images::try_load_image(img, buf));
+        REQUIRE(img == src_rgb);
+
+        const u8 dxt_data[16] = {0};
+        const image src_dxt(v2u(4,4), image_data_format::rgba_dxt5, {dxt_data, sizeof(dxt_data)});
+        REQUIRE(images::try_save_image(src_dxt, image_file_format::dds, buf));
+        REQUIRE(images::try_load_image(img, buf));
+        REQUIRE(img == src_dxt);
+
+        buf.resize(buf.size() - 1u);
+        REQUIRE_FALSE(images::try_load_image(img, buf));
+    }
 }
@@ -433,4 +433,53 @@ TEST_CASE("json_utils") {
         REQUIRE(v5 == v5_);
         REQUIRE(v6 == v6_);
     }
+    {
+        buffer cooked;
+        REQUIRE(json_utils::try_save_cooked_json(cooked, doc));
+
+        rapidjson::Document cooked_doc;
+        REQUIRE(json_utils::try_load_cooked_json(cooked_doc, cooked));
+        REQUIRE(cooked_doc == doc);
+
+        int i;
+        REQUIRE(json_utils::try_parse_value(cooked_doc["i"], i));
+        REQUIRE(i == 42);
+
+        float ff;
+        REQUIRE(json_utils::try_parse_value(cooked_doc["f0"], ff));
+        REQUIRE(math::approximately(ff, 1.2f));
+
+        buffer truncated(cooked.data(), cooked.size() - 1);
+        REQUIRE_FALSE(json_utils::try_load_cooked_json(cooked_doc, truncated));
+        REQUIRE(cooked_doc == doc);
+
+        buffer wrong_signature = cooked;
+        wrong_signature.data()[0] = 'x';
+        REQUIRE_FALSE(json_utils::try_load_cooked_json(cooked_doc, wrong_signature));
+
+        u32 schema = 42u;
+        REQUIRE(json_utils::try_load_cooked_json(cooked_doc, schema, cooked));
+        REQUIRE(schema == 0u);
+        REQUIRE(json_utils::try_save_cooked_json(cooked, doc, 0xDEADBEEFu));
+        REQUIRE(json_utils::try_load_cooked_json(cooked_doc, schema, cooked));
+        REQUIRE(schema == 0xDEADBEEFu);
+        REQUIRE(cooked_doc == doc);
+    }
+    {
+        rapidjson::Document empty_array;
+        empty_array.SetArray();
+
+        buffer cooked;
+        REQUIRE(json_utils::try_save_cooked_json(cooked, empty_array));
+
+        rapidjson::Document cooked_doc;
+        REQUIRE(json_utils::try_load_cooked_json(cooked_doc, cooked));
+        REQUIRE(cooked_doc == empty_array);
+
+        // the item count past the values left is rejected before any reserve
+        const u32 damaged_size = 0xFFFFFFFFu;
+        REQUIRE(cooked.size() == 24u + 16u);
+        std::memcpy(cooked.data() + 24u + 4u, &damaged_size, sizeof(damaged_size));
+        REQUIRE_FALSE(json_utils::try_load_cooked_json(cooked_doc, cooked));
+    }
 }
@@ -349,4 +349,41 @@ TEST_CASE("path") {
             REQUIRE(path::parent_path(path) == result);
         }
     }
+    {
+        // [path, result]
+        using t = std::tuple<str, str>;
+        const vector<t> combinations = {
+            t{"", ""},
+            t{".", ""},
+            t{"./", ""},
+            t{"..", ".."},
+            t{"../..", "../.."},
+
+            t{"usr", "usr"},
+            t{"usr/", "usr"},
+            t{"usr//local", "usr/local"},
+            t{"usr/./local", "usr/local"},
+            t{"usr/../local", "local"},
+            t{"usr/local/..", "usr"},
+            t{"usr/..", ""},
+            t{"usr/../..", ".."},
+            t{"../usr/../local", "../local"},
+            t{"sprites/../textures/ship.png", "textures/ship.png"},
+            t{"windows\\system32\\..", "windows"},
+
+            t{"/", "/"},
+            t{"/..", "/"},
+            t{"/usr/../local", "/local"},
+            t{"//usr/./local/", "/usr/local"},
+
+            t{"C:", "C:"},
+            t{"C:\\", "C:/"},
+            t{"C:\\windows\\..\\..", "C:/"},
+        };
+        for ( const auto& combination : combinations ) {
+            str path, result;
+            std::tie(path, result) = combination;
+            REQUIRE(path::normalize(path) == result);
+        }
+    }
 }
@@ -0,0 +1,133 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include "_utils.hpp"
+using namespace e2d;
+
+namespace
+{
+    class obj_t : public ref_counter<obj_t> {
+    public:
+        obj_t(int ni) : i(ni) {}
+
+        static void* operator new(std::size_t size) {
+            return slab_allocator::current().allocate(size);
+        }
+
+        static void operator delete(void* ptr) noexcept {
+            slab_allocator::deallocate(ptr);
+        }
+    public:
+        int i{0};
+        u8 padding[100]{};
+    };
+}
+
+TEST_CASE("slab_allocator") {
+    {
+        auto a = make_intrusive<slab_allocator>();
+        REQUIRE(a->stats().allocations == 0u);
+        REQUIRE(a->stats().slab_count == 0u);
+
+        void* p1 = a->allocate(24);
+        void* p2 = a->allocate(24);
+        REQUIRE(p1);
+        REQUIRE(p2);
+        REQUIRE(p1 != p2);
+        REQUIRE(reinterpret_cast<std::uintptr_t>(p1) % alignof(std::max_align_t) == 0u);
+        REQUIRE(reinterpret_cast<std::uintptr_t>(p2) % alignof(std::max_align_t) == 0u);
+        REQUIRE(a->stats().allocations == 2u);
+        REQUIRE(a->stats().live_blocks == 2u);
+        REQUIRE(a->stats().slab_count == 1u);
+
+        slab_allocator::deallocate(p2);
+        REQUIRE(a->stats().deallocations == 1u);
+        REQUIRE(a->stats().live_blocks == 1u);
+
+        void* p3 = a->allocate(20);
+        REQUIRE(p3 == p2);
+        REQUIRE(a->stats().slab_count == 1u);
+
+        slab_allocator::deallocate(p1);
+        slab_allocator::deallocate(p3);
+        REQUIRE(a->stats().live_blocks == 0u);
+    }
+    {
+        auto a = make_intrusive<slab_allocator>();
+        void* p = a->allocate(slab_allocator::max_block_size + 1u);
+        REQUIRE(p);
+        REQUIRE(a->stats().heap_fallbacks == 1u);
+        REQUIRE(a->stats().slab_count == 0u);
+        slab_allocator::deallocate(p);
+        REQUIRE(a->stats().live_blocks == 0u);
+        slab_allocator::deallocate(nullptr);
+    }
+    {
+        auto a = make_intrusive<slab_allocator>();
+        REQUIRE(a->use_count() == 1u);
+        void* p = a->allocate(8);
+        REQUIRE(a->use_count() == 2u);
+        slab_allocator::deallocate(p);
+        REQUIRE(a->use_count() == 1u);
+    }
+    {
+        auto a = make_intrusive<slab_allocator>();
+        intrusive_ptr<obj_t> o;
+        {
+            slab_allocator::scope scope(*a);
+            REQUIRE(&slab_allocator::current() == a.get());
+            o = make_intrusive<obj_t>(42);
+        }
+        REQUIRE(&slab_allocator::current() == &slab_allocator::shared());
+        REQUIRE(o->i == 42);
+        REQUIRE(a->stats().live_blocks == 1u);
+
+        // live blocks keep the allocator alive
+        a.reset();
+        REQUIRE(o->i == 42);
+        o.reset();
+    }
+    {
+        auto a = make_intrusive<slab_allocator>();
+        vector<intrusive_ptr<obj_t>> objs;
+        {
+            slab_allocator::scope scope(*a);
+            for ( int i = 0; i < 1000; ++i ) {
+                objs.push_back(make_intrusive<obj_t>(i));
+            }
+        }
+        for ( int i = 0; i < 1000; ++i ) {
+            REQUIRE(objs[i]->i == i);
+        }
+        REQUIRE(a->stats().live_blocks == 1000u);
+        REQUIRE(a->stats().slab_count < 10u);
+        objs.clear();
+        REQUIRE(a->stats().live_blocks == 0u);
+        REQUIRE(a->stats().deallocations == 1000u);
+    }
+    {
+        auto a = make_intrusive<slab_allocator>();
+        vector<std::thread> threads;
+        for ( std::size_t t = 0; t < 4u; ++t ) {
+            threads.emplace_back([&a, t](){
+                vector<void*> blocks;
+                for ( std::size_t i = 0; i < 1000u; ++i ) {
+                    blocks.push_back(a->allocate(16u + (i + t) % 64u));
+                }
+                for ( void* block : blocks ) {
+                    slab_allocator::deallocate(block);
+                }
+            });
+        }
+        for ( std::thread& thread : threads ) {
+            thread.join();
+        }
+        REQUIRE(a->stats().allocations == 4000u);
+        REQUIRE(a->stats().deallocations == 4000u);
+        REQUIRE(a->stats().live_blocks == 0u);
+        REQUIRE(a->use_count() == 1u);
+    }
+}